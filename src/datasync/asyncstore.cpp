@@ -0,0 +1,130 @@
+#include "asyncstore_p.h"
+#include "datastore_p.h"
+
+#include <QtCore/QScopedPointer>
+using namespace QtDataSync;
+
+const int AsyncStore::MaxThreads = 4;
+
+AsyncStore::AsyncStore(QString setupName, int threadCount) :
+	_setupName{std::move(setupName)},
+	_stopped{false}
+{
+	if(threadCount <= 0)
+		threadCount = qBound(1, QThread::idealThreadCount(), MaxThreads);
+	for(auto i = 0; i < threadCount; i++) {
+		auto worker = new Worker{this};
+		worker->setObjectName(QStringLiteral("qtdatasync_io_%1_%2").arg(_setupName).arg(i));
+		worker->start();
+		_workers.append(worker);
+	}
+}
+
+AsyncStore::~AsyncStore()
+{
+	stop();
+}
+
+int AsyncStore::threadCount() const
+{
+	return _workers.size();
+}
+
+void AsyncStore::enqueue(const QByteArray &typeName, bool exclusive, const Task &task)
+{
+	QMutexLocker locker(&_lock);
+	if(_stopped) {
+		locker.unlock();
+		task(nullptr);
+		return;
+	}
+
+	auto &jobs = _lanes[typeName];
+	jobs.append(JobRef::create(Job{task, exclusive, false}));
+	scheduleLane(typeName);
+}
+
+void AsyncStore::stop()
+{
+	{
+		QMutexLocker _(&_lock);
+		if(_stopped)
+			return;
+		_stopped = true;
+		_condition.wakeAll();
+	}
+
+	for(auto worker : qAsConst(_workers)) {
+		worker->wait();
+		delete worker;
+	}
+	_workers.clear();
+}
+
+void AsyncStore::work()
+{
+	//every thread needs it's own store, as database connections are per thread
+	QScopedPointer<DataStore> store;
+	try {
+		store.reset(new DataStore{_setupName});
+		//there is no event loop to deliver change signals to
+		store->d->store->unsubscribeAll();
+	} catch(QException &) {
+		store.reset();
+	}
+
+	QMutexLocker locker(&_lock);
+	forever {
+		while(_ready.isEmpty() && !(_stopped && _lanes.isEmpty()))
+			_condition.wait(&_lock);
+		if(_ready.isEmpty())
+			break;
+
+		auto next = _ready.dequeue();
+		locker.unlock();
+		next.second->task(store.data());
+		locker.relock();
+
+		auto &jobs = _lanes[next.first];
+		jobs.removeOne(next.second);
+		if(jobs.isEmpty())
+			_lanes.remove(next.first);
+		else
+			scheduleLane(next.first);
+		//wake all, as the waiting ones might have to exit now
+		if(_stopped)
+			_condition.wakeAll();
+	}
+}
+
+void AsyncStore::scheduleLane(const QByteArray &typeName)
+{
+	const auto &jobs = _lanes[typeName];
+	for(auto i = 0; i < jobs.size(); i++) {
+		const auto &job = jobs[i];
+		if(job->exclusive) {
+			//writes wait for everything before them, and everything after them waits for the write
+			if(i == 0 && !job->started) {
+				job->started = true;
+				_ready.enqueue({typeName, job});
+				_condition.wakeOne();
+			}
+			break;
+		} else if(!job->started) {
+			job->started = true;
+			_ready.enqueue({typeName, job});
+			_condition.wakeOne();
+		}
+	}
+}
+
+
+
+AsyncStore::Worker::Worker(AsyncStore *owner) :
+	_owner{owner}
+{}
+
+void AsyncStore::Worker::run()
+{
+	_owner->work();
+}
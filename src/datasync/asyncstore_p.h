@@ -0,0 +1,75 @@
+#ifndef QTDATASYNC_ASYNCSTORE_P_H
+#define QTDATASYNC_ASYNCSTORE_P_H
+
+#include <functional>
+
+#include <QtCore/QHash>
+#include <QtCore/QList>
+#include <QtCore/QMutex>
+#include <QtCore/QQueue>
+#include <QtCore/QSharedPointer>
+#include <QtCore/QThread>
+#include <QtCore/QWaitCondition>
+
+#include "qtdatasync_global.h"
+#include "datastore.h"
+
+namespace QtDataSync {
+
+//! The I/O threads of a setup that run the asynchronous DataStore operations
+class Q_DATASYNC_EXPORT AsyncStore
+{
+	Q_DISABLE_COPY(AsyncStore)
+
+public:
+	//the task gets nullptr if the store of the thread could not be created or the store was stopped
+	using Task = std::function<void(DataStore*)>;
+
+	static const int MaxThreads;
+
+	explicit AsyncStore(QString setupName, int threadCount = 0);
+	~AsyncStore();
+
+	int threadCount() const;
+
+	// tasks of one type run in the order they were enqueued, reading tasks in parallel to each other
+	void enqueue(const QByteArray &typeName, bool exclusive, const Task &task);
+	//finishes all enqueued tasks and stops the threads - tasks enqueued afterwards run synchronously with nullptr
+	void stop();
+
+private:
+	class Worker : public QThread
+	{
+	public:
+		Worker(AsyncStore *owner);
+
+	protected:
+		void run() override;
+
+	private:
+		AsyncStore *_owner;
+	};
+
+	struct Job {
+		Task task;
+		bool exclusive;
+		bool started;
+	};
+	using JobRef = QSharedPointer<Job>;
+
+	const QString _setupName;
+	QList<Worker*> _workers;
+
+	QMutex _lock;
+	QWaitCondition _condition;
+	bool _stopped;
+	QHash<QByteArray, QList<JobRef>> _lanes;
+	QQueue<QPair<QByteArray, JobRef>> _ready;
+
+	void work();
+	void scheduleLane(const QByteArray &typeName);
+};
+
+}
+
+#endif // QTDATASYNC_ASYNCSTORE_P_H
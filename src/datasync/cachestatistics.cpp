@@ -0,0 +1,11 @@
+#include "cachestatistics.h"
+using namespace QtDataSync;
+
+double CacheStatistics::hitRatio() const
+{
+	const auto total = hits + misses;
+	if(total == 0)
+		return 0.0;
+	else
+		return static_cast<double>(hits) / static_cast<double>(total);
+}
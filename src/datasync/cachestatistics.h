@@ -0,0 +1,47 @@
+#ifndef QTDATASYNC_CACHESTATISTICS_H
+#define QTDATASYNC_CACHESTATISTICS_H
+
+#include <QtCore/qhash.h>
+#include <QtCore/qmetatype.h>
+
+#include "QtDataSync/qtdatasync_global.h"
+
+namespace QtDataSync {
+
+//! A snapshot of the state of the data cache of a setup
+struct Q_DATASYNC_EXPORT CacheStatistics
+{
+	//! The part of the cache used by datasets of a single type
+	struct Q_DATASYNC_EXPORT TypeStatistics
+	{
+		//! The number of cached datasets of the type
+		int entries = 0;
+		//! The estimated size in bytes of the cached datasets of the type
+		qint64 bytes = 0;
+	};
+
+	//! The number of loads that could be served from the cache
+	quint64 hits = 0;
+	//! The number of loads that had to read from the local store
+	quint64 misses = 0;
+	//! The number of datasets that were dropped to make room for others
+	quint64 evictions = 0;
+	//! The number of cached datasets
+	int entries = 0;
+	//! The estimated size in bytes of all cached datasets
+	qint64 bytes = 0;
+	//! The size in bytes the cache may currently use
+	qint64 maxBytes = 0;
+	//! The entries and bytes used by each type
+	QHash<QByteArray, TypeStatistics> types;
+
+	//! Returns the fraction of loads that were served from the cache
+	double hitRatio() const;
+};
+
+}
+
+Q_DECLARE_METATYPE(QtDataSync::CacheStatistics)
+Q_DECLARE_TYPEINFO(QtDataSync::CacheStatistics::TypeStatistics, Q_PRIMITIVE_TYPE);
+
+#endif // QTDATASYNC_CACHESTATISTICS_H
@@ -5,13 +5,27 @@
 #include "synchelper_p.h"
 #include "changeemitter_p.h"
 
+#include <QtCore/QtEndian>
+
 using namespace QtDataSync;
 
 #define QTDATASYNC_LOG QTDATASYNC_LOG_CONTROLLER
 
+const int ChangeController::InitialUploadWindow = 10;
+const int ChangeController::MinUploadWindow = 1;
+const qint64 ChangeController::RttTolerance = 50;
+
 ChangeController::ChangeController(const Defaults &defaults, QObject *parent) :
 	Controller{"change", defaults, parent}
-{}
+{
+	_uploadClock.start();
+	//an upload that was never acked means the window was too large
+	connect(this, &ChangeController::operationTimeout,
+			this, [this]() {
+		if(!_activeUploads.isEmpty())
+			shrinkUploadWindow(false);
+	});
+}
 
 void ChangeController::initialize(const QVariantHash &params)
 {
@@ -22,14 +36,32 @@ void ChangeController::initialize(const QVariantHash &params)
 
 	connect(_emitter, &ChangeEmitter::uploadNeeded,
 			this, &ChangeController::changeTriggered);
+	updatePendingChanges();
+}
+
+int ChangeController::uploadWindow() const
+{
+	return qMin(qMax(MinUploadWindow, static_cast<int>(_uploadWindow)), _uploadLimit);
+}
+
+int ChangeController::uploadRtt() const
+{
+	return static_cast<int>(_rtt);
+}
+
+int ChangeController::pendingChanges() const
+{
+	return _pendingChanges;
 }
 
 void ChangeController::setUploadingEnabled(bool uploading)
 {
 	_uploadingEnabled = uploading;
 	logDebug() << "Change uploading enabled to" << uploading;
-	if(uploading)
+	if(uploading) {
+		_rescanChanges = true; //in case the last pass is already done
 		uploadNext(true);
+	}
 	else {
 		endOp(); //stop timeouts
 		emit uploadingChanged(false);
@@ -42,32 +74,47 @@ void ChangeController::clearUploads()
 	if(!_activeUploads.isEmpty())
 		logDebug() << "Finished uploading changes";
 	_activeUploads.clear();
+	_changeCursor = {};
+	_rescanChanges = false;
 	_changeEstimate = 0;
 }
 
 void ChangeController::updateUploadLimit(quint32 limit)
 {
 	logDebug() << "Updated update limit to:" << limit;
+	const auto oldRtt = uploadRtt();
 	_uploadLimit = static_cast<int>(limit);
+	//new connection -> start over, the latency has to be measured again
+	_rtt = -1;
+	_minRtt = -1;
+	_lastShrink = -1;
+	_slowStart = true;
+	setUploadWindow(InitialUploadWindow); //also clamps it to the new limit
+	if(uploadRtt() != oldRtt)
+		emit uploadRttChanged(uploadRtt());
 }
 
 void ChangeController::uploadDone(const QByteArray &key)
 {
-	if(!_activeUploads.contains(key)) {
+	auto it = _activeUploads.find(uploadKey(key, {}));
+	if(it == _activeUploads.end() || it->keyHash != key || !it->deviceId.isNull()) {
 		logWarning() << "Unknown key completed:" << key.toHex();
 		return;
 	}
 
 	try {
-		auto info = _activeUploads.take(key);
+		auto info = *it;
+		_activeUploads.erase(it);
+		updateUploadWindow(info.started);
 		_store->markUnchanged(info.key, info.version, info.isDelete);
+		updatePendingChanges(); //uploadNext is skipped while the window is full
 		_changeEstimate--;
 		emit progressIncrement();
 		logDebug() << "Completed upload. Marked"
 				   << info.key << "as unchanged ( Active uploads:"
 				   << _activeUploads.size() << ")";
 
-		if(_uploadingEnabled && _activeUploads.size() < _uploadLimit) //queued, so we may have the luck to complete a few more before uploading again
+		if(_uploadingEnabled && _activeUploads.size() < uploadWindow()) //queued, so we may have the luck to complete a few more before uploading again
 			QMetaObject::invokeMethod(this, "uploadNext", Qt::QueuedConnection,
 									  Q_ARG(bool, false));
 	} catch(Exception &e) {
@@ -78,21 +125,25 @@ void ChangeController::uploadDone(const QByteArray &key)
 
 void ChangeController::deviceUploadDone(const QByteArray &key, QUuid deviceId)
 {
-	if(!_activeUploads.contains({key, deviceId})) {
+	auto it = _activeUploads.find(uploadKey(key, deviceId));
+	if(it == _activeUploads.end() || it->keyHash != key || it->deviceId != deviceId) {
 		logWarning() << "Unknown device key completed:" << key.toHex() << deviceId;
 		return;
 	}
 
 	try {
-		auto info = _activeUploads.take({key, deviceId});
+		auto info = *it;
+		_activeUploads.erase(it);
+		updateUploadWindow(info.started);
 		_store->removeDeviceChange(info.key, deviceId);
+		updatePendingChanges(); //uploadNext is skipped while the window is full
 		_changeEstimate--;
 		emit progressIncrement();
 		logDebug() << "Completed device upload. Marked"
 				   << info.key << "for device" << deviceId << "as unchanged ( Active uploads:"
 				   << _activeUploads.size() << ")";
 
-		if(_uploadingEnabled && _activeUploads.size() < _uploadLimit) //queued, so we may have the luck to complete a few more before uploading again
+		if(_uploadingEnabled && _activeUploads.size() < uploadWindow()) //queued, so we may have the luck to complete a few more before uploading again
 			QMetaObject::invokeMethod(this, "uploadNext", Qt::QueuedConnection,
 									  Q_ARG(bool, false));
 	} catch(Exception &e) {
@@ -101,10 +152,22 @@ void ChangeController::deviceUploadDone(const QByteArray &key, QUuid deviceId)
 	}
 }
 
+void ChangeController::uploadsRejected(bool quotaHit)
+{
+	if(_activeUploads.isEmpty())
+		return;
+	//the remote could not take the uploads -> back off, completely if it is out of space
+	shrinkUploadWindow(quotaHit);
+}
+
 void ChangeController::changeTriggered()
 {
+	//the change might be behind the cursor -> walk the changes again once the current pass is done
+	_rescanChanges = true;
 	if(_uploadingEnabled)
 		uploadNext(_activeUploads.isEmpty());
+	else
+		updatePendingChanges();
 }
 
 void ChangeController::uploadNext(bool emitStarted)
@@ -116,7 +179,8 @@ void ChangeController::uploadNext(bool emitStarted)
 		emit uploadingChanged(true);
 	}
 
-	if(_activeUploads.size() >= _uploadLimit)
+	updatePendingChanges();
+	if(_activeUploads.size() >= uploadWindow())
 		return;
 
 	try {
@@ -132,21 +196,19 @@ void ChangeController::uploadNext(bool emitStarted)
 			}
 		}
 
-		_store->loadChanges(_uploadLimit, [this, emitProgress, &emitStarted](const ObjectKey &objKey, quint64 version, const QString &file, QUuid deviceId) {
-			CachedObjectKey key(objKey, deviceId);
+		const auto visitor = [this, emitProgress, &emitStarted](const ObjectKey &key, quint64 version, const QString &file, QUuid deviceId) {
+			auto keyHash = key.hashed();
+			auto uKey = uploadKey(keyHash, deviceId);
 
 			//skip stuff already beeing uploaded (could still have changed, but to prevent errors)
-//			auto skip = false;
-			if(_activeUploads.contains(key))
+			auto active = _activeUploads.constFind(uKey);
+			if(active != _activeUploads.constEnd()) {
+				if(active->keyHash != keyHash || active->deviceId != deviceId) {
+					logDebug() << "Upload key collision for" << key << "- deferring it to the next pass";
+					_rescanChanges = true;
+				}
 				return true;
-//			for(const auto &mKey : _activeUploads.keys()) {
-//				if(key == mKey) {
-//					skip = true;
-//					break;
-//				}
-//			}
-//			if(skip)
-//				return true;
+			}
 
 			//signale that uploading has started
 			if(emitStarted) {
@@ -157,9 +219,8 @@ void ChangeController::uploadNext(bool emitStarted)
 					emit progressAdded(_changeEstimate);
 			}
 
-			auto keyHash = key.hashed();
 			auto isDelete = file.isNull();
-			_activeUploads.insert(key, {key, version, isDelete});
+			_activeUploads.insert(uKey, {key, version, isDelete, _uploadClock.elapsed(), keyHash, deviceId});
 			beginOp(); //start the default timeout
 			if(isDelete) {//deleted
 				if(deviceId.isNull()) {
@@ -187,13 +248,34 @@ void ChangeController::uploadNext(bool emitStarted)
 					}
 				} catch (Exception &e) {
 					logWarning() << "Failed to read json for upload. Assuming unchanged. Error:" << e.what();
-					QMetaObject::invokeMethod(this, "uploadDone", Qt::QueuedConnection,
-											  Q_ARG(QByteArray, keyHash));
+					_activeUploads[uKey].started = -1; //completed locally, must not count as round trip
+					if(deviceId.isNull()) {
+						QMetaObject::invokeMethod(this, "uploadDone", Qt::QueuedConnection,
+												  Q_ARG(QByteArray, keyHash));
+					} else {
+						QMetaObject::invokeMethod(this, "deviceUploadDone", Qt::QueuedConnection,
+												  Q_ARG(QByteArray, keyHash),
+												  Q_ARG(QUuid, deviceId));
+					}
 				}
 			}
 
-			return _activeUploads.size() < _uploadLimit; //only continue as long as there is free space
-		});
+			return _activeUploads.size() < uploadWindow(); //only continue as long as there is free space
+		};
+
+		//every pending change is read only once per pass, instead of reloading the first ones on every ack
+		auto restarted = false;
+		while(_activeUploads.size() < uploadWindow()) {
+			if(_changeCursor.done) {
+				//restart at most once per call, deferred collisions wait for the next ack
+				if(!_rescanChanges || restarted)
+					break;
+				_changeCursor = {};
+				_rescanChanges = false;
+				restarted = true;
+			}
+			_store->loadChanges(uploadWindow() - _activeUploads.size(), _changeCursor, visitor);
+		}
 
 		if(_activeUploads.isEmpty()) {
 			endOp(); //stop any timeouts
@@ -207,54 +289,84 @@ void ChangeController::uploadNext(bool emitStarted)
 }
 
 
+void ChangeController::updateUploadWindow(qint64 started)
+{
+	if(started < 0)
+		return;
 
-ChangeController::ChangeInfo::ChangeInfo() = default;
-
-ChangeController::ChangeInfo::ChangeInfo(ObjectKey key, quint64 version, QByteArray checksum) :
-	key{std::move(key)},
-	version{version},
-	checksum{std::move(checksum)}
-{}
-
-
-
-ChangeController::CachedObjectKey::CachedObjectKey() = default;
-
-ChangeController::CachedObjectKey::CachedObjectKey(ObjectKey other, QUuid deviceId) :
-	ObjectKey{std::move(other)},
-	optionalDevice{deviceId}
-{}
-
-ChangeController::CachedObjectKey::CachedObjectKey(QByteArray hash, QUuid deviceId) :
-	ObjectKey{},
-	optionalDevice{deviceId},
-	_hash{std::move(hash)}
-{}
+	const auto now = _uploadClock.elapsed();
+	const auto rtt = now - started;
+	const auto oldRtt = uploadRtt();
+	_rtt = _rtt < 0 ? rtt : (7 * _rtt + rtt) / 8; //smoothed, like TCP does
+	if(_minRtt < 0 || rtt < _minRtt)
+		_minRtt = rtt;
+	if(uploadRtt() != oldRtt)
+		emit uploadRttChanged(uploadRtt());
+
+	if(rtt > 2 * _minRtt + RttTolerance) {
+		//uploads queue up somewhere -> shrink, but only once per round trip
+		if(_lastShrink < 0 || now - _lastShrink > _rtt)
+			shrinkUploadWindow(false);
+	} else if(_slowStart)
+		setUploadWindow(_uploadWindow + 1.0);
+	else
+		setUploadWindow(_uploadWindow + 1.0 / _uploadWindow);
+}
 
-QByteArray ChangeController::CachedObjectKey::hashed() const
+void ChangeController::shrinkUploadWindow(bool toMinimum)
 {
-	if(_hash.isEmpty())
-		_hash = ObjectKey::hashed();
-	return _hash;
+	_slowStart = false;
+	_lastShrink = _uploadClock.elapsed();
+	setUploadWindow(toMinimum ? MinUploadWindow : _uploadWindow / 2.0);
+	logDebug() << "Reduced upload window to" << uploadWindow()
+			   << "( Round trip time:" << _rtt << "ms )";
 }
 
-bool ChangeController::CachedObjectKey::operator==(const CachedObjectKey &other) const
+void ChangeController::setUploadWindow(qreal window)
 {
-	if(!_hash.isEmpty() && !other._hash.isEmpty())
-		return _hash == other._hash && optionalDevice == other.optionalDevice;
-	else
-		return (static_cast<ObjectKey>(*this) == static_cast<ObjectKey>(other)) && optionalDevice == other.optionalDevice;
+	const auto oldWindow = uploadWindow();
+	_uploadWindow = qBound<qreal>(MinUploadWindow, window, qMax(MinUploadWindow, _uploadLimit));
+	if(uploadWindow() != oldWindow)
+		emit uploadWindowChanged(uploadWindow());
 }
 
-bool ChangeController::CachedObjectKey::operator!=(const CachedObjectKey &other) const
+
+void ChangeController::updatePendingChanges()
 {
-	if(!_hash.isEmpty() && !other._hash.isEmpty())
-		return _hash != other._hash || optionalDevice != other.optionalDevice;
-	else
-		return (static_cast<ObjectKey>(*this) != static_cast<ObjectKey>(other)) || optionalDevice != other.optionalDevice;
+	try {
+		//cheap, as the store keeps the count up to date
+		auto pending = static_cast<int>(_store->changeCount());
+		if(pending != _pendingChanges) {
+			_pendingChanges = pending;
+			emit pendingChangesChanged(_pendingChanges);
+		}
+	} catch(Exception &e) {
+		logWarning() << "Failed to count the pending changes with error:" << e.what();
+	}
 }
 
-uint QtDataSync::qHash(const ChangeController::CachedObjectKey &key, uint seed)
+
+ChangeController::ChangeInfo::ChangeInfo() = default;
+
+ChangeController::ChangeInfo::ChangeInfo(ObjectKey key, quint64 version, QByteArray checksum) :
+	key{std::move(key)},
+	version{version},
+	checksum{std::move(checksum)}
+{}
+
+
+
+quint64 ChangeController::uploadKey(const QByteArray &keyHash, const QUuid &deviceId)
 {
-	return qHash(key.hashed(), seed) ^ qHash(key.optionalDevice, seed);
+	//the key hash is a SHA3 hash, so its first 8 bytes are as good as a random number
+	if(keyHash.size() < static_cast<int>(sizeof(quint64)))
+		return qHash(keyHash);
+	auto key = qFromUnaligned<quint64>(keyHash.constData());
+	if(!deviceId.isNull()) {
+		key ^= (static_cast<quint64>(deviceId.data1) << 32) ^
+			   (static_cast<quint64>(deviceId.data2) << 16) ^
+			   static_cast<quint64>(deviceId.data3) ^
+			   qFromUnaligned<quint64>(deviceId.data4);
+	}
+	return key;
 }
@@ -4,6 +4,7 @@
 #include <QtCore/QObject>
 #include <QtCore/QMutex>
 #include <QtCore/QUuid>
+#include <QtCore/QElapsedTimer>
 
 #include "qtdatasync_global.h"
 #include "objectkey.h"
@@ -18,7 +19,16 @@ class Q_DATASYNC_EXPORT ChangeController : public Controller
 {
 	Q_OBJECT
 
+	Q_PROPERTY(int uploadWindow READ uploadWindow NOTIFY uploadWindowChanged)
+	Q_PROPERTY(int uploadRtt READ uploadRtt NOTIFY uploadRttChanged)
+	Q_PROPERTY(int pendingChanges READ pendingChanges NOTIFY pendingChangesChanged)
+
 public:
+	static const int InitialUploadWindow;
+	static const int MinUploadWindow;
+	//acks slower than twice the fastest one plus this tolerance (in ms) count as congestion
+	static const qint64 RttTolerance;
+
 	struct Q_DATASYNC_EXPORT ChangeInfo {
 		ObjectKey key;
 		quint64 version = 0;
@@ -28,28 +38,14 @@ public:
 		ChangeInfo(ObjectKey key, quint64 version, QByteArray checksum = {});
 	};
 
-	//not exported, because of "cheating" api. Declared public because of qHash
-	class CachedObjectKey : public ObjectKey {
-	public:
-		CachedObjectKey();
-		CachedObjectKey(ObjectKey other, QUuid deviceId = {});
-		CachedObjectKey(QByteArray hash, QUuid deviceId = {});
-
-		QByteArray hashed() const;
-
-		QUuid optionalDevice;
-
-		bool operator==(const CachedObjectKey &other) const;
-		bool operator!=(const CachedObjectKey &other) const;
-
-	private:
-		mutable QByteArray _hash;
-	};
-
 	explicit ChangeController(const Defaults &defaults, QObject *parent = nullptr);
 
 	void initialize(const QVariantHash &params) final;
 
+	int uploadWindow() const;
+	int uploadRtt() const;
+	int pendingChanges() const;
+
 public Q_SLOTS:
 	void setUploadingEnabled(bool uploading);
 	void clearUploads();
@@ -57,9 +53,13 @@ public Q_SLOTS:
 
 	void uploadDone(const QByteArray &key);
 	void deviceUploadDone(const QByteArray &key, QUuid deviceId);
+	void uploadsRejected(bool quotaHit);
 
 Q_SIGNALS:
 	void uploadingChanged(bool uploading);
+	void uploadWindowChanged(int uploadWindow);
+	void uploadRttChanged(int uploadRtt);
+	void pendingChangesChanged(int pendingChanges);
 	void uploadChange(const QByteArray &key, const QByteArray &changeData);
 	void uploadDeviceChange(const QByteArray &key, const QUuid &deviceId, const QByteArray &changeData);
 
@@ -73,19 +73,37 @@ private:
 		ObjectKey key;
 		quint64 version;
 		bool isDelete;
+		qint64 started; //on the upload clock, -1 if not send to the remote
+		QByteArray keyHash;
+		QUuid deviceId;
 	};
 
 	LocalStore *_store = nullptr;
 	ChangeEmitter *_emitter = nullptr;
 	bool _uploadingEnabled = false;
-	int _uploadLimit = 10;
-	QHash<CachedObjectKey, UploadInfo> _activeUploads;
+	int _uploadLimit = InitialUploadWindow;
+	QHash<quint64, UploadInfo> _activeUploads;
+	LocalStore::ChangeCursor _changeCursor;
+	bool _rescanChanges = false;
 	quint32 _changeEstimate = 0;
+	int _pendingChanges = 0;
+
+	//AIMD upload window, capped by the limit of the server
+	qreal _uploadWindow = InitialUploadWindow;
+	bool _slowStart = true;
+	QElapsedTimer _uploadClock;
+	qint64 _rtt = -1;
+	qint64 _minRtt = -1;
+	qint64 _lastShrink = -1;
+
+	static quint64 uploadKey(const QByteArray &keyHash, const QUuid &deviceId);
+
+	void updateUploadWindow(qint64 started);
+	void shrinkUploadWindow(bool toMinimum);
+	void setUploadWindow(qreal window);
+	void updatePendingChanges();
 };
 
-//not exported, just like the class
-uint qHash(const ChangeController::CachedObjectKey &key, uint seed);
-
 }
 
 Q_DECLARE_METATYPE(QtDataSync::ChangeController::ChangeInfo)
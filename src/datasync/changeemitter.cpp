@@ -3,24 +3,36 @@ using namespace QtDataSync;
 
 ChangeEmitter::ChangeEmitter(const Defaults &defaults, QObject *parent) :
 	ChangeEmitterSource{parent},
-	_cache{defaults.cacheHandle().value<QSharedPointer<EmitterAdapter::CacheInfo>>()}
+	_cache{defaults.cacheHandle().value<QSharedPointer<EmitterAdapter::CacheInfo>>()},
+	_subscriptions{new EmitterAdapter::SubscriptionInfo{}}
 {}
 
+QSharedPointer<EmitterAdapter::SubscriptionInfo> ChangeEmitter::subscriptions() const
+{
+	return _subscriptions;
+}
+
 void ChangeEmitter::triggerChange(QObject *origin, const ObjectKey &key, bool deleted, bool changed)
 {
 	if(changed)
 		emit uploadNeeded();
-	emit dataChanged(origin, key, deleted);
+	_subscriptions->dispatch(origin, key.typeName, {key.id}, deleted);
 	emit remoteDataChanged(key, deleted);
 }
 
+void ChangeEmitter::triggerChanges(QObject *origin, const QByteArray &typeName, const QStringList &ids, bool deleted, bool changed)
+{
+	if(changed)
+		emit uploadNeeded();
+	_subscriptions->dispatch(origin, typeName, ids, deleted);
+	emit remoteDataChangedBatch(typeName, ids, deleted);
+}
+
 void ChangeEmitter::triggerClear(QObject *origin, const QByteArray &typeName, const QStringList &ids)
 {
 	emit uploadNeeded();
-	for(const auto &id : ids) {
-		emit dataChanged(origin, {typeName, id}, true);
-		emit remoteDataChanged({typeName, id}, true);
-	}
+	_subscriptions->dispatch(origin, typeName, ids, true);
+	emit remoteDataChangedBatch(typeName, ids, true);
 }
 
 void ChangeEmitter::triggerReset(QObject *origin)
@@ -37,45 +49,37 @@ void ChangeEmitter::triggerUpload()
 
 void ChangeEmitter::triggerRemoteChange(const ObjectKey &key, bool deleted, bool changed)
 {
-	if(_cache) {
-		auto contains = false;
-		//check if cached
-		{
-			QReadLocker _(&_cache->lock);
-			contains = _cache->cache.contains(key);
-		}
-		//if chached, remove
-		if(contains) {
-			QWriteLocker _(&_cache->lock);
-			_cache->cache.remove(key);
-		}
-	}
+	if(_cache)
+		_cache->drop(key);
 	if(changed)
 		emit uploadNeeded();
-	emit dataChanged(nullptr, key, deleted);
+	_subscriptions->dispatch(nullptr, key.typeName, {key.id}, deleted);
 	emit remoteDataChanged(key, deleted);
 }
 
+void ChangeEmitter::triggerRemoteChanges(const QByteArray &typeName, const QStringList &ids, bool deleted, bool changed)
+{
+	if(_cache)
+		_cache->drop(typeName, ids);
+	if(changed)
+		emit uploadNeeded();
+	_subscriptions->dispatch(nullptr, typeName, ids, deleted);
+	emit remoteDataChangedBatch(typeName, ids, deleted);
+}
+
 void ChangeEmitter::triggerRemoteClear(const QByteArray &typeName, const QStringList &ids)
 {
-	if(_cache) {
-		QWriteLocker _(&_cache->lock);
-		for(const auto &id : ids)
-			_cache->cache.remove({typeName, id});
-	}
+	if(_cache)
+		_cache->drop(typeName, ids);
 	emit uploadNeeded();
-	for(const auto &id : ids) {
-		emit dataChanged(nullptr, {typeName, id}, true);
-		emit remoteDataChanged({typeName, id}, true);
-	}
+	_subscriptions->dispatch(nullptr, typeName, ids, true);
+	emit remoteDataChangedBatch(typeName, ids, true);
 }
 
 void ChangeEmitter::triggerRemoteReset()
 {
-	if(_cache) {
-		QWriteLocker _(&_cache->lock);
-		_cache->cache.clear();
-	}
+	if(_cache)
+		_cache->clear();
 	emit uploadNeeded();
 	emit dataResetted(nullptr);
 	emit remoteDataResetted();
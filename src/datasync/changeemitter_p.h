@@ -20,11 +20,18 @@ class ChangeEmitter : public ChangeEmitterSource
 public:
 	explicit ChangeEmitter(const Defaults &defaults, QObject *parent = nullptr);
 
+	QSharedPointer<EmitterAdapter::SubscriptionInfo> subscriptions() const;
+
 public Q_SLOTS:
 	void triggerChange(QObject *origin,
 					   const QtDataSync::ObjectKey &key,
 					   bool deleted,
 					   bool changed);
+	void triggerChanges(QObject *origin,
+						const QByteArray &typeName,
+						const QStringList &ids,
+						bool deleted,
+						bool changed);
 	void triggerClear(QObject *origin, const QByteArray &typeName, const QStringList &ids);
 	void triggerReset(QObject *origin);
 	void triggerUpload() override;
@@ -32,17 +39,18 @@ public Q_SLOTS:
 Q_SIGNALS:
 	void uploadNeeded();
 
-	void dataChanged(QObject *origin, const QtDataSync::ObjectKey &key, bool deleted);
 	void dataResetted(QObject *origin);
 
 protected Q_SLOTS:
 	//remcon interface
 	void triggerRemoteChange(const ObjectKey &key, bool deleted, bool changed) override;
+	void triggerRemoteChanges(const QByteArray &typeName, const QStringList &ids, bool deleted, bool changed) override;
 	void triggerRemoteClear(const QByteArray &typeName, const QStringList &ids) override;
 	void triggerRemoteReset() override;
 
 private:
 	QSharedPointer<EmitterAdapter::CacheInfo> _cache;//needed to clear cache on remote changes
+	QSharedPointer<EmitterAdapter::SubscriptionInfo> _subscriptions;
 };
 
 }
@@ -0,0 +1,337 @@
+#ifndef QTDATASYNC_CONCURRENTCACHE_P_H
+#define QTDATASYNC_CONCURRENTCACHE_P_H
+
+#include <QtCore/QAtomicInt>
+#include <QtCore/QHash>
+#include <QtCore/QList>
+#include <QtCore/QReadWriteLock>
+#include <QtCore/QVector>
+
+#include "qtdatasync_global.h"
+
+namespace QtDataSync {
+
+//! A cost limited cache that can be read from many threads in parallel
+template <typename TKey, typename TValue>
+class ConcurrentCache
+{
+	Q_DISABLE_COPY(ConcurrentCache)
+
+public:
+	static const int MaxShards = 16;
+	static const int MinShardCost = 1024 * 1024;
+
+	struct Statistics {
+		quint64 hits = 0;
+		quint64 misses = 0;
+		quint64 evictions = 0;
+	};
+
+	explicit ConcurrentCache(int maxCost);
+	~ConcurrentCache();
+
+	int maxCost() const;
+	void setMaxCost(int maxCost);
+	int totalCost() const;
+	int count() const;
+	QList<TKey> keys() const;
+	Statistics statistics() const;
+	template <typename TFunc>
+	void forEach(const TFunc &fn) const; // fn(key, cost)
+
+	bool insert(const TKey &key, const TValue &value, int cost);
+	bool object(const TKey &key, TValue &value, int *cost = nullptr) const;
+	bool peek(const TKey &key, TValue &value, int *cost = nullptr) const;
+	bool contains(const TKey &key) const;
+	bool remove(const TKey &key);
+	void clear();
+
+private:
+	// entries are evicted with the CLOCK algorithm: reads only set a flag, so they can share the lock
+	struct Slot {
+		TKey key;
+		TValue value;
+		int cost = 0;
+		bool used = false;
+		mutable QAtomicInt referenced;
+	};
+
+	struct Shard {
+		mutable QReadWriteLock lock;
+		QHash<TKey, int> index;
+		QVector<Slot> slots;
+		QVector<int> freeSlots;
+		int hand = 0;
+		int totalCost = 0;
+		int maxCost = 0;
+		//counted per shard, so readers of different shards do not share a counter
+		mutable QAtomicInteger<quint64> hits;
+		mutable QAtomicInteger<quint64> misses;
+		quint64 evictions = 0;
+
+		void removeSlot(int slotIndex);
+		void evict(int requiredCost);
+	};
+
+	QAtomicInt _maxCost;
+	QVector<Shard*> _shards;
+
+	Shard *shard(const TKey &key) const;
+};
+
+// ------------- Generic Implementation -------------
+
+template<typename TKey, typename TValue>
+ConcurrentCache<TKey, TValue>::ConcurrentCache(int maxCost) :
+	_maxCost{maxCost}
+{
+	//power of two shards, but keep them large enough to hold bigger objects
+	auto shardCount = 1;
+	while(shardCount < MaxShards && (maxCost / (shardCount * 2)) >= MinShardCost)
+		shardCount *= 2;
+	_shards.reserve(shardCount);
+	for(auto i = 0; i < shardCount; i++) {
+		auto shard = new Shard{};
+		shard->maxCost = maxCost / shardCount;
+		_shards.append(shard);
+	}
+}
+
+template<typename TKey, typename TValue>
+ConcurrentCache<TKey, TValue>::~ConcurrentCache()
+{
+	qDeleteAll(_shards);
+}
+
+template<typename TKey, typename TValue>
+int ConcurrentCache<TKey, TValue>::maxCost() const
+{
+	return _maxCost.load();
+}
+
+template<typename TKey, typename TValue>
+void ConcurrentCache<TKey, TValue>::setMaxCost(int maxCost)
+{
+	//the shard count stays the same, only their limits change
+	_maxCost.store(maxCost);
+	for(auto shard : _shards) {
+		QWriteLocker _(&shard->lock);
+		shard->maxCost = maxCost / _shards.size();
+		shard->evict(0);
+	}
+}
+
+template<typename TKey, typename TValue>
+int ConcurrentCache<TKey, TValue>::totalCost() const
+{
+	auto cost = 0;
+	for(auto shard : _shards) {
+		QReadLocker _(&shard->lock);
+		cost += shard->totalCost;
+	}
+	return cost;
+}
+
+template<typename TKey, typename TValue>
+int ConcurrentCache<TKey, TValue>::count() const
+{
+	auto count = 0;
+	for(auto shard : _shards) {
+		QReadLocker _(&shard->lock);
+		count += shard->index.size();
+	}
+	return count;
+}
+
+template<typename TKey, typename TValue>
+QList<TKey> ConcurrentCache<TKey, TValue>::keys() const
+{
+	//entries read since the last eviction sweep come first
+	QList<TKey> referencedKeys;
+	QList<TKey> otherKeys;
+	for(auto shard : _shards) {
+		QReadLocker _(&shard->lock);
+		for(const auto &slot : shard->slots) {
+			if(!slot.used)
+				continue;
+			if(slot.referenced.load() != 0)
+				referencedKeys.append(slot.key);
+			else
+				otherKeys.append(slot.key);
+		}
+	}
+	return referencedKeys + otherKeys;
+}
+
+template<typename TKey, typename TValue>
+typename ConcurrentCache<TKey, TValue>::Statistics ConcurrentCache<TKey, TValue>::statistics() const
+{
+	Statistics statistics;
+	for(auto shard : _shards) {
+		statistics.hits += shard->hits.load();
+		statistics.misses += shard->misses.load();
+		QReadLocker _(&shard->lock);
+		statistics.evictions += shard->evictions;
+	}
+	return statistics;
+}
+
+template<typename TKey, typename TValue>
+template<typename TFunc>
+void ConcurrentCache<TKey, TValue>::forEach(const TFunc &fn) const
+{
+	for(auto shard : _shards) {
+		QReadLocker _(&shard->lock);
+		for(const auto &slot : shard->slots) {
+			if(slot.used)
+				fn(slot.key, slot.cost);
+		}
+	}
+}
+
+template<typename TKey, typename TValue>
+bool ConcurrentCache<TKey, TValue>::insert(const TKey &key, const TValue &value, int cost)
+{
+	auto shard = this->shard(key);
+	QWriteLocker _(&shard->lock);
+
+	auto it = shard->index.constFind(key);
+	if(it != shard->index.constEnd())
+		shard->removeSlot(*it);
+	if(cost > shard->maxCost) //same as QCache: too large objects are not cached at all
+		return false;
+
+	shard->evict(cost);
+	int slotIndex;
+	if(shard->freeSlots.isEmpty()) {
+		slotIndex = shard->slots.size();
+		shard->slots.resize(slotIndex + 1);
+	} else
+		slotIndex = shard->freeSlots.takeLast();
+
+	auto &slot = shard->slots[slotIndex];
+	slot.key = key;
+	slot.value = value;
+	slot.cost = cost;
+	slot.used = true;
+	slot.referenced.store(0);
+	shard->index.insert(key, slotIndex);
+	shard->totalCost += cost;
+	return true;
+}
+
+template<typename TKey, typename TValue>
+bool ConcurrentCache<TKey, TValue>::object(const TKey &key, TValue &value, int *cost) const
+{
+	auto shard = this->shard(key);
+	QReadLocker _(&shard->lock);
+
+	auto it = shard->index.constFind(key);
+	if(it == shard->index.constEnd()) {
+		shard->misses.fetchAndAddRelaxed(1);
+		return false;
+	}
+	shard->hits.fetchAndAddRelaxed(1);
+	const auto &slot = shard->slots[*it];
+	slot.referenced.store(1);
+	value = slot.value;
+	if(cost)
+		*cost = slot.cost;
+	return true;
+}
+
+template<typename TKey, typename TValue>
+bool ConcurrentCache<TKey, TValue>::peek(const TKey &key, TValue &value, int *cost) const
+{
+	//like object, but does not count as an access
+	auto shard = this->shard(key);
+	QReadLocker _(&shard->lock);
+
+	auto it = shard->index.constFind(key);
+	if(it == shard->index.constEnd())
+		return false;
+	const auto &slot = shard->slots[*it];
+	value = slot.value;
+	if(cost)
+		*cost = slot.cost;
+	return true;
+}
+
+template<typename TKey, typename TValue>
+bool ConcurrentCache<TKey, TValue>::contains(const TKey &key) const
+{
+	auto shard = this->shard(key);
+	QReadLocker _(&shard->lock);
+	return shard->index.contains(key);
+}
+
+template<typename TKey, typename TValue>
+bool ConcurrentCache<TKey, TValue>::remove(const TKey &key)
+{
+	auto shard = this->shard(key);
+	//check if cached first, to not block readers if not needed
+	{
+		QReadLocker _(&shard->lock);
+		if(!shard->index.contains(key))
+			return false;
+	}
+
+	QWriteLocker _(&shard->lock);
+	auto it = shard->index.constFind(key);
+	if(it == shard->index.constEnd())
+		return false;
+	shard->removeSlot(*it);
+	return true;
+}
+
+template<typename TKey, typename TValue>
+void ConcurrentCache<TKey, TValue>::clear()
+{
+	for(auto shard : _shards) {
+		QWriteLocker _(&shard->lock);
+		shard->index.clear();
+		shard->slots.clear();
+		shard->freeSlots.clear();
+		shard->hand = 0;
+		shard->totalCost = 0;
+	}
+}
+
+template<typename TKey, typename TValue>
+typename ConcurrentCache<TKey, TValue>::Shard *ConcurrentCache<TKey, TValue>::shard(const TKey &key) const
+{
+	return _shards[static_cast<int>(qHash(key) % static_cast<uint>(_shards.size()))];
+}
+
+template<typename TKey, typename TValue>
+void ConcurrentCache<TKey, TValue>::Shard::removeSlot(int slotIndex)
+{
+	auto &slot = slots[slotIndex];
+	index.remove(slot.key);
+	totalCost -= slot.cost;
+	slot.key = TKey{};
+	slot.value = TValue{};
+	slot.cost = 0;
+	slot.used = false;
+	freeSlots.append(slotIndex);
+}
+
+template<typename TKey, typename TValue>
+void ConcurrentCache<TKey, TValue>::Shard::evict(int requiredCost)
+{
+	//sweep over the slots, giving recently read ones a second chance
+	while(totalCost + requiredCost > maxCost && !index.isEmpty()) {
+		if(hand >= slots.size())
+			hand = 0;
+		auto &slot = slots[hand];
+		if(slot.used && slot.referenced.fetchAndStoreRelaxed(0) == 0) {
+			removeSlot(hand);
+			evictions++;
+		}
+		hand++;
+	}
+}
+
+}
+
+#endif // QTDATASYNC_CONCURRENTCACHE_P_H
@@ -389,6 +389,54 @@ QByteArray CryptoController::decryptData(quint32 keyIndex, const QByteArray &sal
 	}
 }
 
+tuple<quint32, QByteArray, CryptoController::DataCipher> CryptoController::prepareEncryptData()
+{
+	try {
+		//the key and the rng are not thread safe, so only the cipher itself is deferred
+		auto info = getInfo(_localCipher);
+		QByteArray salt(static_cast<int>(info.scheme->ivLength()), Qt::Uninitialized);
+		_asymCrypto->rng().GenerateBlock(reinterpret_cast<byte*>(salt.data()),
+										 static_cast<size_t>(salt.size()));
+
+		auto setupDefaults = defaults();
+		DataCipher encryptor = [info, salt, setupDefaults](const QByteArray &plain) {
+			try {
+				return encryptImpl(info, salt, plain);
+			} catch(CppException &e) {
+				throw CryptoException(setupDefaults,
+									  QStringLiteral("Failed to encrypt data for upload"),
+									  e);
+			}
+		};
+		return make_tuple(_localCipher, salt, encryptor);
+	} catch(CppException &e) {
+		throw CryptoException(defaults(),
+							  QStringLiteral("Failed to encrypt data for upload"),
+							  e);
+	}
+}
+
+CryptoController::DataCipher CryptoController::prepareDecryptData(quint32 keyIndex, const QByteArray &salt) const
+{
+	try {
+		auto info = getInfo(keyIndex);
+		auto setupDefaults = defaults();
+		return [info, salt, setupDefaults](const QByteArray &cipher) {
+			try {
+				return decryptImpl(info, salt, cipher);
+			} catch(CppException &e) {
+				throw CryptoException(setupDefaults,
+									  QStringLiteral("Failed to decrypt downloaded data"),
+									  e);
+			}
+		};
+	} catch(CppException &e) {
+		throw CryptoException(defaults(),
+							  QStringLiteral("Failed to decrypt downloaded data"),
+							  e);
+	}
+}
+
 QByteArray CryptoController::createCmac(const QByteArray &data) const
 {
 	return createCmac(_localCipher, data);
@@ -915,7 +963,7 @@ void CryptoController::verifyCmacImpl(const CryptoController::CipherInfo &info,
 	); // QByteArraySource
 }
 
-QByteArray CryptoController::encryptImpl(const CryptoController::CipherInfo &info, const QByteArray &salt, const QByteArray &plain) const
+QByteArray CryptoController::encryptImpl(const CryptoController::CipherInfo &info, const QByteArray &salt, const QByteArray &plain)
 {
 	auto enc = info.scheme->encryptor();
 	enc->SetKeyWithIV(info.key.data(), info.key.size(),
@@ -931,7 +979,7 @@ QByteArray CryptoController::encryptImpl(const CryptoController::CipherInfo &inf
 	return cipher;
 }
 
-QByteArray CryptoController::decryptImpl(const CryptoController::CipherInfo &info, const QByteArray &salt, const QByteArray &cipher) const
+QByteArray CryptoController::decryptImpl(const CryptoController::CipherInfo &info, const QByteArray &salt, const QByteArray &cipher)
 {
 	auto dec = info.scheme->decryptor();
 	dec->SetKeyWithIV(info.key.data(), info.key.size(),
@@ -1,6 +1,7 @@
 #ifndef QTDATASYNC_CRYPTOCONTROLLER_P_H
 #define QTDATASYNC_CRYPTOCONTROLLER_P_H
 
+#include <functional>
 #include <tuple>
 
 #include <QtCore/QObject>
@@ -89,6 +90,10 @@ public:
 	//used for transport encryption of actual data
 	std::tuple<quint32, QByteArray, QByteArray> encryptData(const QByteArray &data); //(keyIndex, salt, data)
 	QByteArray decryptData(quint32 keyIndex, const QByteArray &salt, const QByteArray &cipher) const;
+	//same as above, but split: keys and salt are prepared here, the returned cipher can run on any thread
+	using DataCipher = std::function<QByteArray(const QByteArray &)>;
+	std::tuple<quint32, QByteArray, DataCipher> prepareEncryptData(); //(keyIndex, salt, encryptor)
+	DataCipher prepareDecryptData(quint32 keyIndex, const QByteArray &salt) const;
 
 	// cmac generation for verification of key updates etc.
 	QByteArray createCmac(const QByteArray &data) const;
@@ -178,8 +183,8 @@ private:
 
 	QByteArray createCmacImpl(const CipherInfo &info, const QByteArray &data) const;
 	void verifyCmacImpl(const CipherInfo &info, const QByteArray &data, const QByteArray &mac) const;
-	QByteArray encryptImpl(const CipherInfo &info, const QByteArray &salt, const QByteArray &plain) const;
-	QByteArray decryptImpl(const CipherInfo &info, const QByteArray &salt, const QByteArray &cipher) const;
+	static QByteArray encryptImpl(const CipherInfo &info, const QByteArray &salt, const QByteArray &plain);
+	static QByteArray decryptImpl(const CipherInfo &info, const QByteArray &salt, const QByteArray &cipher);
 };
 
 class Q_DATASYNC_EXPORT ClientCrypto : public AsymmetricCrypto
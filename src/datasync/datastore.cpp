@@ -1,6 +1,7 @@
 #include "datastore.h"
 #include "datastore_p.h"
 #include "defaults_p.h"
+#include "asyncstore_p.h"
 
 #include <QtJsonSerializer/QJsonSerializer>
 
@@ -39,6 +40,10 @@ void DataStore::initStore(const QString &setupName)
 			this, [this](const ObjectKey &key, bool deleted) {
 		emit dataChanged(QMetaType::type(key.typeName), key.id, deleted, {});
 	});
+	connect(d->store, &LocalStore::dataChangedBatch,
+			this, [this](const QByteArray &typeName, const QStringList &ids, bool deleted) {
+		emit dataChangedBatch(QMetaType::type(typeName), ids, deleted, {});
+	});
 	connect(d->store, &LocalStore::dataResetted,
 			this, PSIG(&DataStore::dataResetted));
 }
@@ -55,6 +60,11 @@ QStringList DataStore::keys(int metaTypeId) const
 	return d->store->keys(d->typeName(metaTypeId));
 }
 
+QStringList DataStore::keys(int metaTypeId, const QString &afterKey, int limit, bool reverse) const
+{
+	return d->store->keys(d->typeName(metaTypeId), afterKey, limit, reverse);
+}
+
 QVariantList DataStore::loadAll(int metaTypeId) const
 {
 	const auto allData = d->store->loadAll(d->typeName(metaTypeId));
@@ -72,44 +82,35 @@ bool DataStore::contains(int metaTypeId, const QString &key) const
 
 QVariant DataStore::load(int metaTypeId, const QString &key) const
 {
-	auto data = d->store->load({d->typeName(metaTypeId), key});
-	return d->serializer->deserialize(data, metaTypeId);
+	const ObjectKey objectKey{d->typeName(metaTypeId), key};
+	//only gadgets are value types - objects belong to the caller and cannot be shared
+	const auto isGadget = QMetaType::typeFlags(metaTypeId).testFlag(QMetaType::IsGadget);
+	QVariant value;
+	if(isGadget && d->store->loadCachedValue(objectKey, metaTypeId, value))
+		return value;
+
+	auto data = d->store->load(objectKey);
+	value = d->serializer->deserialize(data, metaTypeId);
+	if(isGadget)
+		d->store->cacheValue(objectKey, data, value);
+	return value;
 }
 
 void DataStore::save(int metaTypeId, QVariant value)
 {
 	auto typeName = d->typeName(metaTypeId);
-	if(!value.convert(metaTypeId))
-		throw InvalidDataException(d->defaults, typeName, QStringLiteral("Failed to convert passed variant to the target type"));
-
-	auto meta = QMetaType::metaObjectForType(metaTypeId);
-	if(!meta)
-		throw InvalidDataException(d->defaults, typeName, QStringLiteral("Type does not have a meta object"));
-	auto userProp = meta->userProperty();
-	if(!userProp.isValid())
-		throw InvalidDataException(d->defaults, typeName, QStringLiteral("Type does not have a user property"));
-
-	QString key;
-	auto flags = QMetaType::typeFlags(metaTypeId);
-	if(flags.testFlag(QMetaType::IsGadget))
-		key = userProp.readOnGadget(value.data()).toString();
-	else if(flags.testFlag(QMetaType::PointerToQObject))
-		key = userProp.read(value.value<QObject*>()).toString();
-	else if(flags.testFlag(QMetaType::SharedPointerToQObject))
-		key = userProp.read(value.value<QSharedPointer<QObject>>().data()).toString();
-	else if(flags.testFlag(QMetaType::WeakPointerToQObject))
-		key = userProp.read(value.value<QWeakPointer<QObject>>().data()).toString();
-	else if(flags.testFlag(QMetaType::TrackingPointerToQObject))
-		key = userProp.read(value.value<QPointer<QObject>>().data()).toString();
-	else
-		throw InvalidDataException(d->defaults, typeName, QStringLiteral("Type is neither a gadget nor a pointer to an object"));
+	auto data = d->serialize(metaTypeId, typeName, std::move(value));
+	d->store->save({typeName, data.first}, data.second);
+}
 
-	if(key.isEmpty())
-		throw InvalidDataException(d->defaults, typeName, QStringLiteral("Failed to convert USER property to a string"));
-	auto json = d->serializer->serialize(value);
-	if(!json.isObject())
-		throw InvalidDataException(d->defaults, typeName, QStringLiteral("Serialization converted to invalid json type. Only json objects are allowed"));
-	d->store->save({typeName, key}, json.toObject());
+void DataStore::saveAll(int metaTypeId, const QVariantList &values)
+{
+	auto typeName = d->typeName(metaTypeId);
+	QList<QPair<QString, QJsonObject>> allData;
+	allData.reserve(values.size());
+	for(const auto &value : values)
+		allData.append(d->serialize(metaTypeId, typeName, value));
+	d->store->saveAll(typeName, allData);
 }
 
 bool DataStore::remove(int metaTypeId, const QString &key)
@@ -117,6 +118,11 @@ bool DataStore::remove(int metaTypeId, const QString &key)
 	return d->store->remove({d->typeName(metaTypeId), key});
 }
 
+int DataStore::removeAll(int metaTypeId, const QStringList &keys)
+{
+	return d->store->removeAll(d->typeName(metaTypeId), keys);
+}
+
 void DataStore::update(int metaTypeId, QObject *object) const
 {
 	auto typeName = d->typeName(metaTypeId);
@@ -148,7 +154,30 @@ void DataStore::update(int metaTypeId, QObject *object) const
 
 QVariantList DataStore::search(int metaTypeId, const QString &query, SearchMode mode) const
 {
-	const auto dataList= d->store->find(d->typeName(metaTypeId), query, mode);
+	return search(metaTypeId, query, mode, 0, -1);
+}
+
+QVariantList DataStore::search(int metaTypeId, const QString &query, SearchMode mode, int offset, int limit) const
+{
+	const auto dataList = d->store->find(d->typeName(metaTypeId), query, mode, offset, limit);
+	QVariantList resList;
+	resList.reserve(dataList.size());
+	for(const auto &val : dataList)
+		resList.append(d->serializer->deserialize(val, metaTypeId));
+	return resList;
+}
+
+QVariantList DataStore::findBy(int metaTypeId, const QString &property, const QVariant &value) const
+{
+	return findBy(metaTypeId, property, value, value);
+}
+
+QVariantList DataStore::findBy(int metaTypeId, const QString &property, const QVariant &from, const QVariant &to) const
+{
+	const auto dataList = d->store->findBy(d->typeName(metaTypeId),
+										   property,
+										   d->serializer->serialize(from),
+										   d->serializer->serialize(to));
 	QVariantList resList;
 	resList.reserve(dataList.size());
 	for(const auto &val : dataList)
@@ -156,6 +185,11 @@ QVariantList DataStore::search(int metaTypeId, const QString &query, SearchMode
 	return resList;
 }
 
+QStringList DataStore::searchText(int metaTypeId, const QString &query, int limit) const
+{
+	return d->store->searchText(d->typeName(metaTypeId), query, limit);
+}
+
 void DataStore::iterate(int metaTypeId, const function<bool (QVariant)> &iterator) const
 {
 	iterate(metaTypeId, iterator, false);
@@ -163,9 +197,19 @@ void DataStore::iterate(int metaTypeId, const function<bool (QVariant)> &iterato
 
 void DataStore::iterate(int metaTypeId, const std::function<bool (QVariant)> &iterator, bool skipBroken) const
 {
-	for(const auto &key : keys(metaTypeId)) { // clazy:exclude=range-loop
+	//same caching as load(), so repeated iterations do not deserialize everything again
+	const auto isGadget = QMetaType::typeFlags(metaTypeId).testFlag(QMetaType::IsGadget);
+	auto cursor = d->store->iterate(d->typeName(metaTypeId));
+	while(cursor.next()) {
 		try {
-			if(!iterator(load(metaTypeId, key)))
+			QVariant value;
+			if(!isGadget || !d->store->loadCachedValue(cursor.key(), metaTypeId, value)) {
+				auto data = cursor.load();
+				value = d->serializer->deserialize(data, metaTypeId);
+				if(isGadget)
+					d->store->cacheValue(cursor.key(), data, value);
+			}
+			if(!iterator(value))
 				break;
 		} catch(NoDataException &) {
 			//no data is not considered an error in this scenario
@@ -183,6 +227,112 @@ void DataStore::clear(int metaTypeId)
 	d->store->clear(d->typeName(metaTypeId));
 }
 
+void DataStore::subscribe(int metaTypeId, const QString &keyPrefix)
+{
+	d->store->subscribe(d->typeName(metaTypeId), keyPrefix);
+}
+
+void DataStore::unsubscribe(int metaTypeId)
+{
+	d->store->unsubscribe(d->typeName(metaTypeId));
+}
+
+void DataStore::clearSubscriptions()
+{
+	d->store->clearSubscriptions();
+}
+
+QFuture<QVariant> DataStore::loadAsync(int metaTypeId, const QString &key) const
+{
+	QFutureInterface<QVariant> futureInterface;
+	auto thread = QThread::currentThread();
+	runAsync(metaTypeId, false, futureInterface, [futureInterface, metaTypeId, key, thread](DataStore *store) mutable {
+		futureInterface.reportResult(DataStorePrivate::moveToThread(store->load(metaTypeId, key), thread));
+	});
+	return futureInterface.future();
+}
+
+QFuture<QVariant> DataStore::loadAllAsync(int metaTypeId) const
+{
+	QFutureInterface<QVariant> futureInterface;
+	auto thread = QThread::currentThread();
+	runAsync(metaTypeId, false, futureInterface, [futureInterface, metaTypeId, thread](DataStore *store) mutable {
+		QVector<QVariant> results;
+		for(const auto &value : store->loadAll(metaTypeId))
+			results.append(DataStorePrivate::moveToThread(value, thread));
+		futureInterface.reportResults(results);
+	});
+	return futureInterface.future();
+}
+
+QFuture<void> DataStore::saveAsync(int metaTypeId, QVariant value)
+{
+	QFutureInterface<void> futureInterface;
+	//objects belong to the calling thread, so they must be serialized here
+	QByteArray typeName;
+	QPair<QString, QJsonObject> data;
+	try {
+		typeName = d->typeName(metaTypeId);
+		data = d->serialize(metaTypeId, typeName, std::move(value));
+	} catch(QException &e) {
+		futureInterface.reportStarted();
+		futureInterface.reportException(e);
+		futureInterface.reportFinished();
+		return futureInterface.future();
+	}
+
+	runAsync(metaTypeId, true, futureInterface, [typeName, data](DataStore *store) {
+		store->d->store->save({typeName, data.first}, data.second);
+	});
+	return futureInterface.future();
+}
+
+QFuture<bool> DataStore::removeAsync(int metaTypeId, const QString &key)
+{
+	QFutureInterface<bool> futureInterface;
+	runAsync(metaTypeId, true, futureInterface, [futureInterface, metaTypeId, key](DataStore *store) mutable {
+		futureInterface.reportResult(store->remove(metaTypeId, key));
+	});
+	return futureInterface.future();
+}
+
+QFuture<QVariant> DataStore::searchAsync(int metaTypeId, const QString &query, SearchMode mode) const
+{
+	QFutureInterface<QVariant> futureInterface;
+	auto thread = QThread::currentThread();
+	runAsync(metaTypeId, false, futureInterface, [futureInterface, metaTypeId, query, mode, thread](DataStore *store) mutable {
+		QVector<QVariant> results;
+		for(const auto &value : store->search(metaTypeId, query, mode))
+			results.append(DataStorePrivate::moveToThread(value, thread));
+		futureInterface.reportResults(results);
+	});
+	return futureInterface.future();
+}
+
+void DataStore::runAsync(int metaTypeId, bool exclusive, QFutureInterfaceBase futureInterface, const std::function<void(DataStore*)> &task) const
+{
+	futureInterface.reportStarted();
+	try {
+		auto typeName = d->typeName(metaTypeId);
+		auto setupName = d->defaults.setupName();
+		d->defaults.asyncStore()->enqueue(typeName, exclusive, [futureInterface, task, setupName](DataStore *store) mutable {
+			try {
+				if(!store)
+					throw SetupDoesNotExistException(setupName);
+				task(store);
+			} catch(QException &e) {
+				futureInterface.reportException(e);
+			} catch(std::exception &) {
+				futureInterface.reportException(QUnhandledException{});
+			}
+			futureInterface.reportFinished();
+		});
+	} catch(QException &e) {
+		futureInterface.reportException(e);
+		futureInterface.reportFinished();
+	}
+}
+
 // ------------- PRIVATE IMPLEMENTATION -------------
 
 DataStorePrivate::DataStorePrivate(DataStore *q, const QString &setupName) :
@@ -201,6 +351,52 @@ QByteArray DataStorePrivate::typeName(int metaTypeId) const
 		throw InvalidDataException(defaults, "type_" + QByteArray::number(metaTypeId), QStringLiteral("Not a valid metatype id"));
 }
 
+QVariant DataStorePrivate::moveToThread(QVariant value, QThread *thread)
+{
+	//objects are created on the I/O threads, but belong to the caller
+	if(QMetaType::typeFlags(value.userType()).testFlag(QMetaType::PointerToQObject)) {
+		auto object = value.value<QObject*>();
+		if(object)
+			object->moveToThread(thread);
+	}
+	return value;
+}
+
+QPair<QString, QJsonObject> DataStorePrivate::serialize(int metaTypeId, const QByteArray &typeName, QVariant value) const
+{
+	if(!value.convert(metaTypeId))
+		throw InvalidDataException(defaults, typeName, QStringLiteral("Failed to convert passed variant to the target type"));
+
+	auto meta = QMetaType::metaObjectForType(metaTypeId);
+	if(!meta)
+		throw InvalidDataException(defaults, typeName, QStringLiteral("Type does not have a meta object"));
+	auto userProp = meta->userProperty();
+	if(!userProp.isValid())
+		throw InvalidDataException(defaults, typeName, QStringLiteral("Type does not have a user property"));
+
+	QString key;
+	auto flags = QMetaType::typeFlags(metaTypeId);
+	if(flags.testFlag(QMetaType::IsGadget))
+		key = userProp.readOnGadget(value.data()).toString();
+	else if(flags.testFlag(QMetaType::PointerToQObject))
+		key = userProp.read(value.value<QObject*>()).toString();
+	else if(flags.testFlag(QMetaType::SharedPointerToQObject))
+		key = userProp.read(value.value<QSharedPointer<QObject>>().data()).toString();
+	else if(flags.testFlag(QMetaType::WeakPointerToQObject))
+		key = userProp.read(value.value<QWeakPointer<QObject>>().data()).toString();
+	else if(flags.testFlag(QMetaType::TrackingPointerToQObject))
+		key = userProp.read(value.value<QPointer<QObject>>().data()).toString();
+	else
+		throw InvalidDataException(defaults, typeName, QStringLiteral("Type is neither a gadget nor a pointer to an object"));
+
+	if(key.isEmpty())
+		throw InvalidDataException(defaults, typeName, QStringLiteral("Failed to convert USER property to a string"));
+	auto json = serializer->serialize(value);
+	if(!json.isObject())
+		throw InvalidDataException(defaults, typeName, QStringLiteral("Serialization converted to invalid json type. Only json objects are allowed"));
+	return {key, json.toObject()};
+}
+
 // ------------- Exceptions -------------
 
 DataStoreException::DataStoreException(const Defaults &defaults, const QString &message) :
@@ -6,6 +6,9 @@
 #include <QtCore/qobject.h>
 #include <QtCore/qscopedpointer.h>
 #include <QtCore/qvariant.h>
+#include <QtCore/qfuture.h>
+#include <QtCore/qfutureinterface.h>
+#include <QtCore/qthread.h>
 
 #include "QtDataSync/qtdatasync_global.h"
 #include "QtDataSync/objectkey.h"
@@ -22,6 +25,7 @@ class Q_DATASYNC_EXPORT DataStore : public QObject
 {
 	Q_OBJECT
 	friend class DataStoreModel;
+	friend class AsyncStore;
 
 public:
 	//! Possible pattern modes for the search mechanism
@@ -48,6 +52,8 @@ public:
 	qint64 count(int metaTypeId) const;
 	//! @copybrief DataStore::keys() const
 	QStringList keys(int metaTypeId) const;
+	//! @copybrief DataStore::keys(const QString &, int, bool) const
+	QStringList keys(int metaTypeId, const QString &afterKey, int limit, bool reverse = false) const;
 	//! @copybrief DataStore::loadAll() const
 	QVariantList loadAll(int metaTypeId) const;
 	//! @copybrief DataStore::contains(const QString &) const
@@ -66,6 +72,10 @@ public:
 	void save(int metaTypeId, QVariant value);
 	//! @copybrief DataStore::remove(const QString &)
 	bool remove(int metaTypeId, const QString &key);
+	//! @copybrief DataStore::saveAll(const QList<T> &)
+	void saveAll(int metaTypeId, const QVariantList &values);
+	//! @copybrief DataStore::removeAll(const QStringList &)
+	int removeAll(int metaTypeId, const QStringList &keys);
 	//! @copybrief DataStore::remove(int, const QString &)
 	inline bool remove(int metaTypeId, const QVariant &key) {
 		return remove(metaTypeId, key.toString());
@@ -74,6 +84,14 @@ public:
 	void update(int metaTypeId, QObject *object) const;
 	//! @copybrief DataStore::search(const QString &, SearchMode) const
 	QVariantList search(int metaTypeId, const QString &query, SearchMode mode = RegexpMode) const;
+	//! @copybrief DataStore::search(const QString &, SearchMode, int, int) const
+	QVariantList search(int metaTypeId, const QString &query, SearchMode mode, int offset, int limit) const;
+	//! @copybrief DataStore::findBy(const QString &, const QVariant &) const
+	QVariantList findBy(int metaTypeId, const QString &property, const QVariant &value) const;
+	//! @copybrief DataStore::findBy(const QString &, const QVariant &, const QVariant &) const
+	QVariantList findBy(int metaTypeId, const QString &property, const QVariant &from, const QVariant &to) const;
+	//! @copybrief DataStore::searchText(const QString &, int) const
+	QStringList searchText(int metaTypeId, const QString &query, int limit = -1) const;
 	//! @copybrief DataStore::iterate(const std::function<bool(T)> &, bool) const
 	void iterate(int metaTypeId,
 				 const std::function<bool(QVariant)> &iterator) const;
@@ -83,6 +101,22 @@ public:
 				 bool skipBroken) const; //MAJOR merge overloads
 	//! @copybrief DataStore::clear()
 	void clear(int metaTypeId);
+	//! @copybrief DataStore::subscribe(const QString &)
+	void subscribe(int metaTypeId, const QString &keyPrefix = {});
+	//! @copybrief DataStore::unsubscribe()
+	void unsubscribe(int metaTypeId);
+	//! Removes all subscriptions, so changes of all types are reported again
+	void clearSubscriptions();
+	//! @copybrief DataStore::loadAsync(const QString &) const
+	QFuture<QVariant> loadAsync(int metaTypeId, const QString &key) const;
+	//! @copybrief DataStore::loadAllAsync() const
+	QFuture<QVariant> loadAllAsync(int metaTypeId) const;
+	//! @copybrief DataStore::saveAsync(const T &)
+	QFuture<void> saveAsync(int metaTypeId, QVariant value);
+	//! @copybrief DataStore::removeAsync(const QString &)
+	QFuture<bool> removeAsync(int metaTypeId, const QString &key);
+	//! @copybrief DataStore::searchAsync(const QString &, SearchMode) const
+	QFuture<QVariant> searchAsync(int metaTypeId, const QString &query, SearchMode mode = RegexpMode) const;
 
 	//! Counts the number of datasets for the given type
 	template<typename T>
@@ -97,6 +131,9 @@ public:
 	 */
 	template<typename T, typename K>
 	QList<K> keys() const;
+	//! Returns one page of the saved keys for the given type, in key order
+	template<typename T>
+	QStringList keys(const QString &afterKey, int limit, bool reverse = false) const;
 	//! Loads all existing datasets for the given type
 	template<typename T>
 	QList<T> loadAll() const;
@@ -121,22 +158,73 @@ public:
 	//! @copybrief DataStore::remove(const QString &)
 	template<typename T, typename K>
 	bool remove(const K &key);
+	//! Saves all of the given datasets in the store in a single transaction
+	template<typename T>
+	void saveAll(const QList<T> &values);
+	//! Removes all datasets with the given keys for the given type in a single transaction
+	template<typename T>
+	int removeAll(const QStringList &keys);
+	//! @copybrief DataStore::removeAll(const QStringList &)
+	template<typename T, typename K>
+	int removeAll(const QList<K> &keys);
 	//! Loads the dataset with the given key for the given type into the existing object by updating it's properties
 	template<typename T>
 	void update(T object) const;
 	//! Searches the store for datasets of the given type where the key matches the query
 	template<typename T>
 	QList<T> search(const QString &query, SearchMode mode = RegexpMode) const;
+	//! Searches the store for datasets of the given type where the key matches the query, returning only one page of the results
+	template<typename T>
+	QList<T> search(const QString &query, SearchMode mode, int offset, int limit) const;
+	//! Finds all datasets of the given type where the indexed property equals the value
+	template<typename T>
+	QList<T> findBy(const QString &property, const QVariant &value) const;
+	//! Finds all datasets of the given type where the indexed property lies within the range
+	template<typename T>
+	QList<T> findBy(const QString &property, const QVariant &from, const QVariant &to) const;
+	//! Searches the full text index of the given type and returns the keys of the matching datasets, best matches first
+	template<typename T>
+	QStringList searchText(const QString &query, int limit = -1) const;
+	/*! @copybrief DataStore::searchText(const QString &, int) const
+	 * @tparam K The type of the key to be returned as list
+	 * @copydetails DataStore::searchText(const QString &, int) const
+	 * @note The given type K must be convertible from a QString
+	 */
+	template<typename T, typename K>
+	QList<K> searchText(const QString &query, int limit = -1) const;
 	//! Iterates over all existing datasets of the given types
 	template<typename T>
 	void iterate(const std::function<bool(T)> &iterator, bool skipBroken = false) const;
 	//! Removes all datasets of the given type from the store
 	template<typename T>
 	void clear();
+	//! Limits the change signals of this store to the given type, and optionally to keys with the given prefix
+	template<typename T>
+	void subscribe(const QString &keyPrefix = {});
+	//! Stops reporting changes of the given type
+	template<typename T>
+	void unsubscribe();
+	//! Loads the dataset with the given key for the given type on the I/O threads of the setup
+	template<typename T>
+	QFuture<T> loadAsync(const QString &key) const;
+	//! Loads all existing datasets for the given type on the I/O threads of the setup
+	template<typename T>
+	QFuture<T> loadAllAsync() const;
+	//! Saves the given dataset in the store on the I/O threads of the setup
+	template<typename T>
+	QFuture<void> saveAsync(const T &value);
+	//! Removes the dataset with the given key for the given type on the I/O threads of the setup
+	template<typename T>
+	QFuture<bool> removeAsync(const QString &key);
+	//! Searches the store for datasets of the given type on the I/O threads of the setup
+	template<typename T>
+	QFuture<T> searchAsync(const QString &query, SearchMode mode = RegexpMode) const;
 
 Q_SIGNALS:
 	//! Is emitted whenever a dataset has been changed
 	void dataChanged(int metaTypeId, const QString &key, bool deleted, QPrivateSignal);
+	//! Is emitted once for a group of datasets of the same type that have been changed together
+	QT_DATASYNC_REVISION_3 void dataChangedBatch(int metaTypeId, const QStringList &keys, bool deleted, QPrivateSignal);
 	//! Is emitted when a datatypes has been cleared
 	Q_DECL_DEPRECATED void dataCleared(int metaTypeId, QPrivateSignal);
 	//! Is emitted when the store is resetted due to an account reset
@@ -150,6 +238,8 @@ protected:
 
 private:
 	QScopedPointer<DataStorePrivate> d;
+
+	void runAsync(int metaTypeId, bool exclusive, QFutureInterfaceBase futureInterface, const std::function<void(DataStore*)> &task) const;
 };
 
 
@@ -263,6 +353,13 @@ QList<K> DataStore::keys() const
 	return rList;
 }
 
+template<typename T>
+QStringList DataStore::keys(const QString &afterKey, int limit, bool reverse) const
+{
+	QTDATASYNC_STORE_ASSERT(T);
+	return keys(qMetaTypeId<T>(), afterKey, limit, reverse);
+}
+
 template<typename T>
 QList<T> DataStore::loadAll() const
 {
@@ -322,6 +419,35 @@ bool DataStore::remove(const K &key)
 	return remove(qMetaTypeId<T>(), QVariant::fromValue(key));
 }
 
+template<typename T>
+void DataStore::saveAll(const QList<T> &values)
+{
+	QTDATASYNC_STORE_ASSERT(T);
+	QVariantList vList;
+	vList.reserve(values.size());
+	for(const auto &value : values)
+		vList.append(QVariant::fromValue(value));
+	saveAll(qMetaTypeId<T>(), vList);
+}
+
+template<typename T>
+int DataStore::removeAll(const QStringList &keys)
+{
+	QTDATASYNC_STORE_ASSERT(T);
+	return removeAll(qMetaTypeId<T>(), keys);
+}
+
+template<typename T, typename K>
+int DataStore::removeAll(const QList<K> &keys)
+{
+	QTDATASYNC_STORE_ASSERT(T);
+	QStringList sList;
+	sList.reserve(keys.size());
+	for(const auto &key : keys)
+		sList.append(QVariant::fromValue(key).toString());
+	return removeAll(qMetaTypeId<T>(), sList);
+}
+
 template<typename T>
 void DataStore::update(T object) const
 {
@@ -339,6 +465,53 @@ QList<T> DataStore::search(const QString &query, SearchMode mode) const
 	return rList;
 }
 
+template<typename T>
+QList<T> DataStore::search(const QString &query, SearchMode mode, int offset, int limit) const
+{
+	QTDATASYNC_STORE_ASSERT(T);
+	QList<T> rList;
+	for(auto v : search(qMetaTypeId<T>(), query, mode, offset, limit))
+		rList.append(v.template value<T>());
+	return rList;
+}
+
+template<typename T>
+QList<T> DataStore::findBy(const QString &property, const QVariant &value) const
+{
+	QTDATASYNC_STORE_ASSERT(T);
+	QList<T> rList;
+	for(auto v : findBy(qMetaTypeId<T>(), property, value))
+		rList.append(v.template value<T>());
+	return rList;
+}
+
+template<typename T>
+QList<T> DataStore::findBy(const QString &property, const QVariant &from, const QVariant &to) const
+{
+	QTDATASYNC_STORE_ASSERT(T);
+	QList<T> rList;
+	for(auto v : findBy(qMetaTypeId<T>(), property, from, to))
+		rList.append(v.template value<T>());
+	return rList;
+}
+
+template<typename T>
+QStringList DataStore::searchText(const QString &query, int limit) const
+{
+	QTDATASYNC_STORE_ASSERT(T);
+	return searchText(qMetaTypeId<T>(), query, limit);
+}
+
+template<typename T, typename K>
+QList<K> DataStore::searchText(const QString &query, int limit) const
+{
+	QTDATASYNC_STORE_ASSERT(T);
+	QList<K> rList;
+	for(auto k : searchText<T>(query, limit))
+		rList.append(QVariant(k).template value<K>());
+	return rList;
+}
+
 template<typename T>
 void DataStore::iterate(const std::function<bool (T)> &iterator, bool skipBroken) const
 {
@@ -355,6 +528,76 @@ void DataStore::clear()
 	clear(qMetaTypeId<T>());
 }
 
+template<typename T>
+void DataStore::subscribe(const QString &keyPrefix)
+{
+	QTDATASYNC_STORE_ASSERT(T);
+	subscribe(qMetaTypeId<T>(), keyPrefix);
+}
+
+template<typename T>
+void DataStore::unsubscribe()
+{
+	QTDATASYNC_STORE_ASSERT(T);
+	unsubscribe(qMetaTypeId<T>());
+}
+
+template<typename T>
+QFuture<T> DataStore::loadAsync(const QString &key) const
+{
+	QTDATASYNC_STORE_ASSERT(T);
+	QFutureInterface<T> futureInterface;
+	auto thread = QThread::currentThread();
+	runAsync(qMetaTypeId<T>(), false, futureInterface, [futureInterface, key, thread](DataStore *store) mutable {
+		futureInterface.reportResult(__helpertypes::move_to_thread(store->load<T>(key), thread));
+	});
+	return futureInterface.future();
+}
+
+template<typename T>
+QFuture<T> DataStore::loadAllAsync() const
+{
+	QTDATASYNC_STORE_ASSERT(T);
+	QFutureInterface<T> futureInterface;
+	auto thread = QThread::currentThread();
+	runAsync(qMetaTypeId<T>(), false, futureInterface, [futureInterface, thread](DataStore *store) mutable {
+		QVector<T> results;
+		for(auto value : store->loadAll<T>())
+			results.append(__helpertypes::move_to_thread(value, thread));
+		futureInterface.reportResults(results);
+	});
+	return futureInterface.future();
+}
+
+template<typename T>
+QFuture<void> DataStore::saveAsync(const T &value)
+{
+	QTDATASYNC_STORE_ASSERT(T);
+	return saveAsync(qMetaTypeId<T>(), QVariant::fromValue(value));
+}
+
+template<typename T>
+QFuture<bool> DataStore::removeAsync(const QString &key)
+{
+	QTDATASYNC_STORE_ASSERT(T);
+	return removeAsync(qMetaTypeId<T>(), key);
+}
+
+template<typename T>
+QFuture<T> DataStore::searchAsync(const QString &query, SearchMode mode) const
+{
+	QTDATASYNC_STORE_ASSERT(T);
+	QFutureInterface<T> futureInterface;
+	auto thread = QThread::currentThread();
+	runAsync(qMetaTypeId<T>(), false, futureInterface, [futureInterface, query, mode, thread](DataStore *store) mutable {
+		QVector<T> results;
+		for(auto value : store->search<T>(query, mode))
+			results.append(__helpertypes::move_to_thread(value, thread));
+		futureInterface.reportResults(results);
+	});
+	return futureInterface.future();
+}
+
 }
 
 #endif // QTDATASYNC_DATASTORE_H
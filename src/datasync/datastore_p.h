@@ -17,7 +17,10 @@ class DataStorePrivate
 public:
 	DataStorePrivate(DataStore *q, const QString &setupName);
 
+	static QVariant moveToThread(QVariant value, QThread *thread);
+
 	QByteArray typeName(int metaTypeId) const;
+	QPair<QString, QJsonObject> serialize(int metaTypeId, const QByteArray &typeName, QVariant value) const;
 
 	Defaults defaults;
 	Logger *logger;
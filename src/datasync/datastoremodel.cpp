@@ -33,8 +33,8 @@ DataStoreModel::DataStoreModel(QObject *parent, void *):
 void DataStoreModel::initStore(DataStore *store)
 {
 	d->store = store;
-	QObject::connect(d->store, &DataStore::dataChanged,
-					 this, &DataStoreModel::storeChanged);
+	QObject::connect(d->store, &DataStore::dataChangedBatch,
+					 this, &DataStoreModel::storeChangedBatch);
 	QObject::connect(d->store, &DataStore::dataResetted,
 					 this, &DataStoreModel::storeResetted);
 }
@@ -97,7 +97,7 @@ bool DataStoreModel::canFetchMore(const QModelIndex &parent) const
 	if(parent.isValid())
 		return false;
 	else
-		return d->dataHash.size() < d->keyList.size();
+		return d->dataHash.size() < d->keyList.size() || !d->keysComplete;
 }
 
 void DataStoreModel::fetchMore(const QModelIndex &parent)
@@ -107,19 +107,22 @@ void DataStoreModel::fetchMore(const QModelIndex &parent)
 	if(canFetchMore(parent)) {
 		d->isFetching = true;
 		try {
-			//load 100 at once
+			//keys are enumerated page by page as well
 			auto offset = d->dataHash.size();
-			auto max = qMin(offset + 100, d->keyList.size());
-			QVariantHash loadData;
+			if(offset == d->keyList.size())
+				d->fetchKeys();
+			auto max = qMin(offset + DataStoreModelPrivate::PageSize, d->keyList.size());
+			if(max > offset) { //the last key page might have been empty
+				QVariantHash loadData;
+				for(auto i = offset; i < max; i++) {
+					auto key = d->keyList.value(i);
+					loadData.insert(key, d->store->load(d->type, key));
+				}
 
-			for(auto i = offset; i < max; i++) {
-				auto key = d->keyList.value(i);
-				loadData.insert(key, d->store->load(d->type, key));
+				beginInsertRows(parent, offset, max - 1);
+				d->dataHash.unite(loadData);//no duplicates thanks to logic
+				endInsertRows();
 			}
-
-			beginInsertRows(parent, offset, max - 1);
-			d->dataHash.unite(loadData);//no duplicates thanks to logic
-			endInsertRows();
 		} catch(QException &e) {
 			emit storeError(e, {});
 		}
@@ -266,24 +269,23 @@ void DataStoreModel::setTypeId(int typeId, bool resetColumns)
 	auto flags = QMetaType::typeFlags(typeId);
 	if(flags.testFlag(QMetaType::IsGadget) ||
 	   flags.testFlag(QMetaType::PointerToQObject)) {
+		//a store owned by the model only needs to report changes of the shown type
+		if(d->store->parent() == this) {
+			if(d->type != QMetaType::UnknownType)
+				d->store->unsubscribe(d->type);
+			d->store->subscribe(typeId);
+		}
 		d->type = typeId;
 		emit typeIdChanged(typeId, {});
 
 		beginResetModel();
 		d->isObject = flags.testFlag(QMetaType::PointerToQObject);
-		d->keyList.clear();
+		d->resetKeys();
 		if(resetColumns)
 			clearColumns();
 		d->clearHashObjects();
 		d->createRoleNames();
-
-		try {
-			d->keyList = d->store->keys(typeId);
-			endResetModel();
-		} catch(...) {
-			endResetModel();
-			throw;
-		}
+		endResetModel();
 	} else
 		throw InvalidDataException(d->store->d->defaults, QMetaType::typeName(typeId), QStringLiteral("Type is neither a gadget nor a pointer to an object"));
 }
@@ -300,15 +302,9 @@ void DataStoreModel::setEditable(bool editable)
 void DataStoreModel::reload()
 {
 	beginResetModel();
-	d->keyList.clear();
+	d->resetKeys();
 	d->clearHashObjects();
-	try {
-		d->keyList = d->store->keys(d->type);
-		endResetModel();
-	} catch(QException &e) {
-		endResetModel();
-		emit storeError(e, {});
-	}
+	endResetModel();
 }
 
 void DataStoreModel::storeChanged(int metaTypeId, const QString &key, bool wasDeleted)
@@ -343,7 +339,7 @@ void DataStoreModel::storeChanged(int metaTypeId, const QString &key, bool wasDe
 					emit storeError(e, {});
 				}
 			}
-		} else { //key unknown -> append it
+		} else if(!d->isPending(key)) { //key unknown -> append it, unless a later key page contains it
 			if(d->keyList.size() == d->dataHash.size()) { //already fully loaded -> needs to be loaded as well
 				d->keyList.append(key);
 				fetchMore(QModelIndex());//simply call fetch more does the loading
@@ -353,16 +349,99 @@ void DataStoreModel::storeChanged(int metaTypeId, const QString &key, bool wasDe
 	}
 }
 
+void DataStoreModel::storeChangedBatch(int metaTypeId, const QStringList &keys, bool wasDeleted)
+{
+	if(metaTypeId != d->type || keys.isEmpty())
+		return;
+	if(keys.size() == 1) {
+		storeChanged(metaTypeId, keys.first(), wasDeleted);
+		return;
+	}
+
+	if(wasDeleted) {
+		//walk backwards, so removing a range of rows does not move the ones still to be checked
+		const auto removedKeys = keys.toSet();
+		const auto fetchedRows = d->dataHash.size();
+		auto row = d->keyList.size() - 1;
+		while(row >= 0) {
+			if(!removedKeys.contains(d->keyList[row])) {
+				row--;
+				continue;
+			}
+
+			//one range of adjacent removed rows, either all fetched or all not fetched yet
+			const auto lastRow = row;
+			const auto isFetched = lastRow < fetchedRows;
+			while(row > 0 &&
+				  removedKeys.contains(d->keyList[row - 1]) &&
+				  (row - 1 < fetchedRows) == isFetched)
+				row--;
+
+			if(isFetched) {
+				beginRemoveRows(QModelIndex(), row, lastRow);
+				for(auto i = row; i <= lastRow; i++)
+					d->deleteObject(d->dataHash.take(d->keyList[i]));
+				d->keyList.erase(d->keyList.begin() + row, d->keyList.begin() + lastRow + 1);
+				endRemoveRows();
+			} else //not fetched yet -> no signals needed
+				d->keyList.erase(d->keyList.begin() + row, d->keyList.begin() + lastRow + 1);
+			row--;
+		}
+	} else {
+		QHash<QString, int> rows;
+		rows.reserve(d->keyList.size());
+		for(auto i = 0; i < d->keyList.size(); i++)
+			rows.insert(d->keyList[i], i);
+
+		const auto wasFullyLoaded = d->keyList.size() == d->dataHash.size();
+		auto firstRow = d->keyList.size();
+		auto lastRow = -1;
+		auto appended = false;
+		for(const auto &key : keys) {
+			auto row = rows.value(key, -1);
+			if(row == -1) { //key unknown -> append it, unless a later key page contains it
+				if(d->isPending(key))
+					continue;
+				rows.insert(key, d->keyList.size());
+				d->keyList.append(key);
+				appended = true;
+			} else if(row < d->dataHash.size()) { //only reload if already fetched
+				try {
+					if(d->isObject) {
+						auto obj = d->dataHash.value(key).value<QObject*>();
+						d->store->update(d->type, obj);
+					} else
+						d->dataHash.insert(key, d->store->load(d->type, key));
+					firstRow = qMin(firstRow, row);
+					lastRow = qMax(lastRow, row);
+				} catch(QException &e) {
+					emit storeError(e, {});
+				}
+			}
+		}
+
+		//one update for the whole range of changed rows
+		if(lastRow != -1) {
+			emit dataChanged(index(firstRow, 0),
+							 index(lastRow, (d->columns.isEmpty() ? 0 : d->columns.size() - 1)));
+		}
+		if(appended && wasFullyLoaded)
+			fetchMore(QModelIndex());
+	}
+}
+
 void DataStoreModel::storeResetted()
 {
 	beginResetModel();
-	d->keyList.clear();
+	d->resetKeys();
 	d->clearHashObjects();
 	endResetModel();
 }
 
 // ------------- Private Implementation -------------
 
+const int DataStoreModelPrivate::PageSize = 100;
+
 DataStoreModelPrivate::DataStoreModelPrivate(DataStoreModel *q_ptr) :
 	q{q_ptr}
 {}
@@ -372,6 +451,33 @@ QStringList DataStoreModelPrivate::activeKeys()
 	return keyList.mid(0, dataHash.size());
 }
 
+void DataStoreModelPrivate::resetKeys()
+{
+	keyList.clear();
+	pageKey.clear();
+	keysComplete = false;
+}
+
+void DataStoreModelPrivate::fetchKeys()
+{
+	if(keysComplete)
+		return;
+	const auto page = store->keys(type, pageKey, PageSize);
+	keyList.append(page);
+	if(!page.isEmpty())
+		pageKey = page.last();
+	//the maintained count saves the query for an empty last page
+	keysComplete = page.size() < PageSize ||
+			static_cast<quint64>(keyList.size()) >= static_cast<quint64>(store->count(type));
+}
+
+bool DataStoreModelPrivate::isPending(const QString &key) const
+{
+	//keys are enumerated in the byte order of the database
+	return !keysComplete &&
+			(pageKey.isNull() || key.toUtf8() > pageKey.toUtf8());
+}
+
 void DataStoreModelPrivate::createRoleNames()
 {
 	roleNames.clear();
@@ -130,6 +130,7 @@ protected:
 
 private Q_SLOTS:
 	void storeChanged(int metaTypeId, const QString &key, bool wasDeleted);
+	void storeChangedBatch(int metaTypeId, const QStringList &keys, bool wasDeleted);
 	void storeResetted();
 
 private:
@@ -10,6 +10,8 @@ namespace QtDataSync {
 class DataStoreModelPrivate
 {
 public:
+	static const int PageSize;
+
 	DataStoreModelPrivate(DataStoreModel *q_ptr);
 
 	DataStoreModel *q;
@@ -22,6 +24,8 @@ public:
 
 	QStringList keyList;
 	QVariantHash dataHash;
+	QString pageKey; //last key of the paged enumeration, null before the first page
+	bool keysComplete = false;
 
 	QStringList columns;
 	QHash<int, QHash<int, QByteArray>> roleMapping; //column -> (role -> property)
@@ -29,6 +33,9 @@ public:
 	bool isFetching = false;
 
 	QStringList activeKeys();
+	void resetKeys();
+	void fetchKeys();
+	bool isPending(const QString &key) const;
 
 	void createRoleNames();
 	void clearHashObjects();
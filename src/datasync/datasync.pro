@@ -1,6 +1,7 @@
 TARGET = QtDataSync
 
 QT = core jsonserializer sql websockets scxml remoteobjects
+QT_PRIVATE += concurrent
 android: QT += androidextras
 
 HEADERS += \
@@ -14,6 +15,7 @@ HEADERS += \
 	setup.h \
 	exception.h \
 	objectkey.h \
+	cachestatistics.h \
 	datastore.h \
 	datastore_p.h \
 	qtdatasync_helpertypes.h \
@@ -37,6 +39,9 @@ HEADERS += \
 	userexchangemanager.h \
 	userexchangemanager_p.h \
 	emitteradapter_p.h \
+	concurrentcache_p.h \
+	sharedcache_p.h \
+	asyncstore_p.h \
 	changeemitter_p.h \
 	signal_private_connect_p.h \
 	migrationhelper.h \
@@ -55,6 +60,7 @@ SOURCES += \
 	exception.cpp \
 	qtdatasync_global.cpp \
 	objectkey.cpp \
+	cachestatistics.cpp \
 	datastore.cpp \
 	datatypestore.cpp \
 	datastoremodel.cpp \
@@ -73,6 +79,8 @@ SOURCES += \
 	accountmanager_p.cpp \
 	userexchangemanager.cpp \
 	emitteradapter.cpp \
+	sharedcache.cpp \
+	asyncstore.cpp \
 	changeemitter.cpp \
 	migrationhelper.cpp \
 	remoteconfig.cpp \
@@ -63,6 +63,10 @@ public:
 	void save(const TType &value);
 	//! @copybrief DataStore::remove(const K &)
 	bool remove(const TKey &key);
+	//! @copybrief DataStore::saveAll(const QList<T> &)
+	void saveAll(const QList<TType> &values);
+	//! @copybrief DataStore::removeAll(const QList<K> &)
+	int removeAll(const QList<TKey> &keys);
 	//! @copybrief DataStore::update(T) const
 	template <typename TX = TType>
 	void update(std::enable_if_t<__helpertypes::is_object<TX>::value, TX> object) const;
@@ -72,6 +76,16 @@ public:
 	void iterate(const std::function<bool(TType)> &iterator, bool skipBroken = false);
 	//! @copybrief DataStore::clear()
 	void clear();
+	//! @copybrief DataStore::loadAsync(const QString &) const
+	QFuture<TType> loadAsync(const TKey &key) const;
+	//! @copybrief DataStore::loadAllAsync() const
+	QFuture<TType> loadAllAsync() const;
+	//! @copybrief DataStore::saveAsync(const T &)
+	QFuture<void> saveAsync(const TType &value);
+	//! @copybrief DataStore::removeAsync(const QString &)
+	QFuture<bool> removeAsync(const TKey &key);
+	//! @copybrief DataStore::searchAsync(const QString &, SearchMode) const
+	QFuture<TType> searchAsync(const QString &query, DataStore::SearchMode mode = DataStore::RegexpMode) const;
 
 	//! Shortcut to convert a string to the stores key type
 	static TKey toKey(const QString &key);
@@ -135,6 +149,7 @@ private:
 	QHash<TKey, TType> _data;
 
 	void evalDataChanged(int metaTypeId, const QString &key, bool wasDeleted);
+	void evalDataChangedBatch(int metaTypeId, const QStringList &keys, bool wasDeleted);
 	void evalDataResetted();
 };
 
@@ -191,6 +206,7 @@ private:
 	QHash<TKey, TType*> _data;
 
 	void evalDataChanged(int metaTypeId, const QString &key, bool wasDeleted);
+	void evalDataChangedBatch(int metaTypeId, const QStringList &keys, bool wasDeleted);
 	void evalDataResetted();
 };
 
@@ -206,6 +222,7 @@ DataTypeStore<TType, TKey>::DataTypeStore(const QString &setupName, QObject *par
 	DataTypeStore{new DataStore(setupName, nullptr), parent}
 {
 	_store->setParent(this);
+	_store->subscribe<TType>(); //the store is exclusive, so only changes of this type are needed
 }
 
 template <typename TType, typename TKey>
@@ -267,6 +284,18 @@ bool DataTypeStore<TType, TKey>::remove(const TKey &key)
 	return _store->remove<TType>(key);
 }
 
+template <typename TType, typename TKey>
+void DataTypeStore<TType, TKey>::saveAll(const QList<TType> &values)
+{
+	_store->saveAll(values);
+}
+
+template <typename TType, typename TKey>
+int DataTypeStore<TType, TKey>::removeAll(const QList<TKey> &keys)
+{
+	return _store->removeAll<TType>(keys);
+}
+
 template<typename TType, typename TKey>
 template <typename TX>
 void DataTypeStore<TType, TKey>::update(std::enable_if_t<__helpertypes::is_object<TX>::value, TX> object) const
@@ -292,6 +321,36 @@ void DataTypeStore<TType, TKey>::clear()
 	_store->clear<TType>();
 }
 
+template<typename TType, typename TKey>
+QFuture<TType> DataTypeStore<TType, TKey>::loadAsync(const TKey &key) const
+{
+	return _store->loadAsync<TType>(QVariant::fromValue(key).toString());
+}
+
+template<typename TType, typename TKey>
+QFuture<TType> DataTypeStore<TType, TKey>::loadAllAsync() const
+{
+	return _store->loadAllAsync<TType>();
+}
+
+template<typename TType, typename TKey>
+QFuture<void> DataTypeStore<TType, TKey>::saveAsync(const TType &value)
+{
+	return _store->saveAsync(value);
+}
+
+template<typename TType, typename TKey>
+QFuture<bool> DataTypeStore<TType, TKey>::removeAsync(const TKey &key)
+{
+	return _store->removeAsync<TType>(QVariant::fromValue(key).toString());
+}
+
+template<typename TType, typename TKey>
+QFuture<TType> DataTypeStore<TType, TKey>::searchAsync(const QString &query, DataStore::SearchMode mode) const
+{
+	return _store->searchAsync<TType>(query, mode);
+}
+
 template<typename TType, typename TKey>
 TKey DataTypeStore<TType, TKey>::toKey(const QString &key)
 {
@@ -326,6 +385,7 @@ CachingDataTypeStore<TType, TKey>::CachingDataTypeStore(const QString &setupName
 	CachingDataTypeStore{new DataStore(setupName, nullptr), parent}
 {
 	_store->setParent(this);
+	_store->subscribe<TType>();
 }
 
 template <typename TType, typename TKey>
@@ -333,8 +393,8 @@ CachingDataTypeStore<TType, TKey>::CachingDataTypeStore(DataStore *store, QObjec
 	DataTypeStoreBase{parent},
 	_store{store}
 {
-	connect(_store, &DataStore::dataChanged,
-			this, &CachingDataTypeStore::evalDataChanged);
+	connect(_store, &DataStore::dataChangedBatch,
+			this, &CachingDataTypeStore::evalDataChangedBatch);
 	connect(_store, &DataStore::dataResetted,
 			this, &CachingDataTypeStore::evalDataResetted);
 
@@ -448,6 +508,15 @@ void CachingDataTypeStore<TType, TKey>::evalDataChanged(int metaTypeId, const QS
 	}
 }
 
+template <typename TType, typename TKey>
+void CachingDataTypeStore<TType, TKey>::evalDataChangedBatch(int metaTypeId, const QStringList &keys, bool wasDeleted)
+{
+	if(metaTypeId != qMetaTypeId<TType>())
+		return;
+	for(const auto &key : keys)
+		evalDataChanged(metaTypeId, key, wasDeleted);
+}
+
 template <typename TType, typename TKey>
 void CachingDataTypeStore<TType, TKey>::evalDataResetted()
 {
@@ -467,6 +536,7 @@ CachingDataTypeStore<TType*, TKey>::CachingDataTypeStore(const QString &setupNam
 	CachingDataTypeStore{new DataStore(setupName, nullptr), parent}
 {
 	_store->setParent(this);
+	_store->subscribe<TType*>();
 }
 
 template <typename TType, typename TKey>
@@ -475,8 +545,8 @@ CachingDataTypeStore<TType*, TKey>::CachingDataTypeStore(DataStore *store, QObje
 	_store{store}
 
 {
-	connect(_store, &DataStore::dataChanged,
-			this, &CachingDataTypeStore::evalDataChanged);
+	connect(_store, &DataStore::dataChangedBatch,
+			this, &CachingDataTypeStore::evalDataChangedBatch);
 	connect(_store, &DataStore::dataResetted,
 			this, &CachingDataTypeStore::evalDataResetted);
 
@@ -609,6 +679,15 @@ void CachingDataTypeStore<TType*, TKey>::evalDataChanged(int metaTypeId, const Q
 	}
 }
 
+template <typename TType, typename TKey>
+void CachingDataTypeStore<TType*, TKey>::evalDataChangedBatch(int metaTypeId, const QStringList &keys, bool wasDeleted)
+{
+	if(metaTypeId != qMetaTypeId<TType*>())
+		return;
+	for(const auto &key : keys)
+		evalDataChanged(metaTypeId, key, wasDeleted);
+}
+
 template <typename TType, typename TKey>
 void CachingDataTypeStore<TType*, TKey>::evalDataResetted()
 {
@@ -150,6 +150,22 @@ QVariant Defaults::cacheHandle() const
 	return QVariant::fromValue(d->cacheInfo);
 }
 
+AsyncStore *Defaults::asyncStore() const
+{
+	QMutexLocker _(&d->asyncMutex);
+	if(!d->asyncStore)
+		d->asyncStore.reset(new AsyncStore{d->setupName});
+	return d->asyncStore.data();
+}
+
+CacheStatistics Defaults::cacheStatistics() const
+{
+	if(d->cacheInfo)
+		return d->cacheInfo->statistics();
+	else
+		return {};
+}
+
 // ------------- DatabaseRef -------------
 
 DatabaseRef::DatabaseRef() :
@@ -217,6 +233,7 @@ void DefaultsPrivate::createDefaults(const QString &setupName, bool isPassive, c
 	//following must be done after the constructor
 	if(d->resolver)
 		d->resolver->setDefaults(d);
+	d->createSharedCache(isPassive);
 
 	//final steps (must be last things done): move to the correct thread and make passive if needed
 	if(d->thread() != qApp->thread())
@@ -234,6 +251,17 @@ void DefaultsPrivate::createDefaults(const QString &setupName, bool isPassive, c
 
 void DefaultsPrivate::removeDefaults(const QString &setupName)
 {
+	//the I/O threads hold references to the defaults and must be stopped first - without the lock, as they need it to start
+	{
+		QSharedPointer<DefaultsPrivate> d;
+		{
+			QMutexLocker _(&setupDefaultsMutex);
+			d = setupDefaults.value(setupName);
+		}
+		if(d)
+			d->stopAsyncStore();
+	}
+
 	QMutexLocker _(&setupDefaultsMutex);
 	QWeakPointer<DefaultsPrivate> weakRef;
 	{
@@ -260,6 +288,15 @@ QSharedPointer<DefaultsPrivate> DefaultsPrivate::obtainDefaults(const QString &s
 		throw SetupDoesNotExistException(setupName);
 }
 
+void DefaultsPrivate::reportMemoryPressure(bool critical)
+{
+	QMutexLocker _(&setupDefaultsMutex);
+	for(const auto &d : qAsConst(setupDefaults)) {
+		if(d->cacheInfo)
+			d->cacheInfo->trim(critical);
+	}
+}
+
 DefaultsPrivate::DefaultsPrivate(QString setupName, QDir storageDir, QUrl roAddress, QHash<Defaults::PropertyKey, QVariant> properties, QJsonSerializer *serializer, ConflictResolver *resolver) :
 	setupName{std::move(setupName)},
 	storageDir{std::move(storageDir)},
@@ -288,7 +325,9 @@ DefaultsPrivate::DefaultsPrivate(QString setupName, QDir storageDir, QUrl roAddr
 	//create cache
 	auto maxSize = properties.value(Defaults::CacheSize).toInt();
 	if(maxSize > 0)
-		cacheInfo = QSharedPointer<EmitterAdapter::CacheInfo>::create(maxSize);
+		cacheInfo = QSharedPointer<EmitterAdapter::CacheInfo>::create(maxSize,
+																	  properties.value(Defaults::TypedCacheSize).toInt(),
+																	  properties.value(Defaults::MinimumCacheSize).toInt());
 }
 
 DefaultsPrivate::~DefaultsPrivate()
@@ -303,8 +342,10 @@ QSqlDatabase DefaultsPrivate::acquireDatabase()
 {
 	auto name = DefaultsPrivate::DatabaseName
 				.arg(setupName, QString::number(reinterpret_cast<quint64>(QThread::currentThread()), 16));
-	if((dbRefHash.localData()[setupName])++ == 0) {
+	auto &holder = dbRefHash.localData();
+	if((holder[setupName])++ == 0) {
 		logDebug() << "Acquiring database for thread" << QThread::currentThread();
+		holder.statements.insert(name, {});
 		auto database = QSqlDatabase::addDatabase(QStringLiteral("QSQLITE"), name);
 		database.setDatabaseName(storageDir.absoluteFilePath(QStringLiteral("store.db")));
 		database.setConnectOptions(QStringLiteral("QSQLITE_BUSY_TIMEOUT=30000;"
@@ -340,6 +381,27 @@ QSqlDatabase DefaultsPrivate::acquireDatabase()
 		QSqlQuery pragmaForeignKeys(database);
 		if(!pragmaForeignKeys.exec(QStringLiteral("PRAGMA foreign_keys = ON")))
 			logWarning() << "Failed to enable foreign_keys support";
+
+		//use a write ahead log, so readers never wait for the (sync) writer
+		QSqlQuery pragmaJournalMode(database);
+		if(!pragmaJournalMode.exec(QStringLiteral("PRAGMA journal_mode = WAL")) ||
+		   !pragmaJournalMode.first() ||
+		   pragmaJournalMode.value(0).toString().toLower() != QStringLiteral("wal"))
+			logWarning() << "Failed to enable WAL journal mode. Readers may be blocked by writes";
+
+		//apply the tuning pragmas - they are per connection
+		QSqlQuery pragmaSynchronous(database);
+		if(!pragmaSynchronous.exec(QStringLiteral("PRAGMA synchronous = %1")
+								   .arg(static_cast<int>(properties.value(Defaults::DatabaseSynchronous).value<Setup::SynchronousMode>()))))
+			logWarning() << "Failed to set synchronous mode with error:" << pragmaSynchronous.lastError().text();
+		QSqlQuery pragmaMmapSize(database);
+		if(!pragmaMmapSize.exec(QStringLiteral("PRAGMA mmap_size = %1")
+								.arg(properties.value(Defaults::DatabaseMmapSize).toLongLong())))
+			logWarning() << "Failed to set mmap size with error:" << pragmaMmapSize.lastError().text();
+		QSqlQuery pragmaCacheSize(database);
+		if(!pragmaCacheSize.exec(QStringLiteral("PRAGMA cache_size = %1")
+								 .arg(properties.value(Defaults::DatabaseCacheSize).toInt())))
+			logWarning() << "Failed to set cache size with error:" << pragmaCacheSize.lastError().text();
 	}
 
 	return QSqlDatabase::database(name);
@@ -347,10 +409,36 @@ QSqlDatabase DefaultsPrivate::acquireDatabase()
 
 void DefaultsPrivate::releaseDatabase()
 {
-	if(--(dbRefHash.localData()[setupName]) == 0) {
+	auto &holder = dbRefHash.localData();
+	if(--(holder[setupName]) == 0) {
 		logDebug() << "Releasing database for thread" << QThread::currentThread();
-		releaseDatabaseImpl(setupName);
+		releaseDatabaseImpl(holder, setupName);
+	}
+}
+
+QSqlQuery DefaultsPrivate::takeStatement(const QSqlDatabase &database, const QString &statement)
+{
+	auto &holder = dbRefHash.localData();
+	auto cache = holder.statements.find(database.connectionName());
+	if(cache != holder.statements.end()) {
+		auto it = cache->find(statement);
+		if(it != cache->end()) {
+			//take it out while in use, so nested users of the same statement get their own
+			QSqlQuery query = *it;
+			cache->erase(it);
+			return query;
+		}
 	}
+	return QSqlQuery{database};
+}
+
+void DefaultsPrivate::returnStatement(const QString &connectionName, const QString &statement, const QSqlQuery &query)
+{
+	auto &holder = dbRefHash.localData();
+	auto cache = holder.statements.find(connectionName);
+	//only cache if the connection is still open
+	if(cache != holder.statements.end() && !cache->contains(statement))
+		cache->insert(statement, query);
 }
 
 QRemoteObjectNode *DefaultsPrivate::acquireNode()
@@ -398,10 +486,44 @@ void DefaultsPrivate::makePassive()
 	}
 }
 
-void DefaultsPrivate::releaseDatabaseImpl(const QString &name)
+void DefaultsPrivate::createSharedCache(bool isPassive)
+{
+	auto size = properties.value(Defaults::SharedCacheSize).toInt();
+	if(size <= 0 || !cacheInfo)
+		return;
+
+	//the primary owns the segment, passive setups only attach to it for reading
+	auto key = SharedCache::segmentKey(storageDir);
+	QString error;
+	if(isPassive) {
+		//the segment is attached lazily, as the primary might not have created it yet
+		cacheInfo->sharedKey = key;
+		if(cacheInfo->sharedCache())
+			logDebug() << "Using shared cache with" << cacheInfo->shared.load()->slotCount() << "slots";
+		else
+			logDebug() << "Shared cache not available yet, retrying on demand";
+	} else {
+		cacheInfo->shared.storeRelease(SharedCache::create(key, size, error));
+		if(cacheInfo->shared.load())
+			logDebug() << "Using shared cache with" << cacheInfo->shared.load()->slotCount() << "slots";
+		else
+			logWarning() << "Failed to set up the shared cache, continuing without it. Error:" << error;
+	}
+}
+
+void DefaultsPrivate::stopAsyncStore()
+{
+	QMutexLocker _(&asyncMutex);
+	if(asyncStore)
+		asyncStore->stop();
+}
+
+void DefaultsPrivate::releaseDatabaseImpl(DatabaseHolder &holder, const QString &name)
 {
 	auto dbName = DefaultsPrivate::DatabaseName
 				  .arg(name, QString::number(reinterpret_cast<quint64>(QThread::currentThread()), 16));
+	//cached statements must be finalized before the connection can be closed
+	holder.statements.remove(dbName);
 	QSqlDatabase::database(dbName).close();
 	QSqlDatabase::removeDatabase(dbName);
 }
@@ -417,7 +539,26 @@ DefaultsPrivate::DatabaseHolder::~DatabaseHolder()
 							 << "still has" << *it
 							 << "open database references in thread" << QThread::currentThread()
 							 << "on destruction of that thread! Database will be force-closed";
-		releaseDatabaseImpl(it.key());
+		releaseDatabaseImpl(*this, it.key());
+	}
+}
+
+// ------------- PRIVATE IMPLEMENTATION CachedQuery -------------
+
+CachedQuery::CachedQuery(const QSqlDatabase &database, const QString &statement) :
+	QSqlQuery{DefaultsPrivate::takeStatement(database, statement)},
+	_connectionName{database.connectionName()},
+	_statement{statement}
+{
+	if(lastQuery() != _statement) //not cached yet -> compile it once
+		_cacheable = prepare(_statement);
+}
+
+CachedQuery::~CachedQuery()
+{
+	if(_cacheable) {
+		finish();
+		DefaultsPrivate::returnStatement(_connectionName, _statement, *this);
 	}
 }
 
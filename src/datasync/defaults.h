@@ -22,6 +22,7 @@ namespace QtDataSync {
 class Logger;
 class Defaults;
 class EmitterAdapter;
+class AsyncStore;
 
 class DatabaseRefPrivate;
 //! A wrapper around QSqlDatabase to manage the connections
@@ -78,7 +79,15 @@ public:
 		CryptKeyParam, //!< @copybrief Setup::encryptionKeyParam
 		SymScheme, //!< @copybrief Setup::cipherScheme
 		SymKeyParam, //!< @copybrief Setup::cipherKeySize
-		EventLoggingMode //!< @copybrief Setup::eventLoggingMode
+		EventLoggingMode, //!< @copybrief Setup::eventLoggingMode
+		StorageMode, //!< @copybrief Setup::storageMode
+		DatabaseSynchronous, //!< @copybrief Setup::databaseSynchronous
+		DatabaseMmapSize, //!< @copybrief Setup::databaseMmapSize
+		DatabaseCacheSize, //!< @copybrief Setup::databaseCacheSize
+		TypedCacheSize, //!< @copybrief Setup::typedCacheSize
+		CacheWarmupCount, //!< @copybrief Setup::cacheWarmupCount
+		MinimumCacheSize, //!< @copybrief Setup::minimumCacheSize
+		SharedCacheSize //!< @copybrief Setup::sharedCacheSize
 	};
 	Q_ENUM(PropertyKey)
 
@@ -133,6 +142,10 @@ public:
 	EmitterAdapter *createEmitter(QObject *parent = nullptr) const;
 	//! @private
 	QVariant cacheHandle() const;
+	//! @private
+	AsyncStore *asyncStore() const;
+	//! Returns the current statistics of the data cache
+	CacheStatistics cacheStatistics() const;
 
 private:
 	QSharedPointer<DefaultsPrivate> d;
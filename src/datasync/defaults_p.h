@@ -5,6 +5,7 @@
 #include <QtCore/QThreadStorage>
 
 #include <QtSql/QSqlDatabase>
+#include <QtSql/QSqlQuery>
 
 #include <QtJsonSerializer/QJsonSerializer>
 
@@ -14,6 +15,7 @@
 #include "logger.h"
 #include "conflictresolver.h"
 #include "emitteradapter_p.h"
+#include "asyncstore_p.h"
 
 class ChangeEmitterReplica;
 
@@ -37,6 +39,23 @@ private:
 	QSqlDatabase _database;
 };
 
+//no export needed
+class CachedQuery : public QSqlQuery
+{
+	Q_DISABLE_COPY(CachedQuery)
+
+public:
+	//takes the already compiled statement of the connection, or prepares it
+	CachedQuery(const QSqlDatabase &database, const QString &statement);
+	//resets the statement and gives it back to the connection
+	~CachedQuery();
+
+private:
+	QString _connectionName;
+	QString _statement;
+	bool _cacheable = true;
+};
+
 //export needed for tests
 class Q_DATASYNC_EXPORT DefaultsPrivate : public QObject
 {
@@ -55,6 +74,7 @@ public:
 							   ConflictResolver *resolver);
 	static void removeDefaults(const QString &setupName);
 	static QSharedPointer<DefaultsPrivate> obtainDefaults(const QString &setupName);
+	static void reportMemoryPressure(bool critical);
 
 	DefaultsPrivate(QString setupName,
 					QDir storageDir,
@@ -67,6 +87,9 @@ public:
 	QSqlDatabase acquireDatabase();
 	void releaseDatabase();
 
+	static QSqlQuery takeStatement(const QSqlDatabase &database, const QString &statement);
+	static void returnStatement(const QString &connectionName, const QString &statement, const QSqlQuery &query);
+
 	QRemoteObjectNode *acquireNode();
 
 public Q_SLOTS:
@@ -80,13 +103,20 @@ private Q_SLOTS:
 	void makePassive();
 
 private:
-	static void releaseDatabaseImpl(const QString &name);
-
 	struct DatabaseHolder : public QHash<QString, quint64>
 	{
+		//idle prepared statements, per connection and statement text
+		QHash<QString, QHash<QString, QSqlQuery>> statements;
+
 		~DatabaseHolder();
 	};
 
+	static void releaseDatabaseImpl(DatabaseHolder &holder, const QString &name);
+
+	void stopAsyncStore();
+
+	void createSharedCache(bool isPassive);
+
 	static QMutex setupDefaultsMutex;
 	static QHash<QString, QSharedPointer<DefaultsPrivate>> setupDefaults;
 	static QThreadStorage<DatabaseHolder> dbRefHash;
@@ -104,6 +134,9 @@ private:
 
 	QSharedPointer<EmitterAdapter::CacheInfo> cacheInfo;
 
+	QMutex asyncMutex;
+	QScopedPointer<AsyncStore> asyncStore;
+
 	ChangeEmitterReplica *passiveEmitter = nullptr;
 };
 
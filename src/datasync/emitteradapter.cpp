@@ -1,17 +1,20 @@
 #include "emitteradapter_p.h"
 #include "changeemitter_p.h"
+
+#include <QtCore/QDateTime>
 using namespace QtDataSync;
 
 EmitterAdapter::EmitterAdapter(QObject *changeEmitter, QSharedPointer<CacheInfo> cacheInfo, QObject *origin) :
 	QObject{origin},
 	_isPrimary{changeEmitter->metaObject()->inherits(&ChangeEmitter::staticMetaObject)},
 	_emitterBackend{changeEmitter},
-	_cache{std::move(cacheInfo)}
+	_cache{std::move(cacheInfo)},
+	_filtered{false}
 {
 	if(_isPrimary) {
-		connect(_emitterBackend, SIGNAL(dataChanged(QObject*,QtDataSync::ObjectKey,bool)),
-				this, SLOT(dataChangedImpl(QObject*,QtDataSync::ObjectKey,bool)),
-				Qt::QueuedConnection);
+		//changes are not broadcasted, the emitter only dispatches them to interested adapters
+		_subscriptions = static_cast<ChangeEmitter*>(_emitterBackend)->subscriptions();
+		_subscriptions->add(this, origin);
 		connect(_emitterBackend, SIGNAL(dataResetted(QObject*)),
 				this, SLOT(dataResettedImpl(QObject*)),
 				Qt::QueuedConnection);
@@ -19,12 +22,21 @@ EmitterAdapter::EmitterAdapter(QObject *changeEmitter, QSharedPointer<CacheInfo>
 		connect(_emitterBackend, SIGNAL(remoteDataChanged(QtDataSync::ObjectKey,bool)),
 				this, SLOT(remoteDataChangedImpl(QtDataSync::ObjectKey,bool)),
 				Qt::QueuedConnection);
+		connect(_emitterBackend, SIGNAL(remoteDataChangedBatch(QByteArray,QStringList,bool)),
+				this, SLOT(remoteDataChangedBatchImpl(QByteArray,QStringList,bool)),
+				Qt::QueuedConnection);
 		connect(_emitterBackend, SIGNAL(remoteDataResetted()),
 				this, SLOT(remoteDataResettedImpl()),
 				Qt::QueuedConnection);
 	}
 }
 
+EmitterAdapter::~EmitterAdapter()
+{
+	if(_subscriptions)
+		_subscriptions->remove(this);
+}
+
 void EmitterAdapter::triggerChange(const ObjectKey &key, bool deleted, bool changed)
 {
 	if(_isPrimary) {
@@ -34,7 +46,8 @@ void EmitterAdapter::triggerChange(const ObjectKey &key, bool deleted, bool chan
 								  Q_ARG(QtDataSync::ObjectKey, key),
 								  Q_ARG(bool, deleted),
 								  Q_ARG(bool, changed));
-		emit dataChanged(key, deleted);//own change
+		flushChanges(); //older changes of other stores must arrive first
+		emitChanges(key.typeName, {key.id}, deleted);//own change
 	} else {
 		QMetaObject::invokeMethod(_emitterBackend, "triggerRemoteChange",
 								  Qt::QueuedConnection,
@@ -45,6 +58,29 @@ void EmitterAdapter::triggerChange(const ObjectKey &key, bool deleted, bool chan
 	}
 }
 
+void EmitterAdapter::triggerChange(const QByteArray &typeName, const QStringList &ids, bool deleted, bool changed)
+{
+	if(_isPrimary) {
+		QMetaObject::invokeMethod(_emitterBackend, "triggerChanges",
+								  Qt::QueuedConnection,
+								  Q_ARG(QObject*, parent()),
+								  Q_ARG(QByteArray, typeName),
+								  Q_ARG(QStringList, ids),
+								  Q_ARG(bool, deleted),
+								  Q_ARG(bool, changed));
+		flushChanges(); //older changes of other stores must arrive first
+		emitChanges(typeName, ids, deleted);//own change
+	} else {
+		QMetaObject::invokeMethod(_emitterBackend, "triggerRemoteChanges",
+								  Qt::QueuedConnection,
+								  Q_ARG(QByteArray, typeName),
+								  Q_ARG(QStringList, ids),
+								  Q_ARG(bool, deleted),
+								  Q_ARG(bool, changed));
+		//no change signal, because operating in passive setup
+	}
+}
+
 void EmitterAdapter::triggerClear(const QByteArray &typeName, const QStringList &ids)
 {
 	if(_isPrimary) {
@@ -53,8 +89,8 @@ void EmitterAdapter::triggerClear(const QByteArray &typeName, const QStringList
 								  Q_ARG(QObject*, parent()),
 								  Q_ARG(QByteArray, typeName),
 								  Q_ARG(QStringList, ids));
-		for(const auto &id : ids)
-			emit dataChanged({typeName, id}, true);
+		flushChanges(); //older changes of other stores must arrive first
+		emitChanges(typeName, ids, true);//own change
 	} else {
 		QMetaObject::invokeMethod(_emitterBackend, "triggerRemoteClear",
 								  Qt::QueuedConnection,
@@ -70,6 +106,7 @@ void EmitterAdapter::triggerReset()
 		QMetaObject::invokeMethod(_emitterBackend, "triggerReset",
 								  Qt::QueuedConnection,
 								  Q_ARG(QObject*, parent()));
+		flushChanges();
 		emit dataResetted();
 	} else {
 		QMetaObject::invokeMethod(_emitterBackend, "triggerRemoteReset",
@@ -84,13 +121,55 @@ void EmitterAdapter::triggerUpload()
 							  Qt::QueuedConnection);
 }
 
+void EmitterAdapter::subscribe(const QByteArray &typeName, const QString &keyPrefix)
+{
+	auto it = _subscribedTypes.find(typeName);
+	if(it == _subscribedTypes.end()) {
+		if(keyPrefix.isEmpty())
+			_subscribedTypes.insert(typeName, {});
+		else
+			_subscribedTypes.insert(typeName, {keyPrefix});
+	} else if(keyPrefix.isEmpty())
+		it->clear();
+	else if(!it->isEmpty() && !it->contains(keyPrefix)) //no prefixes means all keys already
+		it->append(keyPrefix);
+	_filtered = true;
+	updateSubscriptions();
+}
+
+void EmitterAdapter::unsubscribe(const QByteArray &typeName)
+{
+	_subscribedTypes.remove(typeName);
+	_filtered = true;
+	updateSubscriptions();
+}
+
+void EmitterAdapter::unsubscribeAll()
+{
+	_subscribedTypes.clear();
+	_filtered = true;
+	updateSubscriptions();
+}
+
+void EmitterAdapter::clearSubscriptions()
+{
+	_subscribedTypes.clear();
+	_filtered = false;
+	updateSubscriptions();
+}
+
 void EmitterAdapter::putCached(const ObjectKey &key, const QJsonObject &data, int costs)
 {
 	if(!_cache)
 		return;
 
-	QWriteLocker _(&_cache->lock);
-	_cache->cache.insert(key, new QJsonObject(data), costs);
+	//json first, so a typed value inserted concurrently is either removed here or detected by putCachedValue
+	_cache->touch();
+	_cache->cache.insert(key, data, costs);
+	if(_cache->typedCache)
+		_cache->typedCache->remove(key);
+	_cache->existence.remove(key);
+	_cache->regrow();
 }
 
 void EmitterAdapter::putCached(const QList<ObjectKey> &keys, const QList<QJsonObject> &data, const QList<int> &costs)
@@ -100,9 +179,14 @@ void EmitterAdapter::putCached(const QList<ObjectKey> &keys, const QList<QJsonOb
 	if(!_cache)
 		return;
 
-	QWriteLocker _(&_cache->lock);
-	for(auto i = 0; i < keys.size(); i++)
-		_cache->cache.insert(keys[i], new QJsonObject(data[i]), costs[i]);
+	_cache->touch();
+	for(auto i = 0; i < keys.size(); i++) {
+		_cache->cache.insert(keys[i], data[i], costs[i]);
+		if(_cache->typedCache)
+			_cache->typedCache->remove(keys[i]);
+		_cache->existence.remove(keys[i]);
+	}
+	_cache->regrow();
 }
 
 bool EmitterAdapter::getCached(const ObjectKey &key, QJsonObject &data)
@@ -110,91 +194,477 @@ bool EmitterAdapter::getCached(const ObjectKey &key, QJsonObject &data)
 	if(!_cache)
 		return false;
 
-	QReadLocker _(&_cache->lock);
-	auto json = _cache->cache.object(key);
-	if(json) {
-		data = *json;
-		return true;
-	} else
+	return _cache->cache.object(key, data);
+}
+
+QList<ObjectKey> EmitterAdapter::cachedKeys() const
+{
+	if(!_cache)
+		return {};
+
+	return _cache->cache.keys();
+}
+
+bool EmitterAdapter::getCachedValue(const ObjectKey &key, int metaTypeId, QVariant &value)
+{
+	if(!_cache || !_cache->typedCache)
 		return false;
+
+	QVariant cached;
+	if(!_cache->typedCache->object(key, cached) || cached.userType() != metaTypeId)
+		return false;
+	value = cached;
+	return true;
 }
 
-bool EmitterAdapter::dropCached(const ObjectKey &key)
+void EmitterAdapter::putCachedValue(const ObjectKey &key, const QJsonObject &data, const QVariant &value)
+{
+	if(!_cache || !_cache->typedCache)
+		return;
+
+	//only cache the value if the json it was created from is still the current one.
+	//both share their data if nothing changed in between, so this check is cheap
+	QJsonObject current;
+	int costs = 0;
+	if(!_cache->cache.peek(key, current, &costs) || current != data)
+		return;
+	_cache->typedCache->insert(key, value, costs);
+	//a putCached between the check and the insert might have missed the value - check again
+	if(!_cache->cache.peek(key, current) || current != data)
+		_cache->typedCache->remove(key);
+}
+
+bool EmitterAdapter::getCachedExists(const ObjectKey &key, bool &exists)
 {
 	if(!_cache)
 		return false;
 
-	//check if cached
-	{
-		QReadLocker _(&_cache->lock);
-		if(!_cache->cache.contains(key))
-			return false;
-	}
+	//cached data implies existence, the existence cache only knows the rest
+	if(_cache->cache.contains(key)) {
+		exists = true;
+		return true;
+	} else
+		return _cache->existence.object(key, exists);
+}
 
-	QWriteLocker _(&_cache->lock);
-	return _cache->cache.remove(key);
+quint64 EmitterAdapter::cacheStamp() const
+{
+	return _cache ? _cache->writeStamp.loadAcquire() : 0;
 }
 
-void EmitterAdapter::dropCached(const QByteArray &typeName, const QStringList &ids)
+void EmitterAdapter::putCachedExists(const ObjectKey &key, bool exists, quint64 stamp)
 {
 	if(!_cache)
 		return;
 
-	QWriteLocker _(&_cache->lock);
-	for(const auto &id : ids)
-		_cache->cache.remove({typeName, id});
+	//stamp must be taken before the database was queried. If any write happend since, the result
+	//might already be outdated. The second check catches writes that raced the insert itself
+	if(_cache->writeStamp.loadAcquire() != stamp)
+		return;
+	_cache->existence.insert(key, exists, CacheInfo::existenceCost(key));
+	if(_cache->writeStamp.loadAcquire() != stamp)
+		_cache->existence.remove(key);
+}
+
+void EmitterAdapter::touchCached()
+{
+	if(_cache)
+		_cache->touch();
+}
+
+bool EmitterAdapter::dropCached(const ObjectKey &key)
+{
+	if(!_cache)
+		return false;
+
+	_cache->touch();
+	if(_cache->typedCache)
+		_cache->typedCache->remove(key);
+	_cache->existence.remove(key);
+	return _cache->cache.remove(key);
+}
+
+void EmitterAdapter::dropCached(const QByteArray &typeName, const QStringList &ids)
+{
+	if(_cache)
+		_cache->drop(typeName, ids);
 }
 
 void EmitterAdapter::dropCached()
 {
+	if(_cache)
+		_cache->clear();
+}
+
+void EmitterAdapter::markCachedDeleted(const ObjectKey &key)
+{
+	if(_cache)
+		_cache->markDeleted(key);
+}
+
+void EmitterAdapter::markCachedDeleted(const QByteArray &typeName, const QStringList &ids)
+{
+	if(_cache)
+		_cache->markDeleted(typeName, ids);
+}
+
+bool EmitterAdapter::canReadShared() const
+{
+	//the primary only writes the shared cache, as it has all data in its own cache anyways
 	if(!_cache)
-		return;
+		return false;
+	auto shared = _cache->sharedCache();
+	return shared && !shared->isWritable();
+}
+
+bool EmitterAdapter::hasSharedCache() const
+{
+	return _cache && _cache->shared.loadAcquire();
+}
+
+bool EmitterAdapter::getSharedCached(const ObjectKey &key, quint64 version, const QByteArray &checksum, QByteArray &binData)
+{
+	if(!canReadShared())
+		return false;
 
-	QWriteLocker _(&_cache->lock);
-	_cache->cache.clear();
+	return _cache->shared.loadAcquire()->lookup(key, version, checksum, binData);
 }
 
-void EmitterAdapter::dataChangedImpl(QObject *origin, const ObjectKey &key, bool deleted)
+void EmitterAdapter::putSharedCached(const ObjectKey &key, quint64 version, const QByteArray &checksum, const QByteArray &binData)
+{
+	auto shared = _cache ? _cache->shared.loadAcquire() : nullptr;
+	if(shared)
+		shared->insert(key, version, checksum, binData);
+}
+
+void EmitterAdapter::dataChangedBatchImpl(QObject *origin, const QByteArray &typeName, const QStringList &ids, bool deleted)
 {
 	if(origin == nullptr || origin != parent())
-		emit dataChanged(key, deleted);
+		enqueueChanges(typeName, ids, deleted);
 }
 
 void EmitterAdapter::dataResettedImpl(QObject *origin)
 {
-	if(origin == nullptr || origin != parent())
+	if(origin == nullptr || origin != parent()) {
+		flushChanges();
 		emit dataResetted();
+	}
 }
 
 void EmitterAdapter::remoteDataChangedImpl(const ObjectKey &key, bool deleted)
 {
-	if(_cache) {
-		auto contains = false;
-		//check if cached
-		{
-			QReadLocker _(&_cache->lock);
-			contains = _cache->cache.contains(key);
-		}
-		//if chached, remove
-		if(contains) {
-			QWriteLocker _(&_cache->lock);
-			_cache->cache.remove(key);
-		}
-	}
-	emit dataChanged(key, deleted);
+	if(_cache)
+		_cache->drop(key);
+	enqueueChanges(key.typeName, {key.id}, deleted);
+}
+
+void EmitterAdapter::remoteDataChangedBatchImpl(const QByteArray &typeName, const QStringList &ids, bool deleted)
+{
+	if(_cache)
+		_cache->drop(typeName, ids);
+	enqueueChanges(typeName, ids, deleted);
 }
 
 void EmitterAdapter::remoteDataResettedImpl()
 {
-	if(_cache) {
-		QWriteLocker _(&_cache->lock);
-		_cache->cache.clear();
-	}
+	if(_cache)
+		_cache->clear();
+	flushChanges();
 	emit dataResetted();
 }
 
+void EmitterAdapter::flushChanges()
+{
+	auto pending = std::move(_pendingChanges);
+	_pendingChanges.clear();
+	for(const auto &changes : qAsConst(pending))
+		emitChanges(changes.typeName, changes.ids, changes.deleted);
+}
+
+void EmitterAdapter::enqueueChanges(const QByteArray &typeName, const QStringList &ids, bool deleted)
+{
+	//passive setups cannot filter at the source, so at least skip the flush for uninteresting changes
+	if(filterSubscribed(typeName, ids).isEmpty())
+		return;
+
+	//collect all changes that arrive until the next event loop iteration, merging those that can be
+	if(_pendingChanges.isEmpty())
+		QMetaObject::invokeMethod(this, "flushChanges", Qt::QueuedConnection);
+	else {
+		auto &last = _pendingChanges.last();
+		if(last.typeName == typeName && last.deleted == deleted) {
+			last.ids.append(ids);
+			return;
+		}
+	}
+	_pendingChanges.append({typeName, ids, deleted});
+}
+
+void EmitterAdapter::emitChanges(const QByteArray &typeName, const QStringList &ids, bool deleted)
+{
+	//filter again, subscriptions may have changed since the changes were queued
+	const auto subscribedIds = filterSubscribed(typeName, ids);
+	if(subscribedIds.isEmpty())
+		return;
 
+	for(const auto &id : subscribedIds)
+		emit dataChanged({typeName, id}, deleted);
+	emit dataChangedBatch(typeName, subscribedIds, deleted);
+}
 
-EmitterAdapter::CacheInfo::CacheInfo(int maxSize) :
-	cache{maxSize}
+QStringList EmitterAdapter::filterSubscribed(const QByteArray &typeName, const QStringList &ids) const
+{
+	if(!_filtered)
+		return ids;
+	auto it = _subscribedTypes.constFind(typeName);
+	if(it == _subscribedTypes.constEnd())
+		return {};
+	return SubscriptionInfo::filter(*it, ids);
+}
+
+void EmitterAdapter::updateSubscriptions()
+{
+	if(_subscriptions)
+		_subscriptions->update(this, _filtered, _subscribedTypes);
+}
+
+
+
+const qint64 EmitterAdapter::CacheInfo::RegrowInterval = 30000; // 30 seconds
+const qint64 EmitterAdapter::CacheInfo::SharedAttachInterval = 5000; // 5 seconds
+
+EmitterAdapter::CacheInfo::CacheInfo(int maxSize, int typedMaxSize, int minSize) :
+	cache{maxSize},
+	typedCache{typedMaxSize > 0 ? new ConcurrentCache<ObjectKey, QVariant>{typedMaxSize} : nullptr},
+	existence{maxSize / 8},
+	maxSize{maxSize},
+	minSize{minSize > 0 && minSize < maxSize ? minSize : maxSize},
+	lastResize{0},
+	lastSharedAttach{0}
 {}
+
+EmitterAdapter::CacheInfo::~CacheInfo()
+{
+	delete shared.loadAcquire();
+}
+
+void EmitterAdapter::CacheInfo::drop(const ObjectKey &key)
+{
+	touch();
+	if(typedCache)
+		typedCache->remove(key);
+	existence.remove(key);
+	cache.remove(key);
+}
+
+void EmitterAdapter::CacheInfo::drop(const QByteArray &typeName, const QStringList &ids)
+{
+	for(const auto &id : ids)
+		drop({typeName, id});
+}
+
+void EmitterAdapter::CacheInfo::markDeleted(const ObjectKey &key)
+{
+	touch();
+	if(typedCache)
+		typedCache->remove(key);
+	cache.remove(key);
+	existence.insert(key, false, existenceCost(key));
+}
+
+void EmitterAdapter::CacheInfo::markDeleted(const QByteArray &typeName, const QStringList &ids)
+{
+	for(const auto &id : ids)
+		markDeleted({typeName, id});
+}
+
+void EmitterAdapter::CacheInfo::clear()
+{
+	touch();
+	if(typedCache)
+		typedCache->clear();
+	existence.clear();
+	cache.clear();
+}
+
+void EmitterAdapter::CacheInfo::touch()
+{
+	writeStamp.fetchAndAddOrdered(1);
+}
+
+CacheStatistics EmitterAdapter::CacheInfo::statistics() const
+{
+	CacheStatistics statistics;
+	const auto jsonStatistics = cache.statistics();
+	statistics.hits = jsonStatistics.hits;
+	statistics.misses = jsonStatistics.misses;
+	statistics.evictions = jsonStatistics.evictions;
+	//typed hits never reach the json cache, typed misses are counted by it
+	if(typedCache)
+		statistics.hits += typedCache->statistics().hits;
+	statistics.maxBytes = cache.maxCost();
+	cache.forEach([&](const ObjectKey &key, int cost) {
+		auto &typeStatistics = statistics.types[key.typeName];
+		typeStatistics.entries++;
+		typeStatistics.bytes += cost;
+		statistics.entries++;
+		statistics.bytes += cost;
+	});
+	return statistics;
+}
+
+void EmitterAdapter::CacheInfo::trim(bool critical)
+{
+	if(minSize == maxSize) //not adaptive
+		return;
+
+	lastResize.store(QDateTime::currentMSecsSinceEpoch());
+	cache.setMaxCost(critical ? minSize : qMax(minSize, cache.maxCost() / 2));
+	if(critical && typedCache)
+		typedCache->clear();
+}
+
+void EmitterAdapter::CacheInfo::regrow()
+{
+	//after memory pressure, give the cache back its full size step by step
+	const auto currentSize = cache.maxCost();
+	if(currentSize >= maxSize)
+		return;
+
+	const auto now = QDateTime::currentMSecsSinceEpoch();
+	auto lastTime = lastResize.load();
+	if(now - lastTime < RegrowInterval ||
+	   !lastResize.testAndSetRelaxed(lastTime, now))
+		return;
+	cache.setMaxCost(qMin(maxSize, currentSize + qMax(maxSize / 8, 1)));
+}
+
+SharedCache *EmitterAdapter::CacheInfo::sharedCache()
+{
+	auto cache = shared.loadAcquire();
+	if(cache || sharedKey.isEmpty())
+		return cache;
+
+	//the primary may have been started after this setup - retry attaching, but not on every lookup
+	const auto now = QDateTime::currentMSecsSinceEpoch();
+	auto lastTime = lastSharedAttach.load();
+	if((lastTime != 0 && now - lastTime < SharedAttachInterval) ||
+	   !lastSharedAttach.testAndSetRelaxed(lastTime, now))
+		return nullptr;
+
+	QString error;
+	cache = SharedCache::attach(sharedKey, error);
+	if(cache)
+		shared.storeRelease(cache);
+	return cache;
+}
+
+int EmitterAdapter::CacheInfo::existenceCost(const ObjectKey &key)
+{
+	return static_cast<int>(sizeof(ObjectKey) + sizeof(bool)) +
+			key.typeName.size() +
+			key.id.size() * static_cast<int>(sizeof(QChar));
+}
+
+
+
+void EmitterAdapter::SubscriptionInfo::add(EmitterAdapter *adapter, QObject *origin)
+{
+	QWriteLocker _(&lock);
+	Subscriber subscriber;
+	subscriber.origin = origin;
+	subscribers.insert(adapter, subscriber);
+	unfiltered.insert(adapter);
+}
+
+void EmitterAdapter::SubscriptionInfo::update(EmitterAdapter *adapter, bool filtered, const QHash<QByteArray, QStringList> &types)
+{
+	QWriteLocker _(&lock);
+	auto it = subscribers.find(adapter);
+	if(it == subscribers.end())
+		return;
+
+	unindex(adapter, *it);
+	it->filtered = filtered;
+	it->types = types;
+	if(filtered) {
+		for(auto tIt = types.constBegin(); tIt != types.constEnd(); ++tIt)
+			typeIndex[tIt.key()].insert(adapter);
+	} else
+		unfiltered.insert(adapter);
+}
+
+void EmitterAdapter::SubscriptionInfo::remove(EmitterAdapter *adapter)
+{
+	QWriteLocker _(&lock);
+	auto it = subscribers.find(adapter);
+	if(it == subscribers.end())
+		return;
+	unindex(adapter, *it);
+	subscribers.erase(it);
+}
+
+void EmitterAdapter::SubscriptionInfo::dispatch(QObject *origin, const QByteArray &typeName, const QStringList &ids, bool deleted)
+{
+	//the lock is held while posting, so removed adapters can never receive an event
+	QReadLocker _(&lock);
+	const auto deliver = [&](EmitterAdapter *adapter, const QStringList &matchingIds) {
+		QMetaObject::invokeMethod(adapter, "dataChangedBatchImpl",
+								  Qt::QueuedConnection,
+								  Q_ARG(QObject*, origin),
+								  Q_ARG(QByteArray, typeName),
+								  Q_ARG(QStringList, matchingIds),
+								  Q_ARG(bool, deleted));
+	};
+
+	for(auto adapter : qAsConst(unfiltered)) {
+		if(!origin || subscribers.constFind(adapter)->origin != origin) //own changes are emitted directly
+			deliver(adapter, ids);
+	}
+
+	auto iIt = typeIndex.constFind(typeName);
+	if(iIt == typeIndex.constEnd())
+		return;
+	for(auto adapter : *iIt) {
+		const auto &subscriber = *subscribers.constFind(adapter);
+		if(origin && subscriber.origin == origin)
+			continue;
+		const auto matchingIds = filter(subscriber.types.value(typeName), ids);
+		if(!matchingIds.isEmpty())
+			deliver(adapter, matchingIds);
+	}
+}
+
+QStringList EmitterAdapter::SubscriptionInfo::filter(const QStringList &prefixes, const QStringList &ids)
+{
+	if(prefixes.isEmpty())
+		return ids;
+
+	QStringList matchingIds;
+	for(const auto &id : ids) {
+		for(const auto &prefix : prefixes) {
+			if(id.startsWith(prefix)) {
+				matchingIds.append(id);
+				break;
+			}
+		}
+	}
+	return matchingIds;
+}
+
+void EmitterAdapter::SubscriptionInfo::unindex(EmitterAdapter *adapter, const Subscriber &subscriber)
+{
+	if(!subscriber.filtered) {
+		unfiltered.remove(adapter);
+		return;
+	}
+
+	for(auto tIt = subscriber.types.constBegin(); tIt != subscriber.types.constEnd(); ++tIt) {
+		auto iIt = typeIndex.find(tIt.key());
+		if(iIt == typeIndex.end())
+			continue;
+		iIt->remove(adapter);
+		if(iIt->isEmpty())
+			typeIndex.erase(iIt);
+	}
+}
@@ -1,13 +1,18 @@
 #ifndef QTDATASYNC_EMITTERADAPTER_P_H
 #define QTDATASYNC_EMITTERADAPTER_P_H
 
+#include <QtCore/QAtomicPointer>
 #include <QtCore/QObject>
+#include <QtCore/QJsonObject>
 #include <QtCore/QReadWriteLock>
-#include <QtCore/QCache>
+#include <QtCore/QSet>
 
 #include "qtdatasync_global.h"
 #include "objectkey.h"
 #include "defaults.h"
+#include "concurrentcache_p.h"
+#include "sharedcache_p.h"
+#include "cachestatistics.h"
 
 namespace QtDataSync {
 
@@ -17,42 +22,131 @@ class Q_DATASYNC_EXPORT EmitterAdapter : public QObject
 
 public:
 	struct Q_DATASYNC_EXPORT CacheInfo {
+		static const qint64 RegrowInterval;
+		static const qint64 SharedAttachInterval;
+
+		ConcurrentCache<ObjectKey, QJsonObject> cache;
+		QScopedPointer<ConcurrentCache<ObjectKey, QVariant>> typedCache;
+		ConcurrentCache<ObjectKey, bool> existence;
+		QAtomicPointer<SharedCache> shared; //owned, set once
+		QString sharedKey; //passive setups only, to attach once the primary created the segment
+		const int maxSize;
+		const int minSize;
+		QAtomicInteger<qint64> lastResize;
+		QAtomicInteger<qint64> lastSharedAttach;
+		QAtomicInteger<quint64> writeStamp; //bumped by every write, guards negative lookups against races
+
+		CacheInfo(int maxSize, int typedMaxSize = 0, int minSize = 0);
+		~CacheInfo();
+		Q_DISABLE_COPY(CacheInfo)
+
+		void drop(const ObjectKey &key);
+		void drop(const QByteArray &typeName, const QStringList &ids);
+		void markDeleted(const ObjectKey &key);
+		void markDeleted(const QByteArray &typeName, const QStringList &ids);
+		void clear();
+		void touch();
+
+		CacheStatistics statistics() const;
+		void trim(bool critical);
+		void regrow();
+		SharedCache *sharedCache();
+
+		static int existenceCost(const ObjectKey &key);
+	};
+
+	struct Q_DATASYNC_EXPORT SubscriptionInfo {
+		struct Subscriber {
+			QObject *origin = nullptr;
+			bool filtered = false;
+			QHash<QByteArray, QStringList> types; //type -> key prefixes, empty for all keys
+		};
+
 		QReadWriteLock lock;
-		QCache<ObjectKey, QJsonObject> cache;
+		QHash<EmitterAdapter*, Subscriber> subscribers;
+		QSet<EmitterAdapter*> unfiltered;
+		QHash<QByteArray, QSet<EmitterAdapter*>> typeIndex;
 
-		CacheInfo(int maxSize);
+		void add(EmitterAdapter *adapter, QObject *origin);
+		void update(EmitterAdapter *adapter, bool filtered, const QHash<QByteArray, QStringList> &types);
+		void remove(EmitterAdapter *adapter);
+		void dispatch(QObject *origin, const QByteArray &typeName, const QStringList &ids, bool deleted);
+
+		static QStringList filter(const QStringList &prefixes, const QStringList &ids);
+
+	private:
+		void unindex(EmitterAdapter *adapter, const Subscriber &subscriber);
 	};
 
 	explicit EmitterAdapter(QObject *changeEmitter,
 							QSharedPointer<CacheInfo> cacheInfo,
 							QObject *origin = nullptr);
+	~EmitterAdapter() override;
 
 	void triggerChange(const QtDataSync::ObjectKey &key, bool deleted, bool changed);
+	void triggerChange(const QByteArray &typeName, const QStringList &ids, bool deleted, bool changed);
 	void triggerClear(const QByteArray &typeName, const QStringList &ids);
 	void triggerReset();
 	void triggerUpload();
 
+	void subscribe(const QByteArray &typeName, const QString &keyPrefix = {});
+	void unsubscribe(const QByteArray &typeName);
+	void unsubscribeAll();
+	void clearSubscriptions();
+
 	void putCached(const ObjectKey &key, const QJsonObject &data, int costs);
 	void putCached(const QList<ObjectKey> &keys, const QList<QJsonObject> &data, const QList<int> &costs);
 	bool getCached(const ObjectKey &key, QJsonObject &data);
+	QList<ObjectKey> cachedKeys() const;
+	bool getCachedValue(const ObjectKey &key, int metaTypeId, QVariant &value);
+	void putCachedValue(const ObjectKey &key, const QJsonObject &data, const QVariant &value);
+	bool getCachedExists(const ObjectKey &key, bool &exists);
+	quint64 cacheStamp() const;
+	void putCachedExists(const ObjectKey &key, bool exists, quint64 stamp);
+	void touchCached();
 	bool dropCached(const ObjectKey &key);
 	void dropCached(const QByteArray &typeName, const QStringList &ids);
 	void dropCached();
+	void markCachedDeleted(const ObjectKey &key);
+	void markCachedDeleted(const QByteArray &typeName, const QStringList &ids);
+	bool canReadShared() const;
+	bool hasSharedCache() const;
+	bool getSharedCached(const ObjectKey &key, quint64 version, const QByteArray &checksum, QByteArray &binData);
+	void putSharedCached(const ObjectKey &key, quint64 version, const QByteArray &checksum, const QByteArray &binData);
 
 Q_SIGNALS:
 	void dataChanged(const QtDataSync::ObjectKey &key, bool deleted);
+	void dataChangedBatch(const QByteArray &typeName, const QStringList &ids, bool deleted);
 	void dataResetted();
 
 private Q_SLOTS:
-	void dataChangedImpl(QObject *origin, const QtDataSync::ObjectKey &key, bool deleted);
+	void dataChangedBatchImpl(QObject *origin, const QByteArray &typeName, const QStringList &ids, bool deleted);
 	void dataResettedImpl(QObject *origin);
 	void remoteDataChangedImpl(const QtDataSync::ObjectKey &key, bool deleted);
+	void remoteDataChangedBatchImpl(const QByteArray &typeName, const QStringList &ids, bool deleted);
 	void remoteDataResettedImpl();
+	void flushChanges();
 
 private:
+	struct PendingChanges {
+		QByteArray typeName;
+		QStringList ids;
+		bool deleted;
+	};
+
 	bool _isPrimary;
 	QObject *_emitterBackend;
 	QSharedPointer<CacheInfo> _cache;
+	QSharedPointer<SubscriptionInfo> _subscriptions; //only for primary setups
+	bool _filtered;
+	QHash<QByteArray, QStringList> _subscribedTypes;
+	QList<PendingChanges> _pendingChanges;
+
+	QStringList filterSubscribed(const QByteArray &typeName, const QStringList &ids) const;
+	void updateSubscriptions();
+
+	void enqueueChanges(const QByteArray &typeName, const QStringList &ids, bool deleted);
+	void emitChanges(const QByteArray &typeName, const QStringList &ids, bool deleted);
 };
 
 }
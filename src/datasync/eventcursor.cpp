@@ -37,11 +37,10 @@ EventCursor *EventCursor::first(QObject *parent)
 EventCursor *EventCursor::first(const QString &setupName, QObject *parent)
 {
 	auto cursor = new EventCursor{setupName, parent};
-	QSqlQuery eventQuery{cursor->d->database};
-	eventQuery.prepare(QStringLiteral("SELECT SeqId, Type, Id, Removed, Timestamp "
-									  "FROM EventLog "
-									  "ORDER BY SeqId ASC "
-									  "LIMIT 1"));
+	CachedQuery eventQuery{cursor->d->database, QStringLiteral("SELECT SeqId, Type, Id, Removed, Timestamp "
+															   "FROM EventLog "
+															   "ORDER BY SeqId ASC "
+															   "LIMIT 1")};
 	cursor->d->exec(eventQuery);
 	if(eventQuery.first())
 		cursor->d->readQuery(eventQuery);
@@ -56,11 +55,10 @@ EventCursor *EventCursor::last(QObject *parent)
 EventCursor *EventCursor::last(const QString &setupName, QObject *parent)
 {
 	auto cursor = new EventCursor{setupName, parent};
-	QSqlQuery eventQuery{cursor->d->database};
-	eventQuery.prepare(QStringLiteral("SELECT SeqId, Type, Id, Removed, Timestamp "
-									  "FROM EventLog "
-									  "ORDER BY SeqId DESC "
-									  "LIMIT 1"));
+	CachedQuery eventQuery{cursor->d->database, QStringLiteral("SELECT SeqId, Type, Id, Removed, Timestamp "
+															   "FROM EventLog "
+															   "ORDER BY SeqId DESC "
+															   "LIMIT 1")};
 	cursor->d->exec(eventQuery);
 	if(eventQuery.first())
 		cursor->d->readQuery(eventQuery);
@@ -75,11 +73,10 @@ EventCursor *EventCursor::create(quint64 index, QObject *parent)
 EventCursor *EventCursor::create(quint64 index, const QString &setupName, QObject *parent)
 {
 	auto cursor = new EventCursor{setupName, parent};
-	QSqlQuery eventQuery{cursor->d->database};
-	eventQuery.prepare(QStringLiteral("SELECT SeqId, Type, Id, Removed, Timestamp "
-									  "FROM EventLog "
-									  "WHERE SeqId = ? "
-									  "LIMIT 1"));
+	CachedQuery eventQuery{cursor->d->database, QStringLiteral("SELECT SeqId, Type, Id, Removed, Timestamp "
+															   "FROM EventLog "
+															   "WHERE SeqId = ? "
+															   "LIMIT 1")};
 	eventQuery.addBindValue(index);
 	cursor->d->exec(eventQuery, index);
 	if(eventQuery.first())
@@ -153,16 +150,16 @@ bool EventCursor::skipObsolete() const
 
 bool EventCursor::hasNext() const
 {
-	QSqlQuery eventQuery{d->database};
-	d->prepareNextQuery(eventQuery, false);
+	CachedQuery eventQuery{d->database, d->nextQuery(false)};
+	eventQuery.addBindValue(d->index);
 	d->exec(eventQuery, d->index);
 	return eventQuery.first();
 }
 
 bool EventCursor::next()
 {
-	QSqlQuery eventQuery{d->database};
-	d->prepareNextQuery(eventQuery, true);
+	CachedQuery eventQuery{d->database, d->nextQuery(true)};
+	eventQuery.addBindValue(d->index);
 	d->exec(eventQuery, d->index);
 	if(eventQuery.first()) {
 		d->readQuery(eventQuery);
@@ -224,9 +221,8 @@ void EventCursor::clearEventLog(quint64 offset)
 		};
 	}
 
-	QSqlQuery eventQuery{d->database};
-	eventQuery.prepare(QStringLiteral("DELETE FROM EventLog "
-									  "WHERE SeqId < ?"));
+	CachedQuery eventQuery{d->database, QStringLiteral("DELETE FROM EventLog "
+													   "WHERE SeqId < ?")};
 	eventQuery.addBindValue(d->index - offset);
 	d->exec(eventQuery, d->index - offset);
 }
@@ -435,21 +431,20 @@ void EventCursorPrivate::readQuery(const QSqlQuery &query)
 	timestamp = query.value(4).toDateTime().toLocalTime();
 }
 
-void EventCursorPrivate::prepareNextQuery(QSqlQuery &query, bool withData) const
+QString EventCursorPrivate::nextQuery(bool withData) const
 {
-	query.prepare((withData ?
-					   QStringLiteral("SELECT EventLog.SeqId, EventLog.Type, EventLog.Id, EventLog.Removed, EventLog.Timestamp ") :
-					   QStringLiteral("SELECT EventLog.SeqId ")) +
+	return (withData ?
+				QStringLiteral("SELECT EventLog.SeqId, EventLog.Type, EventLog.Id, EventLog.Removed, EventLog.Timestamp ") :
+				QStringLiteral("SELECT EventLog.SeqId ")) +
 
-				  QStringLiteral("FROM EventLog ") +
+			QStringLiteral("FROM EventLog ") +
 
-				  (skipObsolete ?
-					   QStringLiteral("LEFT JOIN DataIndex "
-									  "ON DataIndex.Type = EventLog.Type AND DataIndex.Id = EventLog.Id "
-									  "WHERE SeqId > ? AND (EventLog.Version IS NULL OR EventLog.Version = DataIndex.Version) ") :
-					   QStringLiteral("WHERE SeqId > ? ")) +
+			(skipObsolete ?
+				 QStringLiteral("LEFT JOIN DataIndex "
+								"ON DataIndex.Type = EventLog.Type AND DataIndex.Id = EventLog.Id "
+								"WHERE SeqId > ? AND (EventLog.Version IS NULL OR EventLog.Version = DataIndex.Version) ") :
+				 QStringLiteral("WHERE SeqId > ? ")) +
 
-				  QStringLiteral("ORDER BY SeqId ASC "
-								 "LIMIT 1"));
-	query.addBindValue(index);
+			QStringLiteral("ORDER BY SeqId ASC "
+						   "LIMIT 1");
 }
@@ -24,7 +24,7 @@ public:
 private:
 	void exec(QSqlQuery &query, quint64 qIndex = 0) const;
 	void readQuery(const QSqlQuery &query);
-	void prepareNextQuery(QSqlQuery &query, bool withData) const;
+	QString nextQuery(bool withData) const;
 
 	Defaults defaults;
 	DatabaseRef database;
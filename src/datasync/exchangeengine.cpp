@@ -12,8 +12,16 @@
 
 #include <QtCore/QDebug>
 #include <QtCore/QCoreApplication>
+#include <QtCore/QTimer>
+
+#if QT_HAS_INCLUDE(<chrono>)
+#define scdtime(x) x
+#else
+#define scdtime(x) duration_cast<milliseconds>(x).count()
+#endif
 
 using namespace QtDataSync;
+using namespace std::chrono;
 
 #define QTDATASYNC_LOG _logger
 
@@ -95,6 +103,34 @@ void ExchangeEngine::initialize()
 	logDebug() << "Beginning engine initialization";
 	try {
 		_localStore = new LocalStore(_defaults, this);
+		_localStore->unsubscribeAll(); //only used for storage access, not interested in changes
+		if(_defaults.property(Defaults::StorageMode).value<Setup::StorageMode>() == Setup::StorageMode::Inline) {
+			_localStore->migrateStorage();
+			startVacuumSetup();
+			//periodically give back the space of removed datasets
+			auto compactTimer = new QTimer(this);
+			compactTimer->setInterval(scdtime(minutes(5)));
+			compactTimer->setTimerType(Qt::VeryCoarseTimer);
+			connect(compactTimer, &QTimer::timeout,
+					this, &ExchangeEngine::compactStore);
+			compactTimer->start();
+		}
+
+		//indexes declared after the data was stored are built in the background
+		startIndexSetup();
+
+		//preload the data used before the last shutdown, and keep track of it for the next start
+		if(_defaults.property(Defaults::CacheSize).toInt() > 0)
+			_warmupCount = _defaults.property(Defaults::CacheWarmupCount).toInt();
+		if(_warmupCount > 0) {
+			startCacheWarmup();
+			auto warmupTimer = new QTimer(this);
+			warmupTimer->setInterval(scdtime(minutes(5)));
+			warmupTimer->setTimerType(Qt::VeryCoarseTimer);
+			connect(warmupTimer, &QTimer::timeout,
+					this, &ExchangeEngine::recordCacheWarmup);
+			warmupTimer->start();
+		}
 
 		//change controller
 		connectController(_changeController);
@@ -118,6 +154,8 @@ void ExchangeEngine::initialize()
 				_changeController, &ChangeController::updateUploadLimit);
 		connect(_remoteConnector, &RemoteConnector::uploadDone,
 				_changeController, &ChangeController::uploadDone);
+		connect(_remoteConnector, &RemoteConnector::uploadsRejected,
+				_changeController, &ChangeController::uploadsRejected);
 		connect(_remoteConnector, &RemoteConnector::deviceUploadDone,
 				_changeController, &ChangeController::deviceUploadDone);
 		connect(_remoteConnector, &RemoteConnector::downloadData,
@@ -179,6 +217,19 @@ void ExchangeEngine::finalize()
 			thread(), &QThread::quit,
 			Qt::DirectConnection);
 
+	if(_vacuumThread)
+		_vacuumThread->wait(); //a running vacuum cannot be interrupted
+	if(_indexThread) {
+		_indexThread->requestInterruption();
+		_indexThread->wait();
+	}
+	if(_warmupThread) {
+		_warmupThread->requestInterruption();
+		_warmupThread->wait();
+	}
+	if(_warmupCount > 0)
+		recordCacheWarmup();
+
 	_syncController->finalize();
 	_changeController->finalize();
 	_remoteConnector->finalize();
@@ -264,6 +315,24 @@ void ExchangeEngine::uploadingChanged(bool uploading)
 	}
 }
 
+void ExchangeEngine::compactStore()
+{
+	try {
+		_localStore->compactStorage(CompactPageLimit);
+	} catch(Exception &e) {
+		logWarning() << "Failed to compact the local store with error:" << e.what();
+	}
+}
+
+void ExchangeEngine::recordCacheWarmup()
+{
+	try {
+		_localStore->recordWarmupKeys(_warmupCount);
+	} catch(Exception &e) {
+		logWarning() << "Failed to record the keys for the cache warm-up with error:" << e.what();
+	}
+}
+
 void ExchangeEngine::addProgress(quint32 estimate)
 {
 	if(sender() == _progressAllowed) {
@@ -300,6 +369,62 @@ void ExchangeEngine::connectController(Controller *controller)
 			this, &ExchangeEngine::incrementProgress);
 }
 
+void ExchangeEngine::startVacuumSetup()
+{
+	//the full vacuum needed once rewrites the whole database, so it must not block the engine
+	auto defaults = _defaults;
+	_vacuumThread = QThread::create([this, defaults]() {
+		try {
+			LocalStore store{defaults};
+			store.unsubscribeAll(); //the thread has no event loop to receive changes
+			store.enableIncrementalVacuum();
+		} catch(Exception &e) {
+			logWarning() << "Failed to enable incremental vacuum with error:" << e.what();
+		}
+	});
+	_vacuumThread->setObjectName(QStringLiteral("%1:vacuum").arg(defaults.setupName()));
+	connect(_vacuumThread, &QThread::finished,
+			_vacuumThread, &QThread::deleteLater);
+	_vacuumThread->start(QThread::IdlePriority);
+}
+
+void ExchangeEngine::startIndexSetup()
+{
+	auto defaults = _defaults;
+	_indexThread = QThread::create([this, defaults]() {
+		try {
+			LocalStore store{defaults};
+			store.unsubscribeAll(); //the thread has no event loop to receive changes
+			store.prepareIndexes();
+		} catch(Exception &e) {
+			logWarning() << "Failed to prepare the indexes with error:" << e.what();
+		}
+	});
+	_indexThread->setObjectName(QStringLiteral("%1:indexes").arg(defaults.setupName()));
+	connect(_indexThread, &QThread::finished,
+			_indexThread, &QThread::deleteLater);
+	_indexThread->start(QThread::LowPriority);
+}
+
+void ExchangeEngine::startCacheWarmup()
+{
+	auto defaults = _defaults;
+	_warmupThread = QThread::create([this, defaults]() {
+		try {
+			LocalStore store{defaults};
+			store.unsubscribeAll(); //the thread has no event loop to receive changes
+			store.warmupCache();
+		} catch(Exception &e) {
+			logWarning() << "Failed to warm up the cache with error:" << e.what();
+		}
+	});
+	_warmupThread->setObjectName(QStringLiteral("%1:cache-warmup").arg(defaults.setupName()));
+	connect(_warmupThread, &QThread::finished,
+			_warmupThread, &QThread::deleteLater);
+	//there is no portable io priority - the idle priority gets the closest to it
+	_warmupThread->start(QThread::IdlePriority);
+}
+
 bool ExchangeEngine::upstate(SyncManager::SyncState state)
 {
 	if(_state != state) {
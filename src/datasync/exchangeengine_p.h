@@ -83,11 +83,15 @@ private Q_SLOTS:
 	void controllerTimeout();
 	void remoteEvent(RemoteConnector::RemoteEvent event);
 	void uploadingChanged(bool uploading);
+	void compactStore();
+	void recordCacheWarmup();
 
 	void addProgress(quint32 estimate);
 	void incrementProgress();
 
 private:
+	static const int CompactPageLimit = 1024;
+
 	SyncManager::SyncState _state = SyncManager::Initializing;
 	quint32 _progressCurrent = 0;
 	quint32 _progressMax = 0;
@@ -99,6 +103,10 @@ private:
 	Setup::FatalErrorHandler _fatalErrorHandler;
 
 	LocalStore *_localStore = nullptr;
+	QPointer<QThread> _vacuumThread;
+	QPointer<QThread> _indexThread;
+	QPointer<QThread> _warmupThread;
+	int _warmupCount = 0;
 
 	ChangeController *_changeController;
 	SyncController *_syncController;
@@ -114,6 +122,9 @@ private:
 	static Q_NORETURN void defaultFatalErrorHandler(const QString &error, const QString &setup, const QMessageLogContext &context);
 
 	void connectController(Controller *controller);
+	void startVacuumSetup();
+	void startIndexSetup();
+	void startCacheWarmup();
 	bool upstate(SyncManager::SyncState state);
 	void clearError();
 	void resetProgress(Controller *controller = nullptr);
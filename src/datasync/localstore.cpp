@@ -3,16 +3,24 @@
 #include "synchelper_p.h"
 #include "emitteradapter_p.h"
 #include "eventcursor_p.h"
+#include "defaults_p.h"
+
+#include <algorithm>
 
 #include <QtCore/QUrl>
 #include <QtCore/QJsonDocument>
+#include <QtCore/QJsonArray>
 #include <QtCore/QTemporaryFile>
 #include <QtCore/QCoreApplication>
 #include <QtCore/QSaveFile>
 #include <QtCore/QRegularExpression>
+#include <QtCore/QThread>
+
+#include <QtConcurrent/QtConcurrentMap>
 
 #include <QtSql/QSqlQuery>
 #include <QtSql/QSqlError>
+#include <QtSql/QSqlRecord>
 
 using namespace QtDataSync;
 using std::function;
@@ -22,15 +30,26 @@ using std::make_tuple;
 #define QTDATASYNC_LOG _logger
 #define SCOPE_ASSERT() Q_ASSERT_X(scope.d->database.isValid(), Q_FUNC_INFO, "Cannot use SyncScope after committing it")
 
+const QString LocalStore::InlineFileName(QStringLiteral(":inline"));
+const int LocalStore::ParallelDecodeLimit = 64;
+const int LocalStore::CursorPageSize = 100;
+const char * const LocalStore::IndexClassInfo = "qtdatasync_index";
+const char * const LocalStore::ContentClassInfo = "qtdatasync_fulltext";
+const char * const LocalStore::CompressionClassInfo = "qtdatasync_compression";
+const QByteArray LocalStore::CompressionTag("qdsz");
+
 LocalStore::LocalStore(Defaults defaults, QObject *parent) :
 	QObject{parent},
 	_defaults{std::move(defaults)},
 	_logger{_defaults.createLogger("store", this)},
 	_emitter{_defaults.createEmitter(this)},
-	_database{_defaults.aquireDatabase(this)}
+	_database{_defaults.aquireDatabase(this)},
+	_hasContentIndex{true}
 {
 	connect(_emitter, &EmitterAdapter::dataChanged,
 			this, &LocalStore::dataChanged);
+	connect(_emitter, &EmitterAdapter::dataChangedBatch,
+			this, &LocalStore::dataChangedBatch);
 	connect(_emitter, &EmitterAdapter::dataResetted,
 			this, &LocalStore::dataResetted);
 
@@ -43,6 +62,7 @@ LocalStore::LocalStore(Defaults defaults, QObject *parent) :
 										   "	File		TEXT,"
 										   "	Checksum	BLOB,"
 										   "	Changed		INTEGER NOT NULL DEFAULT 1,"
+										   "	Data		BLOB,"
 										   "	PRIMARY KEY(Type, Id)"
 										   ") WITHOUT ROWID;"));
 		if(!createQuery.exec()) {
@@ -54,6 +74,19 @@ LocalStore::LocalStore(Defaults defaults, QObject *parent) :
 			};
 		}
 		logDebug() << "Created DataIndex table";
+	} else if(!_database->record(QStringLiteral("DataIndex")).contains(QStringLiteral("Data"))) {
+		QSqlQuery alterQuery{_database};
+		alterQuery.prepare(QStringLiteral("ALTER TABLE DataIndex ADD COLUMN Data BLOB"));
+		if(!alterQuery.exec() &&
+		   !_database->record(QStringLiteral("DataIndex")).contains(QStringLiteral("Data"))) { //might have been added by another thread
+			throw LocalStoreException {
+				_defaults,
+				QByteArray{QTDATASYNC_EXCEPTION_NAME(LocalStore)},
+				alterQuery.executedQuery().simplified(),
+				alterQuery.lastError().text()
+			};
+		}
+		logDebug() << "Added inline data column to DataIndex table";
 	}
 
 	if(!_database->tables().contains(QStringLiteral("DeviceUploads"))) {
@@ -76,6 +109,206 @@ LocalStore::LocalStore(Defaults defaults, QObject *parent) :
 		logDebug() << "Created DeviceUploads table";
 	}
 
+	{
+		//only the pending changes, so uploads can walk them without scanning the whole index
+		QSqlQuery indexQuery{_database};
+		indexQuery.prepare(QStringLiteral("SELECT 1 FROM sqlite_master WHERE type = 'index' AND name = 'DataIndexChanged'"));
+		exec(indexQuery, QByteArray{QTDATASYNC_EXCEPTION_NAME(LocalStore)});
+		if(!indexQuery.first()) {
+			QSqlQuery createQuery{_database};
+			createQuery.prepare(QStringLiteral("CREATE INDEX IF NOT EXISTS DataIndexChanged ON DataIndex (Type, Id) WHERE Changed = 1;"));
+			exec(createQuery, QByteArray{QTDATASYNC_EXCEPTION_NAME(LocalStore)});
+			logDebug() << "Created DataIndexChanged index";
+		}
+	}
+
+	if(!_database->tables().contains(QStringLiteral("PropertyIndex"))) {
+		const QStringList createStatements {
+			QStringLiteral("CREATE TABLE IF NOT EXISTS PropertyIndex ( "
+						   "	Type		TEXT NOT NULL, "
+						   "	Property	TEXT NOT NULL, "
+						   "	Value		NOT NULL, "
+						   "	Id			TEXT NOT NULL, "
+						   "	PRIMARY KEY(Type, Property, Value, Id), "
+						   "	FOREIGN KEY(Type, Id) REFERENCES DataIndex ON DELETE CASCADE "
+						   ") WITHOUT ROWID;"),
+			QStringLiteral("CREATE INDEX IF NOT EXISTS PropertyIndexKeys ON PropertyIndex (Type, Id);"),
+			QStringLiteral("CREATE TABLE IF NOT EXISTS IndexInfo ( "
+						   "	Type		TEXT NOT NULL, "
+						   "	Kind		TEXT NOT NULL, "
+						   "	Properties	TEXT NOT NULL, "
+						   "	PRIMARY KEY(Type, Kind) "
+						   ") WITHOUT ROWID;")
+		};
+		for(const auto &statement : createStatements) {
+			QSqlQuery createQuery{_database};
+			createQuery.prepare(statement);
+			if(!createQuery.exec()) {
+				throw LocalStoreException{
+					_defaults,
+					QByteArray{QTDATASYNC_EXCEPTION_NAME(LocalStore)},
+					createQuery.executedQuery().simplified(),
+					createQuery.lastError().text()
+				};
+			}
+		}
+		logDebug() << "Created PropertyIndex table";
+	}
+
+	if(!_database->tables().contains(QStringLiteral("CacheWarmup"))) {
+		QSqlQuery createQuery{_database};
+		createQuery.prepare(QStringLiteral("CREATE TABLE IF NOT EXISTS CacheWarmup ( "
+										   "	Type		TEXT NOT NULL, "
+										   "	Id			TEXT NOT NULL, "
+										   "	Rank		INTEGER NOT NULL, "
+										   "	PRIMARY KEY(Type, Id) "
+										   ") WITHOUT ROWID;"));
+		if(!createQuery.exec()) {
+			throw LocalStoreException{
+				_defaults,
+				QByteArray{QTDATASYNC_EXCEPTION_NAME(LocalStore)},
+				createQuery.executedQuery().simplified(),
+				createQuery.lastError().text()
+			};
+		}
+		logDebug() << "Created CacheWarmup table";
+	}
+
+	if(!_database->tables().contains(QStringLiteral("TypeCounts"))) {
+		//the counts are kept up to date by triggers, so they change within the same transaction as the data
+		const QStringList createStatements {
+			QStringLiteral("CREATE TABLE IF NOT EXISTS TypeCounts ( "
+						   "	Type	TEXT NOT NULL, "
+						   "	Count	INTEGER NOT NULL, "
+						   "	PRIMARY KEY(Type) "
+						   ") WITHOUT ROWID;"),
+			QStringLiteral("INSERT OR IGNORE INTO TypeCounts (Type, Count) "
+						   "SELECT Type, Count(*) FROM DataIndex WHERE File IS NOT NULL GROUP BY Type;"),
+			QStringLiteral("CREATE TRIGGER IF NOT EXISTS TypeCountsInsert AFTER INSERT ON DataIndex "
+						   "WHEN NEW.File IS NOT NULL BEGIN "
+						   "	INSERT OR IGNORE INTO TypeCounts (Type, Count) VALUES(NEW.Type, 0); "
+						   "	UPDATE TypeCounts SET Count = Count + 1 WHERE Type = NEW.Type; "
+						   "END;"),
+			QStringLiteral("CREATE TRIGGER IF NOT EXISTS TypeCountsDelete AFTER DELETE ON DataIndex "
+						   "WHEN OLD.File IS NOT NULL BEGIN "
+						   "	UPDATE TypeCounts SET Count = Count - 1 WHERE Type = OLD.Type; "
+						   "END;"),
+			QStringLiteral("CREATE TRIGGER IF NOT EXISTS TypeCountsStore AFTER UPDATE OF File ON DataIndex "
+						   "WHEN OLD.File IS NULL AND NEW.File IS NOT NULL BEGIN "
+						   "	INSERT OR IGNORE INTO TypeCounts (Type, Count) VALUES(NEW.Type, 0); "
+						   "	UPDATE TypeCounts SET Count = Count + 1 WHERE Type = NEW.Type; "
+						   "END;"),
+			QStringLiteral("CREATE TRIGGER IF NOT EXISTS TypeCountsRemove AFTER UPDATE OF File ON DataIndex "
+						   "WHEN OLD.File IS NOT NULL AND NEW.File IS NULL BEGIN "
+						   "	UPDATE TypeCounts SET Count = Count - 1 WHERE Type = OLD.Type; "
+						   "END;")
+		};
+		//initial counts and triggers must be created atomically, or changes in between would get lost
+		beginWriteTransaction(QByteArray{QTDATASYNC_EXCEPTION_NAME(LocalStore)});
+		try {
+			for(const auto &statement : createStatements) {
+				QSqlQuery createQuery{_database};
+				createQuery.prepare(statement);
+				exec(createQuery, QByteArray{QTDATASYNC_EXCEPTION_NAME(LocalStore)});
+			}
+			if(!_database->commit())
+				throw LocalStoreException(_defaults, QByteArray{QTDATASYNC_EXCEPTION_NAME(LocalStore)}, _database->databaseName(), _database->lastError().text());
+		} catch(...) {
+			_database->rollback();
+			throw;
+		}
+		logDebug() << "Created TypeCounts table";
+	}
+
+	if(!_database->tables().contains(QStringLiteral("ChangeCounts"))) {
+		//Data counts the changed datasets, Device the uploads for added devices of datasets that are not deleted and unsynced.
+		//A dataset that gets deleted is handled before the cascade, as the device uploads cannot find it anymore afterwards
+		const QStringList createStatements {
+			QStringLiteral("CREATE TABLE IF NOT EXISTS ChangeCounts ( "
+						   "	Kind	TEXT NOT NULL, "
+						   "	Count	INTEGER NOT NULL, "
+						   "	PRIMARY KEY(Kind) "
+						   ") WITHOUT ROWID;"),
+			QStringLiteral("INSERT OR IGNORE INTO ChangeCounts (Kind, Count) "
+						   "SELECT 'Data', Count(*) FROM DataIndex WHERE Changed = 1;"),
+			QStringLiteral("INSERT OR IGNORE INTO ChangeCounts (Kind, Count) "
+						   "SELECT 'Device', Count(*) FROM DataIndex "
+						   "INNER JOIN DeviceUploads "
+						   "ON DataIndex.Type = DeviceUploads.Type "
+						   "AND DataIndex.Id = DeviceUploads.Id "
+						   "WHERE NOT (DataIndex.Changed = 1 AND File IS NULL);"),
+			QStringLiteral("CREATE TRIGGER IF NOT EXISTS ChangeCountsInsert AFTER INSERT ON DataIndex "
+						   "WHEN NEW.Changed = 1 BEGIN "
+						   "	UPDATE ChangeCounts SET Count = Count + 1 WHERE Kind = 'Data'; "
+						   "END;"),
+			QStringLiteral("CREATE TRIGGER IF NOT EXISTS ChangeCountsDelete BEFORE DELETE ON DataIndex BEGIN "
+						   "	UPDATE ChangeCounts SET Count = Count - 1 WHERE Kind = 'Data' AND OLD.Changed = 1; "
+						   "	UPDATE ChangeCounts SET Count = Count - (SELECT Count(*) FROM DeviceUploads WHERE Type = OLD.Type AND Id = OLD.Id) "
+						   "	WHERE Kind = 'Device' AND NOT (OLD.Changed = 1 AND OLD.File IS NULL); "
+						   "END;"),
+			QStringLiteral("CREATE TRIGGER IF NOT EXISTS ChangeCountsMark AFTER UPDATE OF Changed ON DataIndex "
+						   "WHEN (OLD.Changed = 1) <> (NEW.Changed = 1) BEGIN "
+						   "	UPDATE ChangeCounts SET Count = Count + (CASE WHEN NEW.Changed = 1 THEN 1 ELSE -1 END) WHERE Kind = 'Data'; "
+						   "END;"),
+			QStringLiteral("CREATE TRIGGER IF NOT EXISTS ChangeCountsHide AFTER UPDATE OF Changed, File ON DataIndex "
+						   "WHEN (OLD.Changed = 1 AND OLD.File IS NULL) <> (NEW.Changed = 1 AND NEW.File IS NULL) BEGIN "
+						   "	UPDATE ChangeCounts SET Count = Count + (CASE WHEN NEW.Changed = 1 AND NEW.File IS NULL THEN -1 ELSE 1 END) * "
+						   "		(SELECT Count(*) FROM DeviceUploads WHERE Type = NEW.Type AND Id = NEW.Id) "
+						   "	WHERE Kind = 'Device'; "
+						   "END;"),
+			QStringLiteral("CREATE TRIGGER IF NOT EXISTS ChangeCountsDeviceInsert AFTER INSERT ON DeviceUploads BEGIN "
+						   "	UPDATE ChangeCounts SET Count = Count + (SELECT Count(*) FROM DataIndex "
+						   "		WHERE Type = NEW.Type AND Id = NEW.Id AND NOT (Changed = 1 AND File IS NULL)) "
+						   "	WHERE Kind = 'Device'; "
+						   "END;"),
+			QStringLiteral("CREATE TRIGGER IF NOT EXISTS ChangeCountsDeviceDelete AFTER DELETE ON DeviceUploads BEGIN "
+						   "	UPDATE ChangeCounts SET Count = Count - (SELECT Count(*) FROM DataIndex "
+						   "		WHERE Type = OLD.Type AND Id = OLD.Id AND NOT (Changed = 1 AND File IS NULL)) "
+						   "	WHERE Kind = 'Device'; "
+						   "END;")
+		};
+		//same as for the type counts: initial counts and triggers must be created atomically
+		beginWriteTransaction(QByteArray{QTDATASYNC_EXCEPTION_NAME(LocalStore)});
+		try {
+			for(const auto &statement : createStatements) {
+				QSqlQuery createQuery{_database};
+				createQuery.prepare(statement);
+				exec(createQuery, QByteArray{QTDATASYNC_EXCEPTION_NAME(LocalStore)});
+			}
+			if(!_database->commit())
+				throw LocalStoreException(_defaults, QByteArray{QTDATASYNC_EXCEPTION_NAME(LocalStore)}, _database->databaseName(), _database->lastError().text());
+		} catch(...) {
+			_database->rollback();
+			throw;
+		}
+		logDebug() << "Created ChangeCounts table";
+	}
+
+	if(!_database->tables().contains(QStringLiteral("ContentIndex"))) {
+		const QStringList createStatements {
+			QStringLiteral("CREATE TABLE IF NOT EXISTS ContentKeys ( "
+						   "	RowId	INTEGER PRIMARY KEY, "
+						   "	Type	TEXT NOT NULL, "
+						   "	Id		TEXT NOT NULL, "
+						   "	UNIQUE(Type, Id) "
+						   ");"),
+			QStringLiteral("CREATE VIRTUAL TABLE IF NOT EXISTS ContentIndex USING fts5(Content);")
+		};
+		for(const auto &statement : createStatements) {
+			QSqlQuery createQuery{_database};
+			createQuery.prepare(statement);
+			if(!createQuery.exec()) {
+				//not fatal, only full text searches are unavailable then
+				logWarning() << "Failed to create full text index - searchText will not be available. Error:"
+							 << createQuery.lastError().text();
+				_hasContentIndex = false;
+				break;
+			}
+		}
+		if(_hasContentIndex)
+			logDebug() << "Created ContentIndex table";
+	}
+
 	try {
 		EventCursorPrivate::initDatabase(_defaults, _database, _logger, true);
 	} catch(EventCursorException &e) {
@@ -92,24 +325,23 @@ LocalStore::~LocalStore() = default;
 
 QJsonObject LocalStore::readJson(const ObjectKey &key, const QString &fileName, int *costs) const
 {
-	QFile file(filePath(key, fileName));
-	if(!file.open(QIODevice::ReadOnly))
-		throw LocalStoreException(_defaults, key, file.fileName(), file.errorString());
+	if(fileName != InlineFileName)
+		return readJson(key, fileName, QByteArray{}, costs);
 
-	auto doc = QJsonDocument::fromBinaryData(file.readAll());
-	if(costs)
-		*costs = static_cast<int>(file.size());
-	file.close();
+	CachedQuery dataQuery{_database, QStringLiteral("SELECT Data FROM DataIndex WHERE Type = ? AND Id = ? AND File IS NOT NULL")};
+	dataQuery.addBindValue(key.typeName);
+	dataQuery.addBindValue(key.id);
+	exec(dataQuery, key);
 
-	if(!doc.isObject())
-		throw LocalStoreException(_defaults, key, file.fileName(), QStringLiteral("File contains invalid json data"));
-	return doc.object();
+	if(dataQuery.first())
+		return readJson(key, fileName, dataQuery.value(0).toByteArray(), costs);
+	else
+		throw NoDataException(_defaults, key);
 }
 
 quint64 LocalStore::count(const QByteArray &typeName) const
 {
-	QSqlQuery countQuery(_database);
-	countQuery.prepare(QStringLiteral("SELECT Count(*) FROM DataIndex WHERE Type = ? AND File IS NOT NULL"));
+	CachedQuery countQuery{_database, QStringLiteral("SELECT Count FROM TypeCounts WHERE Type = ?")};
 	countQuery.addBindValue(typeName);
 	exec(countQuery, typeName);
 
@@ -121,8 +353,7 @@ quint64 LocalStore::count(const QByteArray &typeName) const
 
 QStringList LocalStore::keys(const QByteArray &typeName) const
 {
-	QSqlQuery keysQuery(_database);
-	keysQuery.prepare(QStringLiteral("SELECT Id FROM DataIndex WHERE Type = ? AND File IS NOT NULL"));
+	CachedQuery keysQuery{_database, QStringLiteral("SELECT Id FROM DataIndex WHERE Type = ? AND File IS NOT NULL")};
 	keysQuery.addBindValue(typeName);
 	exec(keysQuery, typeName);
 
@@ -132,30 +363,43 @@ QStringList LocalStore::keys(const QByteArray &typeName) const
 	return resList;
 }
 
+QStringList LocalStore::keys(const QByteArray &typeName, const QString &afterKey, int limit, bool reverse) const
+{
+	//keyset pagination: the primary key index is used to seek directly to the key after the last page
+	QStringList conditions {QStringLiteral("Type = ?")};
+	if(!afterKey.isNull())
+		conditions.append(reverse ? QStringLiteral("Id < ?") : QStringLiteral("Id > ?"));
+	conditions.append(QStringLiteral("File IS NOT NULL"));
+
+	CachedQuery keysQuery{_database, QStringLiteral("SELECT Id FROM DataIndex WHERE %1 ORDER BY Id %2 LIMIT ?")
+									 .arg(conditions.join(QStringLiteral(" AND ")),
+										  reverse ? QStringLiteral("DESC") : QStringLiteral("ASC"))};
+	keysQuery.addBindValue(typeName);
+	if(!afterKey.isNull())
+		keysQuery.addBindValue(afterKey);
+	keysQuery.addBindValue(limit < 0 ? -1 : limit);
+	exec(keysQuery, typeName);
+
+	QStringList resList;
+	if(limit > 0)
+		resList.reserve(limit);
+	while(keysQuery.next())
+		resList.append(keysQuery.value(0).toString());
+	return resList;
+}
+
 QList<QJsonObject> LocalStore::loadAll(const QByteArray &typeName) const
 {
-	//read transaction used to prevent writes while reading json files
+	//the read transaction only gives a snapshot of the index - in WAL mode, it does not block writers.
+	//json files can therefore be replaced or removed by a concurrent write while they are read.
 	beginReadTransaction(typeName);
 
 	try {
-		QSqlQuery loadQuery(_database);
-		loadQuery.prepare(QStringLiteral("SELECT Id, File FROM DataIndex WHERE Type = ? AND File IS NOT NULL"));
+		CachedQuery loadQuery{_database, QStringLiteral("SELECT Id, File, Data FROM DataIndex WHERE Type = ? AND File IS NOT NULL")};
 		loadQuery.addBindValue(typeName);
 		exec(loadQuery, typeName);
 
-		QList<ObjectKey> keys;
-		QList<QJsonObject> array;
-		QList<int> sizes;
-		while(loadQuery.next()) {
-			int size;
-			ObjectKey key {typeName, loadQuery.value(0).toString()};
-			auto json = readJson(key, loadQuery.value(1).toString(), &size);
-			keys.append(key);
-			array.append(json);
-			sizes.append(size);
-		}
-
-		_emitter->putCached(keys, array, sizes);
+		auto array = readAllJson(typeName, loadQuery);
 
 		//commit db
 		if(!_database->commit())
@@ -168,14 +412,26 @@ QList<QJsonObject> LocalStore::loadAll(const QByteArray &typeName) const
 	}
 }
 
+LocalStore::Cursor LocalStore::iterate(const QByteArray &typeName) const
+{
+	return Cursor{this, typeName};
+}
+
 bool LocalStore::contains(const ObjectKey &key) const
 {
-	QSqlQuery existsQuery(_database);
-	existsQuery.prepare(QStringLiteral("SELECT 1 FROM DataIndex WHERE Type = ? AND Id = ?"));
+	//check if cached
+	bool exists = false;
+	if(_emitter->getCachedExists(key, exists))
+		return exists;
+
+	const auto stamp = _emitter->cacheStamp();
+	CachedQuery existsQuery{_database, QStringLiteral("SELECT 1 FROM DataIndex WHERE Type = ? AND Id = ? AND File IS NOT NULL")};
 	existsQuery.addBindValue(key.typeName);
 	existsQuery.addBindValue(key.id);
 	exec(existsQuery, key);
-	return existsQuery.first();
+	exists = existsQuery.first();
+	_emitter->putCachedExists(key, exists, stamp);
+	return exists;
 }
 
 QJsonObject LocalStore::load(const ObjectKey &key) const
@@ -184,23 +440,54 @@ QJsonObject LocalStore::load(const ObjectKey &key) const
 	QJsonObject json;
 	if(_emitter->getCached(key, json))
 		return json;
+	bool exists = true;
+	if(_emitter->getCachedExists(key, exists) && !exists)
+		throw NoDataException(_defaults, key);
 
+	const auto stamp = _emitter->cacheStamp();
 	if(!_database->transaction())
 		throw LocalStoreException(_defaults, key, _database->databaseName(), _database->lastError().text());
 
 	try {
-		QSqlQuery loadQuery(_database);
-		loadQuery.prepare(QStringLiteral("SELECT File FROM DataIndex WHERE Type = ? AND Id = ? AND File IS NOT NULL"));
+		//passive setups first try the data of the primary, if it still has the version this transaction sees
+		if(_emitter->canReadShared()) {
+			CachedQuery versionQuery{_database, QStringLiteral("SELECT Version, Checksum FROM DataIndex WHERE Type = ? AND Id = ? AND File IS NOT NULL")};
+			versionQuery.addBindValue(key.typeName);
+			versionQuery.addBindValue(key.id);
+			exec(versionQuery, key);
+
+			QByteArray binData;
+			if(versionQuery.first() &&
+			   _emitter->getSharedCached(key, versionQuery.value(0).toULongLong(), versionQuery.value(1).toByteArray(), binData)) {
+				int size;
+				json = decodeJson(key, binData, QStringLiteral("shared cache"), &size);
+				_emitter->putCached(key, json, size);
+				if(!_database->commit())
+					throw LocalStoreException(_defaults, key, _database->databaseName(), _database->lastError().text());
+				return json;
+			}
+		}
+
+		CachedQuery loadQuery{_database, QStringLiteral("SELECT File, Data, Version, Checksum FROM DataIndex WHERE Type = ? AND Id = ? AND File IS NOT NULL")};
 		loadQuery.addBindValue(key.typeName);
 		loadQuery.addBindValue(key.id);
 		exec(loadQuery, key);
 
 		if(loadQuery.first()) {
 			int size;
-			json = readJson(key, loadQuery.value(0).toString(), &size);
+			json = readJson(key, loadQuery.value(0).toString(), loadQuery.value(1).toByteArray(), &size);
 			_emitter->putCached(key, json, size);
-		} else
+			//only serialize again if there is a segment to put it in
+			if(_emitter->hasSharedCache()) {
+				_emitter->putSharedCached(key,
+										  loadQuery.value(2).toULongLong(),
+										  loadQuery.value(3).toByteArray(),
+										  QJsonDocument(json).toBinaryData());
+			}
+		} else {
+			_emitter->putCachedExists(key, false, stamp);
 			throw NoDataException(_defaults, key);
+		}
 
 		//commit db
 		if(!_database->commit())
@@ -213,14 +500,43 @@ QJsonObject LocalStore::load(const ObjectKey &key) const
 	}
 }
 
+bool LocalStore::loadCachedValue(const ObjectKey &key, int metaTypeId, QVariant &value) const
+{
+	return _emitter->getCachedValue(key, metaTypeId, value);
+}
+
+void LocalStore::cacheValue(const ObjectKey &key, const QJsonObject &data, const QVariant &value) const
+{
+	_emitter->putCachedValue(key, data, value);
+}
+
+void LocalStore::subscribe(const QByteArray &typeName, const QString &keyPrefix)
+{
+	_emitter->subscribe(typeName, keyPrefix);
+}
+
+void LocalStore::unsubscribe(const QByteArray &typeName)
+{
+	_emitter->unsubscribe(typeName);
+}
+
+void LocalStore::unsubscribeAll()
+{
+	_emitter->unsubscribeAll();
+}
+
+void LocalStore::clearSubscriptions()
+{
+	_emitter->clearSubscriptions();
+}
+
 void LocalStore::save(const ObjectKey &key, const QJsonObject &data)
 {
 	beginWriteTransaction(key);
 
 	try {
 		//check if the file exists
-		QSqlQuery existQuery(_database);
-		existQuery.prepare(QStringLiteral("SELECT Version, File FROM DataIndex WHERE Type = ? AND Id = ?"));
+		CachedQuery existQuery{_database, QStringLiteral("SELECT Version, File FROM DataIndex WHERE Type = ? AND Id = ?")};
 		existQuery.addBindValue(key.typeName);
 		existQuery.addBindValue(key.id);
 		exec(existQuery, key);
@@ -258,8 +574,7 @@ bool LocalStore::remove(const ObjectKey &key)
 
 	try {
 		//load data of existing entry
-		QSqlQuery loadQuery(_database);
-		loadQuery.prepare(QStringLiteral("SELECT Version, File FROM DataIndex WHERE Type = ? AND Id = ? AND File IS NOT NULL"));
+		CachedQuery loadQuery{_database, QStringLiteral("SELECT Version, File FROM DataIndex WHERE Type = ? AND Id = ? AND File IS NOT NULL")};
 		loadQuery.addBindValue(key.typeName);
 		loadQuery.addBindValue(key.id);
 		exec(loadQuery, key);
@@ -268,24 +583,27 @@ bool LocalStore::remove(const ObjectKey &key)
 			auto version = loadQuery.value(0).toULongLong() + 1;
 
 			//"remove" from db
-			QSqlQuery removeQuery(_database);
-			removeQuery.prepare(QStringLiteral("UPDATE DataIndex SET Version = ?, File = NULL, Checksum = NULL, Changed = 1 WHERE Type = ? AND Id = ?"));
+			CachedQuery removeQuery{_database, QStringLiteral("UPDATE DataIndex SET Version = ?, File = NULL, Checksum = NULL, Changed = 1, Data = NULL WHERE Type = ? AND Id = ?")};
 			removeQuery.addBindValue(version);
 			removeQuery.addBindValue(key.typeName);
 			removeQuery.addBindValue(key.id);
 			exec(removeQuery, key);
+			removeIndexes(_database, key);
 
 			//delete the file
-			QFile rmFile(filePath(key, loadQuery.value(1).toString()));
-			if(!rmFile.remove())
-				throw LocalStoreException(_defaults, key, rmFile.fileName(), rmFile.errorString());
+			auto fileName = loadQuery.value(1).toString();
+			if(fileName != InlineFileName) {
+				QFile rmFile(filePath(key, fileName));
+				if(!rmFile.remove())
+					throw LocalStoreException(_defaults, key, rmFile.fileName(), rmFile.errorString());
+			}
 
 			//commit db
 			if(!_database->commit())
 				throw LocalStoreException(_defaults, key, _database->databaseName(), _database->lastError().text());
 
 			//update cache
-			_emitter->dropCached(key);
+			_emitter->markCachedDeleted(key);
 			//trigger change signals
 			_emitter->triggerChange(key, true, true);
 
@@ -302,66 +620,189 @@ bool LocalStore::remove(const ObjectKey &key)
 	}
 }
 
-QList<QJsonObject> LocalStore::find(const QByteArray &typeName, const QString &query, DataStore::SearchMode mode) const
+void LocalStore::saveAll(const QByteArray &typeName, const QList<QPair<QString, QJsonObject>> &data)
 {
-	auto searchQuery = query;
-	if(mode != DataStore::RegexpMode) { //escape any of the like wildcard literals
-		if(mode != DataStore::WildcardMode)
-			searchQuery.replace(QLatin1Char('\\'), QStringLiteral("\\\\"));
-		searchQuery.replace(QLatin1Char('%'), QStringLiteral("\\%"));
-		searchQuery.replace(QLatin1Char('_'), QStringLiteral("\\_"));
-	}
+	if(data.isEmpty())
+		return;
 
-	switch(mode) {
-	case DataStore::WildcardMode:
-	{
-		//replace any unescaped * or ? by % and _
-		const QRegularExpression searchRepRegex1(QStringLiteral(R"__(((?<!\\)(?:\\\\)*)\*)__"));
-		const QRegularExpression searchRepRegex2(QStringLiteral(R"__(((?<!\\)(?:\\\\)*)\?)__"));
-		searchQuery.replace(searchRepRegex1, QStringLiteral("\\1%"));
-		searchQuery.replace(searchRepRegex2, QStringLiteral("\\1_"));
-		break;
+	ObjectKey typeKey{typeName};
+	beginWriteTransaction(typeKey);
+
+	QStringList ids;
+	ids.reserve(data.size());
+	try {
+		//prepare once, reuse for every dataset
+		CachedQuery existQuery{_database, QStringLiteral("SELECT Version, File FROM DataIndex WHERE Type = ? AND Id = ?")};
+
+		QStringList obsoleteFiles;
+		for(const auto &entry : data) {
+			ObjectKey key{typeName, entry.first};
+			ids.append(key.id);
+
+			existQuery.addBindValue(key.typeName);
+			existQuery.addBindValue(key.id);
+			exec(existQuery, key);
+
+			quint64 version = 1ull;
+			bool existing = existQuery.first();
+			if(existing)
+				version = existQuery.value(0).toULongLong() + 1ull;
+
+			auto obsoleteFile = storeDataImpl(_database,
+											  key,
+											  version,
+											  existing ? existQuery.value(1).toString() : QString(),
+											  entry.second,
+											  true,
+											  existing);
+			if(!obsoleteFile.isNull())
+				obsoleteFiles.append(obsoleteFile);
+		}
+
+		//commit database changes
+		if(!_database->commit())
+			throw LocalStoreException(_defaults, typeKey, _database->databaseName(), _database->lastError().text());
+
+		_emitter->touchCached();
+		for(const auto &obsoleteFile : qAsConst(obsoleteFiles))
+			removeObsoleteFile(obsoleteFile);
+		//trigger change signals once for the whole batch
+		_emitter->triggerChange(typeName, ids, false, true);
+	} catch(...) {
+		_emitter->dropCached(typeName, ids);
+		_database->rollback();
+		throw;
 	}
-	case DataStore::ContainsMode:
-		searchQuery = QLatin1Char('%') + searchQuery + QLatin1Char('%');
-		break;
-	case DataStore::StartsWithMode:
-		searchQuery = searchQuery + QLatin1Char('%');
-		break;
-	case DataStore::EndsWithMode:
-		searchQuery = QLatin1Char('%') + searchQuery;
-		break;
-	default:
-		break;
+}
+
+int LocalStore::removeAll(const QByteArray &typeName, const QStringList &ids)
+{
+	if(ids.isEmpty())
+		return 0;
+
+	ObjectKey typeKey{typeName};
+	beginWriteTransaction(typeKey);
+
+	try {
+		//prepare once, reuse for every dataset
+		CachedQuery loadQuery{_database, QStringLiteral("SELECT Version, File FROM DataIndex WHERE Type = ? AND Id = ? AND File IS NOT NULL")};
+		CachedQuery removeQuery{_database, QStringLiteral("UPDATE DataIndex SET Version = ?, File = NULL, Checksum = NULL, Changed = 1, Data = NULL WHERE Type = ? AND Id = ?")};
+
+		QStringList removedIds;
+		QStringList removedFiles;
+		for(const auto &id : ids) {
+			ObjectKey key{typeName, id};
+			loadQuery.addBindValue(key.typeName);
+			loadQuery.addBindValue(key.id);
+			exec(loadQuery, key);
+			if(!loadQuery.first()) //not stored (or already removed in this batch) -> skip
+				continue;
+
+			removeQuery.addBindValue(loadQuery.value(0).toULongLong() + 1);
+			removeQuery.addBindValue(key.typeName);
+			removeQuery.addBindValue(key.id);
+			exec(removeQuery, key);
+			removeIndexes(_database, key);
+
+			auto fileName = loadQuery.value(1).toString();
+			if(fileName != InlineFileName)
+				removedFiles.append(filePath(key, fileName));
+			removedIds.append(key.id);
+		}
+
+		//commit db
+		if(!_database->commit())
+			throw LocalStoreException(_defaults, typeKey, _database->databaseName(), _database->lastError().text());
+
+		//delete the files only after the commit, so a failed batch leaves all of them intact
+		for(const auto &removedFile : qAsConst(removedFiles))
+			removeObsoleteFile(removedFile);
+
+		if(!removedIds.isEmpty()) {
+			//update cache
+			_emitter->markCachedDeleted(typeName, removedIds);
+			//trigger change signals once for the whole batch
+			_emitter->triggerChange(typeName, removedIds, true, true);
+		}
+		return removedIds.size();
+	} catch(...) {
+		_database->rollback();
+		throw;
 	}
+}
+
+QList<QJsonObject> LocalStore::find(const QByteArray &typeName, const QString &query, DataStore::SearchMode mode, int offset, int limit) const
+{
+	const auto plan = planSearch(query, mode);
 
 	beginReadTransaction(typeName);
 
 	try {
-		QSqlQuery findQuery(_database);
-		auto queryStr = QStringLiteral("SELECT Id, File FROM DataIndex WHERE Type = ? AND %1 AND File IS NOT NULL");
-		if(mode == DataStore::RegexpMode)
-			queryStr = queryStr.arg(QStringLiteral("Id REGEXP ?"));
-		else
-			queryStr = queryStr.arg(QStringLiteral("Id LIKE ? ESCAPE '\\'"));
-		findQuery.prepare(queryStr);
+		QStringList conditions {QStringLiteral("Type = ?")};
+		if(!plan.lowerBound.isNull())
+			conditions.append(QStringLiteral("Id >= ?"));
+		if(!plan.upperBound.isNull())
+			conditions.append(QStringLiteral("Id < ?"));
+		if(!plan.filter.isNull())
+			conditions.append(plan.filter);
+		conditions.append(QStringLiteral("File IS NOT NULL"));
+
+		CachedQuery findQuery{_database, QStringLiteral("SELECT Id, File, Data FROM DataIndex WHERE %1 ORDER BY Id LIMIT ? OFFSET ?")
+										 .arg(conditions.join(QStringLiteral(" AND ")))};
 		findQuery.addBindValue(typeName);
-		findQuery.addBindValue(searchQuery);
+		if(!plan.lowerBound.isNull())
+			findQuery.addBindValue(plan.lowerBound);
+		if(!plan.upperBound.isNull())
+			findQuery.addBindValue(plan.upperBound);
+		if(!plan.filter.isNull())
+			findQuery.addBindValue(plan.filterArg);
+		findQuery.addBindValue(limit < 0 ? -1 : limit);
+		findQuery.addBindValue(std::max(offset, 0));
 		exec(findQuery, typeName);
 
-		QList<ObjectKey> keys;
-		QList<QJsonObject> array;
-		QList<int> sizes;
-		while(findQuery.next()) {
-			int size;
-			ObjectKey key {typeName, findQuery.value(0).toString()};
-			auto json = readJson(key, findQuery.value(1).toString(), &size);
-			keys.append(key);
-			array.append(json);
-			sizes.append(size);
-		}
+		auto array = readAllJson(typeName, findQuery);
 
-		_emitter->putCached(keys, array, sizes);
+		if(!_database->commit())
+			throw LocalStoreException(_defaults, typeName, _database->databaseName(), _database->lastError().text());
+
+		return array;
+	} catch(...) {
+		_database->rollback();
+		throw;
+	}
+}
+
+QList<QJsonObject> LocalStore::findBy(const QByteArray &typeName, const QString &property, const QJsonValue &from, const QJsonValue &to) const
+{
+	if(!indexedProperties(typeName, PropertyIndexKind).contains(property)) {
+		throw LocalStoreException(_defaults, typeName, property,
+								  QStringLiteral("Property is not declared as indexed via the \"%1\" class info")
+								  .arg(QString::fromUtf8(IndexClassInfo)));
+	}
+	const auto fromValue = indexValue(from);
+	const auto toValue = indexValue(to);
+	if(!fromValue.isValid() || !toValue.isValid()) {
+		throw LocalStoreException(_defaults, typeName, property,
+								  QStringLiteral("Only boolean, numeric and string values can be used to query an index"));
+	}
+
+	beginReadTransaction(typeName);
+
+	try {
+		CachedQuery findQuery{_database, QStringLiteral("SELECT DataIndex.Id, DataIndex.File, DataIndex.Data "
+														"FROM PropertyIndex INNER JOIN DataIndex "
+														"ON PropertyIndex.Type = DataIndex.Type AND PropertyIndex.Id = DataIndex.Id "
+														"WHERE PropertyIndex.Type = ? AND PropertyIndex.Property = ? "
+														"AND PropertyIndex.Value >= ? AND PropertyIndex.Value <= ? "
+														"AND DataIndex.File IS NOT NULL "
+														"ORDER BY PropertyIndex.Value, PropertyIndex.Id")};
+		findQuery.addBindValue(typeName);
+		findQuery.addBindValue(property);
+		findQuery.addBindValue(fromValue);
+		findQuery.addBindValue(toValue);
+		exec(findQuery, typeName);
+
+		auto array = readAllJson(typeName, findQuery);
 
 		if(!_database->commit())
 			throw LocalStoreException(_defaults, typeName, _database->databaseName(), _database->lastError().text());
@@ -373,15 +814,43 @@ QList<QJsonObject> LocalStore::find(const QByteArray &typeName, const QString &q
 	}
 }
 
+QStringList LocalStore::searchText(const QByteArray &typeName, const QString &query, int limit) const
+{
+	if(!_hasContentIndex) {
+		throw LocalStoreException(_defaults, typeName, _database->databaseName(),
+								  QStringLiteral("The sqlite driver does not support FTS5 full text indexes"));
+	}
+	if(indexedProperties(typeName, ContentIndexKind).isEmpty()) {
+		throw LocalStoreException(_defaults, typeName, query,
+								  QStringLiteral("Type has no properties declared as full text indexed via the \"%1\" class info")
+								  .arg(QString::fromUtf8(ContentClassInfo)));
+	}
+
+	CachedQuery searchQuery{_database, QStringLiteral("SELECT ContentKeys.Id "
+													  "FROM ContentIndex INNER JOIN ContentKeys "
+													  "ON ContentKeys.RowId = ContentIndex.rowid "
+													  "WHERE ContentIndex MATCH ? AND ContentKeys.Type = ? "
+													  "ORDER BY ContentIndex.rank "
+													  "LIMIT ?")};
+	searchQuery.addBindValue(query);
+	searchQuery.addBindValue(typeName);
+	searchQuery.addBindValue(limit < 0 ? -1 : limit);
+	exec(searchQuery, typeName);
+
+	QStringList resList;
+	while(searchQuery.next())
+		resList.append(searchQuery.value(0).toString());
+	return resList;
+}
+
 void LocalStore::clear(const QByteArray &typeName)
 {
 	beginWriteTransaction(typeName, true);
 
 	try {
 		// get all keys that are to be cleared
-		QSqlQuery clearInfoQuery(_database);
-		clearInfoQuery.prepare(QStringLiteral("SELECT Id FROM DataIndex "
-											  "WHERE Type = ? AND File IS NOT NULL"));
+		CachedQuery clearInfoQuery{_database, QStringLiteral("SELECT Id FROM DataIndex "
+															 "WHERE Type = ? AND File IS NOT NULL")};
 		clearInfoQuery.addBindValue(typeName);
 		exec(clearInfoQuery, typeName);
 		QStringList clearKeys;
@@ -389,13 +858,15 @@ void LocalStore::clear(const QByteArray &typeName)
 			clearKeys.append(clearInfoQuery.value(0).toString());
 
 		// clear them
-		QSqlQuery clearQuery(_database);
-		clearQuery.prepare(QStringLiteral("UPDATE DataIndex "
-										  "SET Version = Version + 1, File = NULL, Checksum = NULL, Changed = 1 "
-										  "WHERE Type = ? AND File IS NOT NULL"));
+		CachedQuery clearQuery{_database, QStringLiteral("UPDATE DataIndex "
+														 "SET Version = Version + 1, File = NULL, Checksum = NULL, Changed = 1, Data = NULL "
+														 "WHERE Type = ? AND File IS NOT NULL")};
 		clearQuery.addBindValue(typeName);
 		exec(clearQuery, typeName);
 
+		dropIndex(_database, typeName, PropertyIndexKind);
+		dropIndex(_database, typeName, ContentIndexKind);
+
 		auto tableDir = typeDirectory(typeName);
 		if(!tableDir.removeRecursively()) {
 			logWarning() << "Failed to delete cleared data directory for type"
@@ -406,7 +877,7 @@ void LocalStore::clear(const QByteArray &typeName)
 			throw LocalStoreException(_defaults, typeName, _database->databaseName(), _database->lastError().text());
 
 		//clear cache
-		_emitter->dropCached(typeName, clearKeys);
+		_emitter->markCachedDeleted(typeName, clearKeys);
 		//trigger change signals
 		_emitter->triggerClear(typeName, clearKeys);
 	} catch(...) {
@@ -434,6 +905,23 @@ void LocalStore::reset(bool keepData)
 			resetQuery.prepare(QStringLiteral("DELETE FROM DataIndex"));
 			exec(resetQuery);
 
+			//the indexes only reference deleted data now -> empty them as well
+			QSqlQuery resetIndexQuery(_database);
+			resetIndexQuery.prepare(QStringLiteral("DELETE FROM IndexInfo"));
+			exec(resetIndexQuery);
+			_verifiedIndexes.clear();
+			QSqlQuery resetWarmupQuery(_database);
+			resetWarmupQuery.prepare(QStringLiteral("DELETE FROM CacheWarmup"));
+			exec(resetWarmupQuery);
+			if(_hasContentIndex) {
+				QSqlQuery resetContentQuery(_database);
+				resetContentQuery.prepare(QStringLiteral("DELETE FROM ContentIndex"));
+				exec(resetContentQuery);
+				QSqlQuery resetKeysQuery(_database);
+				resetKeysQuery.prepare(QStringLiteral("DELETE FROM ContentKeys"));
+				exec(resetKeysQuery);
+			}
+
 			// clear eventlog
 			try {
 				EventCursorPrivate::clearEventLog(_defaults, _database);
@@ -479,17 +967,8 @@ void LocalStore::reset(bool keepData)
 
 quint32 LocalStore::changeCount() const
 {
-	QSqlQuery countQuery(_database);
-	countQuery.prepare(QStringLiteral("SELECT Sum(rows) FROM ( "
-									  "		SELECT Count(*) AS rows FROM DataIndex "
-									  "		WHERE Changed = 1"
-									  "		UNION ALL"
-									  "		SELECT Count(*) AS rows FROM DataIndex "
-									  "		INNER JOIN DeviceUploads "
-									  "		ON DataIndex.Type = DeviceUploads.Type "
-									  "		AND DataIndex.Id = DeviceUploads.Id "
-									  "		WHERE NOT (DataIndex.Changed = 1 AND File IS NULL)"
-									  ")"));
+	//maintained by triggers, see the ChangeCounts table
+	CachedQuery countQuery{_database, QStringLiteral("SELECT Sum(Count) FROM ChangeCounts")};
 	exec(countQuery);
 
 	if(countQuery.first())
@@ -500,47 +979,93 @@ quint32 LocalStore::changeCount() const
 
 void LocalStore::loadChanges(int limit, const function<bool(ObjectKey, quint64, QString, QUuid)> &visitor) const
 {
+	ChangeCursor cursor;
+	loadChanges(limit, cursor, visitor);
+}
+
+void LocalStore::loadChanges(int limit, ChangeCursor &cursor, const function<bool(ObjectKey, quint64, QString, QUuid)> &visitor) const
+{
+	if(cursor.done || limit <= 0)
+		return;
+
 	beginReadTransaction();
 
 	try {
-		QSqlQuery readChangesQuery(_database);
-		readChangesQuery.prepare(QStringLiteral("SELECT Type, Id, Version, File FROM DataIndex WHERE Changed = 1 LIMIT ?"));
-		readChangesQuery.addBindValue(limit);
-		exec(readChangesQuery);
-
 		auto cnt = 0;
 		auto skip = false;
-		while(readChangesQuery.next()) {
-			cnt++;
-			if(!visitor({readChangesQuery.value(0).toByteArray(), readChangesQuery.value(1).toString()},
-						readChangesQuery.value(2).toULongLong(),
-						readChangesQuery.value(3).toString(),
-						QUuid())) {
-				skip = true;
-				break;
+		if(!cursor.devicePhase) {
+			//walks the DataIndexChanged index, starting after the last visited change
+			const auto fromStart = cursor.key.typeName.isNull();
+			CachedQuery readChangesQuery{_database, fromStart ?
+											 QStringLiteral("SELECT Type, Id, Version, File FROM DataIndex "
+															"WHERE Changed = 1 "
+															"ORDER BY Type, Id LIMIT ?") :
+											 QStringLiteral("SELECT Type, Id, Version, File FROM DataIndex "
+															"WHERE Changed = 1 AND (Type, Id) > (?, ?) "
+															"ORDER BY Type, Id LIMIT ?")};
+			if(!fromStart) {
+				readChangesQuery.addBindValue(cursor.key.typeName);
+				readChangesQuery.addBindValue(cursor.key.id);
+			}
+			readChangesQuery.addBindValue(limit);
+			exec(readChangesQuery);
+
+			while(readChangesQuery.next()) {
+				cnt++;
+				cursor.key = {readChangesQuery.value(0).toByteArray(), readChangesQuery.value(1).toString()};
+				if(!visitor(cursor.key,
+							readChangesQuery.value(2).toULongLong(),
+							readChangesQuery.value(3).toString(),
+							QUuid())) {
+					skip = true;
+					break;
+				}
+			}
+
+			//less than requested -> all changed datasets have been visited
+			if(!skip && cnt < limit) {
+				cursor.devicePhase = true;
+				cursor.key = {};
 			}
 		}
 
 		if(!skip && cnt < limit) {
-			QSqlQuery readDeviceChangesQuery(_database);
-			readDeviceChangesQuery.prepare(QStringLiteral("SELECT DeviceUploads.Type, DeviceUploads.Id, DataIndex.Version, DataIndex.File, DeviceUploads.Device "
-														  "FROM DeviceUploads "
-														  "INNER JOIN DataIndex "
-														  "ON (DeviceUploads.Type = DataIndex.Type AND DeviceUploads.Id = DataIndex.Id) "
-														  "WHERE NOT (DataIndex.Changed = 1 AND File IS NULL) " //only those that haven't been operated on before
-														  "LIMIT ?"));
+			const auto fromStart = cursor.key.typeName.isNull();
+			CachedQuery readDeviceChangesQuery{_database, QStringLiteral("SELECT DeviceUploads.Type, DeviceUploads.Id, DataIndex.Version, DataIndex.File, DeviceUploads.Device "
+																		 "FROM DeviceUploads "
+																		 "INNER JOIN DataIndex "
+																		 "ON (DeviceUploads.Type = DataIndex.Type AND DeviceUploads.Id = DataIndex.Id) "
+																		 "WHERE NOT (DataIndex.Changed = 1 AND File IS NULL) " //only those that haven't been operated on before
+																		 "%1"
+																		 "ORDER BY DeviceUploads.Type, DeviceUploads.Id, DeviceUploads.Device "
+																		 "LIMIT ?")
+															   .arg(fromStart ?
+																		QString() :
+																		QStringLiteral("AND (DeviceUploads.Type, DeviceUploads.Id, DeviceUploads.Device) > (?, ?, ?) "))};
+			if(!fromStart) {
+				readDeviceChangesQuery.addBindValue(cursor.key.typeName);
+				readDeviceChangesQuery.addBindValue(cursor.key.id);
+				readDeviceChangesQuery.addBindValue(cursor.deviceId);
+			}
 			readDeviceChangesQuery.addBindValue(limit - cnt);
 			exec(readDeviceChangesQuery);
 
+			auto devCnt = 0;
 			while(readDeviceChangesQuery.next()) {
-				if(!visitor({readDeviceChangesQuery.value(0).toByteArray(), readDeviceChangesQuery.value(1).toString()},
+				devCnt++;
+				cursor.key = {readDeviceChangesQuery.value(0).toByteArray(), readDeviceChangesQuery.value(1).toString()};
+				cursor.deviceId = readDeviceChangesQuery.value(4).toUuid();
+				if(!visitor(cursor.key,
 							readDeviceChangesQuery.value(2).toULongLong(),
 							readDeviceChangesQuery.value(3).toString(),
-							readDeviceChangesQuery.value(4).toUuid())) {
+							cursor.deviceId)) {
 					skip = true;
 					break;
 				}
 			}
+
+			if(!skip && devCnt < limit - cnt)
+				cursor.done = true;
 		}
 
 		if(!_database->commit())
@@ -558,8 +1083,7 @@ void LocalStore::markUnchanged(const ObjectKey &key, quint64 version, bool isDel
 
 void LocalStore::removeDeviceChange(const ObjectKey &key, QUuid deviceId)
 {
-	QSqlQuery rmDeviceQuery(_database);
-	rmDeviceQuery.prepare(QStringLiteral("DELETE FROM DeviceUploads WHERE Type = ? AND Id = ? AND Device = ?"));
+	CachedQuery rmDeviceQuery{_database, QStringLiteral("DELETE FROM DeviceUploads WHERE Type = ? AND Id = ? AND Device = ?")};
 	rmDeviceQuery.addBindValue(key.typeName);
 	rmDeviceQuery.addBindValue(key.id);
 	rmDeviceQuery.addBindValue(deviceId);
@@ -575,8 +1099,7 @@ tuple<LocalStore::ChangeType, quint64, QString, QByteArray> LocalStore::loadChan
 {
 	SCOPE_ASSERT();
 
-	QSqlQuery loadChangeQuery(scope.d->database);
-	loadChangeQuery.prepare(QStringLiteral("SELECT Version, File, Checksum FROM DataIndex WHERE Type = ? AND Id = ?"));
+	CachedQuery loadChangeQuery{scope.d->database, QStringLiteral("SELECT Version, File, Checksum FROM DataIndex WHERE Type = ? AND Id = ?")};
 	loadChangeQuery.addBindValue(scope.d->key.typeName);
 	loadChangeQuery.addBindValue(scope.d->key.id);
 	exec(loadChangeQuery);
@@ -596,8 +1119,7 @@ tuple<LocalStore::ChangeType, quint64, QString, QByteArray> LocalStore::loadChan
 void LocalStore::updateVersion(SyncScope &scope, quint64 oldVersion, quint64 newVersion, bool changed)
 {
 	SCOPE_ASSERT();
-	QSqlQuery updateQuery(scope.d->database);
-	updateQuery.prepare(QStringLiteral("UPDATE DataIndex SET Version = ?, Changed = ? WHERE Type = ? AND Id = ? AND Version = ?"));
+	CachedQuery updateQuery{scope.d->database, QStringLiteral("UPDATE DataIndex SET Version = ?, Changed = ? WHERE Type = ? AND Id = ? AND Version = ?")};
 	updateQuery.addBindValue(newVersion);
 	updateQuery.addBindValue(changed);
 	updateQuery.addBindValue(scope.d->key.typeName);
@@ -631,13 +1153,12 @@ void LocalStore::storeDeleted(SyncScope &scope, quint64 version, bool changed, C
 	switch (localState) {
 	case Exists:
 	{
-		QSqlQuery loadQuery(scope.d->database);
-		loadQuery.prepare(QStringLiteral("SELECT File FROM DataIndex WHERE Type = ? AND Id = ? AND File IS NOT NULL"));
+		CachedQuery loadQuery{scope.d->database, QStringLiteral("SELECT File FROM DataIndex WHERE Type = ? AND Id = ? AND File IS NOT NULL")};
 		loadQuery.addBindValue(scope.d->key.typeName);
 		loadQuery.addBindValue(scope.d->key.id);
 		exec(loadQuery, scope.d->key);
 
-		if(loadQuery.first())
+		if(loadQuery.first() && loadQuery.value(0).toString() != InlineFileName)
 			fileName = filePath(scope.d->key, loadQuery.value(0).toString());
 		Q_FALLTHROUGH();
 	}
@@ -653,16 +1174,15 @@ void LocalStore::storeDeleted(SyncScope &scope, quint64 version, bool changed, C
 	}
 
 	if(existing) {
-		QSqlQuery updateQuery(scope.d->database);
-		updateQuery.prepare(QStringLiteral("UPDATE DataIndex SET Version = ?, File = NULL, Checksum = NULL, Changed = ? WHERE Type = ? AND Id = ?"));
+		CachedQuery updateQuery{scope.d->database, QStringLiteral("UPDATE DataIndex SET Version = ?, File = NULL, Checksum = NULL, Changed = ?, Data = NULL WHERE Type = ? AND Id = ?")};
 		updateQuery.addBindValue(version);
 		updateQuery.addBindValue(changed);
 		updateQuery.addBindValue(scope.d->key.typeName);
 		updateQuery.addBindValue(scope.d->key.id);
 		exec(updateQuery, scope.d->key);
+		removeIndexes(scope.d->database, scope.d->key);
 	} else {
-		QSqlQuery insertQuery(scope.d->database);
-		insertQuery.prepare(QStringLiteral("INSERT INTO DataIndex (Type, Id, Version, File, Checksum, Changed) VALUES(?, ?, ?, NULL, NULL, ?)"));
+		CachedQuery insertQuery{scope.d->database, QStringLiteral("INSERT INTO DataIndex (Type, Id, Version, File, Checksum, Changed) VALUES(?, ?, ?, NULL, NULL, ?)")};
 		insertQuery.addBindValue(scope.d->key.typeName);
 		insertQuery.addBindValue(scope.d->key.id);
 		insertQuery.addBindValue(version);
@@ -682,7 +1202,7 @@ void LocalStore::storeDeleted(SyncScope &scope, quint64 version, bool changed, C
 		auto key = scope.d->key;
 		scope.d->afterCommit = [this, key, changed]() {
 			//update cache
-			_emitter->dropCached(key);
+			_emitter->markCachedDeleted(key);
 			//notify others
 			_emitter->triggerChange(key, true, changed);
 		};
@@ -716,9 +1236,8 @@ void LocalStore::commitSync(SyncScope &scope) const
 void LocalStore::prepareAccountAdded(QUuid deviceId)
 {
 	try {
-		QSqlQuery insertQuery(_database);
-		insertQuery.prepare(QStringLiteral("INSERT OR REPLACE INTO DeviceUploads (Type, Id, Device) "
-										   "SELECT Type, Id, ? FROM DataIndex"));
+		CachedQuery insertQuery{_database, QStringLiteral("INSERT OR IGNORE INTO DeviceUploads (Type, Id, Device) "
+														  "SELECT Type, Id, ? FROM DataIndex")};
 		insertQuery.addBindValue(deviceId);
 		exec(insertQuery);
 
@@ -729,6 +1248,323 @@ void LocalStore::prepareAccountAdded(QUuid deviceId)
 	}
 }
 
+void LocalStore::migrateStorage()
+{
+	if(storageMode() != Setup::StorageMode::Inline)
+		return;
+
+	QStringList migratedFiles;
+	auto failedCount = 0;
+	beginWriteTransaction(ObjectKey{"any"}, true);
+
+	try {
+		// collect all datasets that are still stored as files
+		QSqlQuery filesQuery(_database);
+		filesQuery.prepare(QStringLiteral("SELECT Type, Id, File FROM DataIndex "
+										  "WHERE File IS NOT NULL AND File != ?"));
+		filesQuery.addBindValue(InlineFileName);
+		exec(filesQuery);
+		QList<QPair<ObjectKey, QString>> fileEntries;
+		while(filesQuery.next()) {
+			fileEntries.append({
+				{filesQuery.value(0).toByteArray(), filesQuery.value(1).toString()},
+				filesQuery.value(2).toString()
+			});
+		}
+
+		// move the file contents into the database
+		for(const auto &entry : qAsConst(fileEntries)) {
+			QFile file(filePath(entry.first, entry.second));
+			if(!file.open(QIODevice::ReadOnly)) {
+				logWarning() << "Unable to migrate data file of" << entry.first
+							 << "with error:" << file.errorString();
+				failedCount++;
+				continue;
+			}
+
+			QSqlQuery migrateQuery(_database);
+			migrateQuery.prepare(QStringLiteral("UPDATE DataIndex SET File = ?, Data = ? WHERE Type = ? AND Id = ?"));
+			migrateQuery.addBindValue(InlineFileName);
+			migrateQuery.addBindValue(file.readAll());
+			migrateQuery.addBindValue(entry.first.typeName);
+			migrateQuery.addBindValue(entry.first.id);
+			exec(migrateQuery, entry.first);
+			file.close();
+			migratedFiles.append(file.fileName());
+		}
+
+		if(!_database->commit())
+			throw LocalStoreException(_defaults, QByteArray("any"), _database->databaseName(), _database->lastError().text());
+
+		if(!migratedFiles.isEmpty())
+			logInfo() << "Migrated" << migratedFiles.size() << "datasets to inline storage";
+	} catch(...) {
+		_database->rollback();
+		throw;
+	}
+
+	//remove only the migrated files - everything else stays, so nothing that failed is lost
+	for(const auto &fileName : qAsConst(migratedFiles)) {
+		if(!QFile::remove(fileName))
+			logWarning() << "Failed to delete migrated data file" << fileName;
+	}
+	auto tableDir = _defaults.storageDir();
+	if(tableDir.cd(QStringLiteral("store"))) {
+		for(const auto &typeDir : tableDir.entryList(QDir::Dirs | QDir::NoDotAndDotDot))
+			tableDir.rmdir(typeDir); //only succeeds for empty directories
+		tableDir.cdUp();
+		tableDir.rmdir(QStringLiteral("store"));
+	}
+	if(failedCount > 0) {
+		logWarning() << failedCount << "datasets could not be migrated to inline storage."
+					 << "Their files are kept and the migration is retried with the next start";
+	}
+}
+
+void LocalStore::prepareIndexes()
+{
+	//types stored before their index was declared (or changed) are not written again by themselves
+	QSqlQuery typesQuery(_database);
+	typesQuery.prepare(QStringLiteral("SELECT DISTINCT Type FROM DataIndex UNION SELECT DISTINCT Type FROM IndexInfo"));
+	exec(typesQuery);
+	QList<QByteArray> typeNames;
+	while(typesQuery.next())
+		typeNames.append(typesQuery.value(0).toByteArray());
+	typesQuery.finish();
+
+	for(const auto &typeName : typeNames) {
+		if(QThread::currentThread()->isInterruptionRequested())
+			return;
+
+		//one transaction per type, so writers of other types are only held back briefly
+		beginWriteTransaction(typeName);
+		try {
+			prepareIndexes(_database, typeName);
+			if(!_database->commit())
+				throw LocalStoreException(_defaults, typeName, _database->databaseName(), _database->lastError().text());
+		} catch(...) {
+			_database->rollback();
+			throw;
+		}
+	}
+}
+
+bool LocalStore::enableIncrementalVacuum()
+{
+	//switching the vacuum mode needs a full vacuum, which rewrites the whole database
+	QSqlQuery vacuumModeQuery(_database);
+	vacuumModeQuery.prepare(QStringLiteral("PRAGMA auto_vacuum"));
+	exec(vacuumModeQuery);
+	if(vacuumModeQuery.first() && vacuumModeQuery.value(0).toInt() == 2) //2 = INCREMENTAL
+		return false;
+	vacuumModeQuery.finish();
+
+	QSqlQuery vacuumQuery(_database);
+	if(!vacuumQuery.exec(QStringLiteral("PRAGMA auto_vacuum = INCREMENTAL")) ||
+	   !vacuumQuery.exec(QStringLiteral("VACUUM")))
+		throw LocalStoreException(_defaults, QByteArray{QTDATASYNC_EXCEPTION_NAME(LocalStore)}, _database->databaseName(), vacuumQuery.lastError().text());
+	logDebug() << "Enabled incremental vacuum for inline storage";
+	return true;
+}
+
+void LocalStore::compactStorage(int maxPages)
+{
+	//nothing to give back incrementally until enableIncrementalVacuum() completed
+	QSqlQuery vacuumModeQuery(_database);
+	vacuumModeQuery.prepare(QStringLiteral("PRAGMA auto_vacuum"));
+	exec(vacuumModeQuery);
+	if(!vacuumModeQuery.first() || vacuumModeQuery.value(0).toInt() != 2) //2 = INCREMENTAL
+		return;
+
+	QSqlQuery freeQuery(_database);
+	freeQuery.prepare(QStringLiteral("PRAGMA freelist_count"));
+	exec(freeQuery);
+	auto freePages = freeQuery.first() ? freeQuery.value(0).toInt() : 0;
+	if(freePages == 0)
+		return;
+
+	QSqlQuery compactQuery(_database);
+	compactQuery.prepare(QStringLiteral("PRAGMA incremental_vacuum(%1)").arg(maxPages));
+	exec(compactQuery);
+	while(compactQuery.next()); //sqlite frees one page per step, so all steps must be run
+	logDebug() << "Compacted" << qMin(maxPages, freePages) << "free database pages";
+}
+
+void LocalStore::recordWarmupKeys(int maxPerType)
+{
+	beginWriteTransaction();
+
+	try {
+		QSqlQuery clearQuery(_database);
+		clearQuery.prepare(QStringLiteral("DELETE FROM CacheWarmup"));
+		exec(clearQuery);
+
+		//the cache lists recently used keys first -> keep the first ones of every type
+		QHash<QByteArray, int> ranks;
+		auto recorded = 0;
+		for(const auto &key : _emitter->cachedKeys()) {
+			auto &rank = ranks[key.typeName];
+			if(rank >= maxPerType)
+				continue;
+
+			CachedQuery insertQuery{_database, QStringLiteral("INSERT INTO CacheWarmup (Type, Id, Rank) VALUES(?, ?, ?)")};
+			insertQuery.addBindValue(key.typeName);
+			insertQuery.addBindValue(key.id);
+			insertQuery.addBindValue(rank++);
+			exec(insertQuery, key);
+			recorded++;
+		}
+
+		if(!_database->commit())
+			throw LocalStoreException(_defaults, QByteArray("any"), _database->databaseName(), _database->lastError().text());
+		logDebug() << "Recorded" << recorded << "keys for the next cache warm-up";
+	} catch(...) {
+		_database->rollback();
+		throw;
+	}
+}
+
+int LocalStore::warmupCache()
+{
+	CachedQuery keysQuery{_database, QStringLiteral("SELECT Type, Id FROM CacheWarmup ORDER BY Rank")};
+	exec(keysQuery);
+	QList<ObjectKey> keys;
+	while(keysQuery.next())
+		keys.append({keysQuery.value(0).toByteArray(), keysQuery.value(1).toString()});
+	keysQuery.finish();
+
+	auto loaded = 0;
+	for(const auto &key : qAsConst(keys)) {
+		if(QThread::currentThread()->isInterruptionRequested())
+			break;
+		try {
+			load(key);
+			loaded++;
+		} catch(NoDataException &) {
+			//removed since it was recorded -> skip it
+		}
+	}
+	logDebug() << "Preloaded" << loaded << "of" << keys.size() << "recorded keys into the cache";
+	return loaded;
+}
+
+QJsonObject LocalStore::readJson(const ObjectKey &key, const QString &fileName, const QByteArray &inlineData, int *costs) const
+{
+	if(fileName == InlineFileName)
+		return decodeJson(key, inlineData, _database->databaseName(), costs);
+	else {
+		QFile file(filePath(key, fileName));
+		if(!file.open(QIODevice::ReadOnly))
+			throw LocalStoreException(_defaults, key, file.fileName(), file.errorString());
+		auto data = file.readAll();
+		file.close();
+		return decodeJson(key, data, file.fileName(), costs);
+	}
+}
+
+QList<QJsonObject> LocalStore::readAllJson(const QByteArray &typeName, QSqlQuery &query) const
+{
+	struct Entry {
+		ObjectKey key;
+		QString path; //null for inline data
+		QByteArray data;
+		QJsonObject json;
+		int size = 0;
+		bool exists = true;
+	};
+
+	//collect the rows first - everything that needs the database must happen on this thread
+	QVector<Entry> entries;
+	QDir typeDir;
+	auto hasTypeDir = false;
+	while(query.next()) {
+		Entry entry;
+		entry.key = {typeName, query.value(0).toString()};
+		auto fileName = query.value(1).toString();
+		if(fileName == InlineFileName)
+			entry.data = query.value(2).toByteArray();
+		else {
+			if(!hasTypeDir) {
+				typeDir = typeDirectory(entry.key);
+				hasTypeDir = true;
+			}
+			entry.path = filePath(typeDir, fileName);
+		}
+		entries.append(entry);
+	}
+
+	//read and decode, in parallel for larger sets
+	const auto dbName = _database->databaseName();
+	auto decodeFn = [this, dbName](Entry &entry) {
+		if(entry.path.isNull())
+			entry.json = decodeJson(entry.key, entry.data, dbName, &entry.size);
+		else {
+			QFile file(entry.path);
+			if(!file.open(QIODevice::ReadOnly)) {
+				//removed by a concurrent write after the rows were read -> skip it
+				if(!file.exists()) {
+					entry.exists = false;
+					return;
+				}
+				throw LocalStoreException(_defaults, entry.key, file.fileName(), file.errorString());
+			}
+			entry.data = file.readAll();
+			file.close();
+			entry.json = decodeJson(entry.key, entry.data, entry.path, &entry.size);
+		}
+		entry.data.clear();
+	};
+	if(entries.size() < ParallelDecodeLimit)
+		std::for_each(entries.begin(), entries.end(), decodeFn);
+	else
+		QtConcurrent::blockingMap(entries, decodeFn);
+
+	//reassemble in query order
+	QList<ObjectKey> keys;
+	QList<QJsonObject> array;
+	QList<int> sizes;
+	keys.reserve(entries.size());
+	array.reserve(entries.size());
+	sizes.reserve(entries.size());
+	for(const auto &entry : qAsConst(entries)) {
+		if(!entry.exists)
+			continue;
+		keys.append(entry.key);
+		array.append(entry.json);
+		sizes.append(entry.size);
+	}
+
+	_emitter->putCached(keys, array, sizes);
+	return array;
+}
+
+QJsonObject LocalStore::decodeJson(const ObjectKey &key, const QByteArray &data, const QString &context, int *costs) const
+{
+	QJsonDocument doc;
+	if(data.startsWith(CompressionTag)) {
+		auto binData = qUncompress(reinterpret_cast<const uchar*>(data.constData()) + CompressionTag.size(),
+								   data.size() - CompressionTag.size());
+		if(binData.isEmpty())
+			throw LocalStoreException(_defaults, key, context, QStringLiteral("File contains invalid compressed data"));
+		doc = QJsonDocument::fromBinaryData(binData);
+		if(costs) //cache the decompressed size, as that is what stays in memory
+			*costs = binData.size();
+	} else {
+		doc = QJsonDocument::fromBinaryData(data);
+		if(costs)
+			*costs = data.size();
+	}
+
+	if(!doc.isObject())
+		throw LocalStoreException(_defaults, key, context, QStringLiteral("File contains invalid json data"));
+	return doc.object();
+}
+
+Setup::StorageMode LocalStore::storageMode() const
+{
+	return _defaults.property(Defaults::StorageMode).value<Setup::StorageMode>();
+}
+
 QDir LocalStore::typeDirectory(const ObjectKey &key) const
 {
 	auto encName = QUrl::toPercentEncoding(QString::fromUtf8(key.typeName))
@@ -781,85 +1617,542 @@ void LocalStore::exec(QSqlQuery &query, const ObjectKey &key) const
 
 function<void()> LocalStore::storeChangedImpl(const DatabaseRef &db, const ObjectKey &key, quint64 version, const QString &fileName, const QJsonObject &data, bool changed, bool existing)
 {
-	auto tableDir = typeDirectory(key);
+	auto obsoleteFile = storeDataImpl(db, key, version, fileName, data, changed, existing);
+	return [this, key, changed, obsoleteFile]() {
+		//the cache was filled before the commit - invalidate lookups that did not see it yet
+		_emitter->touchCached();
+		//remove a file that was replaced by inline data
+		removeObsoleteFile(obsoleteFile);
+		//trigger change signals
+		_emitter->triggerChange(key, false, changed);
+	};
+}
+
+QString LocalStore::storeDataImpl(const DatabaseRef &db, const ObjectKey &key, quint64 version, const QString &fileName, const QJsonObject &data, bool changed, bool existing)
+{
+	auto binData = QJsonDocument(data).toBinaryData();
+	const auto costs = binData.size();
+	const auto sharedData = binData;
+	const auto checksum = SyncHelper::jsonHash(data);
+	auto level = compressionLevel(key.typeName);
+	if(level != 0)
+		binData = CompressionTag + qCompress(binData, level);
+	auto hasFile = existing && !fileName.isNull() && fileName != InlineFileName;
+
 	QScopedPointer<QFileDevice> device;
 	function<bool(QFileDevice*)> fileCommitFn;
-
-	if(existing && !fileName.isNull()) {
-		auto file = new QSaveFile(filePath(tableDir, fileName));
-		device.reset(file);
-		if(!file->open(QIODevice::WriteOnly))
-			throw LocalStoreException(_defaults, key, file->fileName(), file->errorString());
-		fileCommitFn = [](QFileDevice *d){
-			return static_cast<QSaveFile*>(d)->commit();
-		};
+	QString indexFile;
+	QVariant indexData{QVariant::ByteArray};
+	QString obsoleteFile;
+
+	if(storageMode() == Setup::StorageMode::Inline) {
+		indexFile = InlineFileName;
+		indexData = binData;
+		if(hasFile) //was stored as file before -> remove it after the commit
+			obsoleteFile = filePath(key, fileName);
 	} else {
-		auto newFileName = QStringLiteral("%1XXXXXX")
-						   .arg(QString::fromUtf8(QUuid::createUuid().toRfc4122().toHex()));
-		auto file = new QTemporaryFile(filePath(tableDir, newFileName));
-		device.reset(file);
-		if(!file->open())
-			throw LocalStoreException(_defaults, key, file->fileName(), file->errorString());
-		fileCommitFn = [](QFileDevice *d){
-			auto f = static_cast<QTemporaryFile*>(d);
-			f->close();
-			if(f->error() == QFile::NoError) {
-				f->setAutoRemove(false);
-				return true;
-			} else
-				return false;
-		};
-	}
+		auto tableDir = typeDirectory(key);
+		if(hasFile) {
+			auto file = new QSaveFile(filePath(tableDir, fileName));
+			device.reset(file);
+			if(!file->open(QIODevice::WriteOnly))
+				throw LocalStoreException(_defaults, key, file->fileName(), file->errorString());
+			fileCommitFn = [](QFileDevice *d){
+				return static_cast<QSaveFile*>(d)->commit();
+			};
+		} else {
+			auto newFileName = QStringLiteral("%1XXXXXX")
+							   .arg(QString::fromUtf8(QUuid::createUuid().toRfc4122().toHex()));
+			auto file = new QTemporaryFile(filePath(tableDir, newFileName));
+			device.reset(file);
+			if(!file->open())
+				throw LocalStoreException(_defaults, key, file->fileName(), file->errorString());
+			fileCommitFn = [](QFileDevice *d){
+				auto f = static_cast<QTemporaryFile*>(d);
+				f->close();
+				if(f->error() == QFile::NoError) {
+					f->setAutoRemove(false);
+					return true;
+				} else
+					return false;
+			};
+		}
 
-	//write the data & get the hash
-	device->write(QJsonDocument(data).toBinaryData());
-	if(device->error() != QFile::NoError)
-		throw LocalStoreException(_defaults, key, device->fileName(), device->errorString());
+		//write the data
+		device->write(binData);
+		if(device->error() != QFile::NoError)
+			throw LocalStoreException(_defaults, key, device->fileName(), device->errorString());
+		//still update file, in case it was set to NULL
+		indexFile = tableDir.relativeFilePath(QFileInfo{device->fileName()}.completeBaseName());
+	}
 
 	//save key in database
-	QFileInfo info(device->fileName());
 	if(existing) {
-		QSqlQuery updateQuery(db);
-		updateQuery.prepare(QStringLiteral("UPDATE DataIndex SET Version = ?, File = ?, Checksum = ?, Changed = ? WHERE Type = ? AND Id = ?"));
+		CachedQuery updateQuery{db, QStringLiteral("UPDATE DataIndex SET Version = ?, File = ?, Checksum = ?, Changed = ?, Data = ? WHERE Type = ? AND Id = ?")};
 		updateQuery.addBindValue(version);
-		updateQuery.addBindValue(tableDir.relativeFilePath(info.completeBaseName())); //still update file, in case it was set to NULL
-		updateQuery.addBindValue(SyncHelper::jsonHash(data));
+		updateQuery.addBindValue(indexFile);
+		updateQuery.addBindValue(checksum);
 		updateQuery.addBindValue(changed);
+		updateQuery.addBindValue(indexData);
 		updateQuery.addBindValue(key.typeName);
 		updateQuery.addBindValue(key.id);
 		exec(updateQuery, key);
 	} else {
-		QSqlQuery insertQuery(db);
-		insertQuery.prepare(QStringLiteral("INSERT INTO DataIndex (Type, Id, Version, File, Checksum, Changed) VALUES(?, ?, ?, ?, ?, ?)"));
+		CachedQuery insertQuery{db, QStringLiteral("INSERT INTO DataIndex (Type, Id, Version, File, Checksum, Changed, Data) VALUES(?, ?, ?, ?, ?, ?, ?)")};
 		insertQuery.addBindValue(key.typeName);
 		insertQuery.addBindValue(key.id);
 		insertQuery.addBindValue(version);
-		insertQuery.addBindValue(tableDir.relativeFilePath(info.completeBaseName()));
-		insertQuery.addBindValue(SyncHelper::jsonHash(data));
+		insertQuery.addBindValue(indexFile);
+		insertQuery.addBindValue(checksum);
 		insertQuery.addBindValue(changed);
+		insertQuery.addBindValue(indexData);
 		exec(insertQuery, key);
 	}
+	updateIndexes(db, key, data);
 
 	//complete the file-save (last before commit!)
-	if(!fileCommitFn(device.data()))
+	if(device && !fileCommitFn(device.data()))
 		throw LocalStoreException(_defaults, key, device->fileName(), device->errorString());
 
-	//update cache
-	_emitter->putCached(key, data, static_cast<int>(info.size()));
+	//update cache - passive setups only use the shared entry once this version is committed
+	_emitter->putCached(key, data, costs);
+	_emitter->putSharedCached(key, version, checksum, sharedData);
 
-	return [this, key, changed]() {
-		//trigger change signals
-		_emitter->triggerChange(key, false, changed);
-	};
+	return obsoleteFile;
+}
+
+void LocalStore::removeObsoleteFile(const QString &filePath) const
+{
+	if(!filePath.isNull() && !QFile::remove(filePath))
+		logWarning() << "Failed to remove obsolete data file" << filePath;
+}
+
+QByteArray LocalStore::typeClassInfo(const QByteArray &typeName, const char *name)
+{
+	auto metaTypeId = QMetaType::type(typeName.constData());
+	auto metaObject = metaTypeId != QMetaType::UnknownType ?
+						  QMetaType::metaObjectForType(metaTypeId) :
+						  nullptr;
+	if(!metaObject)
+		return {};
+	auto infoIndex = metaObject->indexOfClassInfo(name);
+	if(infoIndex == -1)
+		return {};
+	return QByteArray{metaObject->classInfo(infoIndex).value()};
+}
+
+int LocalStore::compressionLevel(const QByteArray &typeName) const
+{
+	auto it = _compressionLevels.constFind(typeName);
+	if(it != _compressionLevels.constEnd())
+		return *it;
+
+	auto level = 0;
+	const auto info = typeClassInfo(typeName, CompressionClassInfo);
+	if(!info.isNull()) {
+		auto ok = true;
+		level = info.trimmed().isEmpty() ? -1 : info.trimmed().toInt(&ok);
+		if(!ok || level < -1 || level > 9) {
+			logWarning() << "Invalid compression level" << info << "for type" << typeName
+						 << "- using the default level instead";
+			level = -1;
+		}
+	}
+
+	_compressionLevels.insert(typeName, level);
+	return level;
+}
+
+LocalStore::SearchPlan LocalStore::planSearch(const QString &query, DataStore::SearchMode mode)
+{
+	auto likeQuery = query;
+	if(mode != DataStore::RegexpMode) { //escape any of the like wildcard literals
+		if(mode != DataStore::WildcardMode)
+			likeQuery.replace(QLatin1Char('\\'), QStringLiteral("\\\\"));
+		likeQuery.replace(QLatin1Char('%'), QStringLiteral("\\%"));
+		likeQuery.replace(QLatin1Char('_'), QStringLiteral("\\_"));
+	}
+
+	SearchPlan plan;
+	QString prefix;
+	switch(mode) {
+	case DataStore::RegexpMode:
+		prefix = regexpPrefix(query);
+		plan.filter = QStringLiteral("Id REGEXP ?");
+		plan.filterArg = query;
+		break;
+	case DataStore::WildcardMode:
+	{
+		//the literal part up to the first unescaped * or ?
+		for(auto i = 0; i < query.size(); i++) {
+			const auto c = query[i];
+			if(c == QLatin1Char('*') || c == QLatin1Char('?'))
+				break;
+			else if(c == QLatin1Char('\\') && i + 1 < query.size())
+				prefix.append(query[++i]);
+			else
+				prefix.append(c);
+		}
+
+		//replace any unescaped * or ? by % and _
+		const QRegularExpression searchRepRegex1(QStringLiteral(R"__(((?<!\\)(?:\\\\)*)\*)__"));
+		const QRegularExpression searchRepRegex2(QStringLiteral(R"__(((?<!\\)(?:\\\\)*)\?)__"));
+		likeQuery.replace(searchRepRegex1, QStringLiteral("\\1%"));
+		likeQuery.replace(searchRepRegex2, QStringLiteral("\\1_"));
+		plan.filterArg = likeQuery;
+		break;
+	}
+	case DataStore::ContainsMode:
+		plan.filterArg = QLatin1Char('%') + likeQuery + QLatin1Char('%');
+		break;
+	case DataStore::StartsWithMode:
+		prefix = query;
+		plan.filterArg = likeQuery + QLatin1Char('%');
+		break;
+	case DataStore::EndsWithMode:
+		plan.filterArg = QLatin1Char('%') + likeQuery;
+		break;
+	default:
+		Q_UNREACHABLE();
+		break;
+	}
+	if(mode != DataStore::RegexpMode)
+		plan.filter = QStringLiteral("Id LIKE ? ESCAPE '\\'");
+
+	if(prefix.isEmpty())
+		return plan;
+
+	if(mode == DataStore::RegexpMode) {
+		plan.lowerBound = prefix;
+		plan.upperBound = prefixSuccessor(prefix);
+	} else {
+		//LIKE ignores the case of ascii letters - the range must cover all variants:
+		//uppercase letters sort before lowercase ones, so the all upper prefix is the lowest possible match
+		auto lowestPrefix = prefix;
+		auto highestPrefix = prefix;
+		for(auto i = 0; i < prefix.size(); i++) {
+			const auto c = prefix[i].unicode();
+			if(c >= 'a' && c <= 'z')
+				lowestPrefix[i] = QChar{c - 'a' + 'A'};
+			else if(c >= 'A' && c <= 'Z')
+				highestPrefix[i] = QChar{c - 'A' + 'a'};
+		}
+		plan.lowerBound = lowestPrefix;
+		plan.upperBound = prefixSuccessor(highestPrefix);
+		//no case variants and nothing but the prefix to match -> the range is exact
+		if(mode == DataStore::StartsWithMode && lowestPrefix == highestPrefix) {
+			plan.filter.clear();
+			plan.filterArg.clear();
+		}
+	}
+	return plan;
+}
+
+QString LocalStore::regexpPrefix(const QString &pattern)
+{
+	//only patterns anchored to the start without alternatives can be narrowed down
+	if(!pattern.startsWith(QLatin1Char('^')))
+		return {};
+	for(auto i = 0; i < pattern.size(); i++) {
+		if(pattern[i] == QLatin1Char('\\'))
+			i++;
+		else if(pattern[i] == QLatin1Char('|'))
+			return {};
+	}
+
+	static const QString metaChars = QStringLiteral(".[](){}*+?^$|");
+	QString prefix;
+	for(auto i = 1; i < pattern.size(); i++) {
+		const auto c = pattern[i];
+		if(c == QLatin1Char('\\')) {
+			//escaped special characters are literals, everything else (\d, \w, \x...) is a class or assertion
+			if(i + 1 < pattern.size() && !pattern[i + 1].isLetterOrNumber()) {
+				prefix.append(pattern[++i]);
+				continue;
+			} else
+				break;
+		} else if(metaChars.contains(c)) {
+			//the last literal is optional or repeated -> not part of the prefix
+			if(!prefix.isEmpty() && (c == QLatin1Char('?') || c == QLatin1Char('*') || c == QLatin1Char('{')))
+				prefix.chop(prefix.size() > 1 && prefix.at(prefix.size() - 1).isLowSurrogate() ? 2 : 1);
+			break;
+		} else
+			prefix.append(c);
+	}
+	return prefix;
+}
+
+QString LocalStore::prefixSuccessor(const QString &prefix)
+{
+	//smallest string greater than all strings starting with prefix - code point order equals the utf8 byte order sqlite uses
+	auto codePoints = prefix.toUcs4();
+	while(!codePoints.isEmpty()) {
+		auto &last = codePoints.last();
+		if(last < 0x10FFFF) {
+			last++;
+			if(last == 0xD800) //skip the surrogate range
+				last = 0xE000;
+			return QString::fromUcs4(codePoints.constData(), codePoints.size());
+		} else
+			codePoints.removeLast();
+	}
+	return {};
+}
+
+QStringList LocalStore::indexedProperties(const QByteArray &typeName, IndexKind kind) const
+{
+	if(kind == ContentIndexKind && !_hasContentIndex)
+		return {};
+
+	const auto specKey = qMakePair(typeName, static_cast<int>(kind));
+	auto it = _indexSpecs.constFind(specKey);
+	if(it != _indexSpecs.constEnd())
+		return *it;
+
+	QStringList properties;
+	const auto names = QString::fromUtf8(typeClassInfo(typeName, kind == ContentIndexKind ? ContentClassInfo : IndexClassInfo))
+					   .split(QLatin1Char(','), QString::SkipEmptyParts);
+	for(const auto &name : names) {
+		auto property = name.trimmed();
+		if(!property.isEmpty() && !properties.contains(property))
+			properties.append(property);
+	}
+	properties.sort();
+
+	_indexSpecs.insert(specKey, properties);
+	return properties;
+}
+
+QString LocalStore::indexKindName(IndexKind kind)
+{
+	switch(kind) {
+	case PropertyIndexKind:
+		return QStringLiteral("property");
+	case ContentIndexKind:
+		return QStringLiteral("fulltext");
+	default:
+		Q_UNREACHABLE();
+		return {};
+	}
+}
+
+QVariant LocalStore::indexValue(const QJsonValue &value)
+{
+	switch(value.type()) {
+	case QJsonValue::Bool:
+		return value.toBool() ? 1 : 0;
+	case QJsonValue::Double:
+		return value.toDouble();
+	case QJsonValue::String:
+		return value.toString();
+	default: //null, arrays and objects cannot be indexed
+		return QVariant{};
+	}
+}
+
+QString LocalStore::indexContent(const QJsonValue &value)
+{
+	switch(value.type()) {
+	case QJsonValue::Double:
+		return QString::number(value.toDouble());
+	case QJsonValue::String:
+		return value.toString();
+	case QJsonValue::Array:
+	{
+		QStringList content;
+		for(const auto &element : value.toArray())
+			content.append(indexContent(element));
+		content.removeAll(QString{});
+		return content.join(QLatin1Char('\n'));
+	}
+	default: //null, booleans and objects carry no searchable text
+		return {};
+	}
+}
+
+void LocalStore::prepareIndexes(const DatabaseRef &db, const QByteArray &typeName)
+{
+	if(_verifiedIndexes.contains(typeName))
+		return;
+
+	//a new or changed declaration (re)builds the index from the stored data, so reads never have to
+	auto verified = true;
+	for(auto kind : {PropertyIndexKind, ContentIndexKind}) {
+		const auto spec = indexedProperties(typeName, kind).join(QLatin1Char(','));
+		CachedQuery infoQuery{db, QStringLiteral("SELECT Properties FROM IndexInfo WHERE Type = ? AND Kind = ?")};
+		infoQuery.addBindValue(typeName);
+		infoQuery.addBindValue(indexKindName(kind));
+		exec(infoQuery, typeName);
+		if(infoQuery.first() ? infoQuery.value(0).toString() == spec : spec.isEmpty())
+			continue;
+		infoQuery.finish();
+
+		verified = false; //only remembered once committed, i.e. when found up to date the next time
+		dropIndex(db, typeName, kind);
+		if(spec.isEmpty()) {
+			CachedQuery dropInfoQuery{db, QStringLiteral("DELETE FROM IndexInfo WHERE Type = ? AND Kind = ?")};
+			dropInfoQuery.addBindValue(typeName);
+			dropInfoQuery.addBindValue(indexKindName(kind));
+			exec(dropInfoQuery, typeName);
+			logDebug() << "Dropped outdated" << indexKindName(kind) << "index of type" << typeName;
+			continue;
+		}
+
+		//rebuild from the stored data, one dataset at a time
+		CachedQuery dataQuery{db, QStringLiteral("SELECT Id, File, Data FROM DataIndex WHERE Type = ? AND File IS NOT NULL")};
+		dataQuery.addBindValue(typeName);
+		exec(dataQuery, typeName);
+		auto count = 0;
+		while(dataQuery.next()) {
+			ObjectKey key{typeName, dataQuery.value(0).toString()};
+			auto json = readJson(key, dataQuery.value(1).toString(), dataQuery.value(2).toByteArray(), nullptr);
+			insertIndex(db, key, kind, json);
+			count++;
+		}
+
+		CachedQuery updateInfoQuery{db, QStringLiteral("INSERT OR REPLACE INTO IndexInfo (Type, Kind, Properties) VALUES(?, ?, ?)")};
+		updateInfoQuery.addBindValue(typeName);
+		updateInfoQuery.addBindValue(indexKindName(kind));
+		updateInfoQuery.addBindValue(spec);
+		exec(updateInfoQuery, typeName);
+		logDebug() << "Built" << indexKindName(kind) << "index of type" << typeName
+				   << "for" << count << "datasets";
+	}
+
+	if(verified)
+		_verifiedIndexes.insert(typeName);
+}
+
+void LocalStore::dropIndex(const DatabaseRef &db, const QByteArray &typeName, IndexKind kind)
+{
+	switch(kind) {
+	case PropertyIndexKind:
+	{
+		CachedQuery dropQuery{db, QStringLiteral("DELETE FROM PropertyIndex WHERE Type = ?")};
+		dropQuery.addBindValue(typeName);
+		exec(dropQuery, typeName);
+		break;
+	}
+	case ContentIndexKind:
+	{
+		if(!_hasContentIndex)
+			break;
+		CachedQuery dropContentQuery{db, QStringLiteral("DELETE FROM ContentIndex WHERE rowid IN (SELECT RowId FROM ContentKeys WHERE Type = ?)")};
+		dropContentQuery.addBindValue(typeName);
+		exec(dropContentQuery, typeName);
+		CachedQuery dropKeysQuery{db, QStringLiteral("DELETE FROM ContentKeys WHERE Type = ?")};
+		dropKeysQuery.addBindValue(typeName);
+		exec(dropKeysQuery, typeName);
+		break;
+	}
+	default:
+		Q_UNREACHABLE();
+		break;
+	}
+}
+
+void LocalStore::updateIndexes(const DatabaseRef &db, const ObjectKey &key, const QJsonObject &data)
+{
+	prepareIndexes(db, key.typeName);
+	for(auto kind : {PropertyIndexKind, ContentIndexKind}) {
+		if(indexedProperties(key.typeName, kind).isEmpty())
+			continue;
+		removeIndex(db, key, kind);
+		insertIndex(db, key, kind, data);
+	}
+}
+
+void LocalStore::insertIndex(const DatabaseRef &db, const ObjectKey &key, IndexKind kind, const QJsonObject &data)
+{
+	const auto properties = indexedProperties(key.typeName, kind);
+	switch(kind) {
+	case PropertyIndexKind:
+	{
+		CachedQuery insertQuery{db, QStringLiteral("INSERT OR IGNORE INTO PropertyIndex (Type, Property, Value, Id) VALUES(?, ?, ?, ?)")};
+		for(const auto &property : properties) {
+			auto value = indexValue(data.value(property));
+			if(!value.isValid())
+				continue;
+			insertQuery.addBindValue(key.typeName);
+			insertQuery.addBindValue(property);
+			insertQuery.addBindValue(value);
+			insertQuery.addBindValue(key.id);
+			exec(insertQuery, key);
+		}
+		break;
+	}
+	case ContentIndexKind:
+	{
+		QStringList content;
+		for(const auto &property : properties)
+			content.append(indexContent(data.value(property)));
+		content.removeAll(QString{});
+		if(content.isEmpty())
+			break;
+
+		CachedQuery insertKeyQuery{db, QStringLiteral("INSERT INTO ContentKeys (Type, Id) VALUES(?, ?)")};
+		insertKeyQuery.addBindValue(key.typeName);
+		insertKeyQuery.addBindValue(key.id);
+		exec(insertKeyQuery, key);
+
+		CachedQuery insertContentQuery{db, QStringLiteral("INSERT INTO ContentIndex (rowid, Content) "
+														  "VALUES((SELECT RowId FROM ContentKeys WHERE Type = ? AND Id = ?), ?)")};
+		insertContentQuery.addBindValue(key.typeName);
+		insertContentQuery.addBindValue(key.id);
+		insertContentQuery.addBindValue(content.join(QLatin1Char('\n')));
+		exec(insertContentQuery, key);
+		break;
+	}
+	default:
+		Q_UNREACHABLE();
+		break;
+	}
+}
+
+void LocalStore::removeIndexes(const DatabaseRef &db, const ObjectKey &key)
+{
+	prepareIndexes(db, key.typeName);
+	for(auto kind : {PropertyIndexKind, ContentIndexKind}) {
+		if(!indexedProperties(key.typeName, kind).isEmpty())
+			removeIndex(db, key, kind);
+	}
+}
+
+void LocalStore::removeIndex(const DatabaseRef &db, const ObjectKey &key, IndexKind kind)
+{
+	switch(kind) {
+	case PropertyIndexKind:
+	{
+		CachedQuery removeQuery{db, QStringLiteral("DELETE FROM PropertyIndex WHERE Type = ? AND Id = ?")};
+		removeQuery.addBindValue(key.typeName);
+		removeQuery.addBindValue(key.id);
+		exec(removeQuery, key);
+		break;
+	}
+	case ContentIndexKind:
+	{
+		CachedQuery removeContentQuery{db, QStringLiteral("DELETE FROM ContentIndex WHERE rowid = "
+														  "(SELECT RowId FROM ContentKeys WHERE Type = ? AND Id = ?)")};
+		removeContentQuery.addBindValue(key.typeName);
+		removeContentQuery.addBindValue(key.id);
+		exec(removeContentQuery, key);
+		CachedQuery removeKeyQuery{db, QStringLiteral("DELETE FROM ContentKeys WHERE Type = ? AND Id = ?")};
+		removeKeyQuery.addBindValue(key.typeName);
+		removeKeyQuery.addBindValue(key.id);
+		exec(removeKeyQuery, key);
+		break;
+	}
+	default:
+		Q_UNREACHABLE();
+		break;
+	}
 }
 
 void LocalStore::markUnchangedImpl(const DatabaseRef &db, const ObjectKey &key, quint64 version, bool isDelete)
 {
-	QSqlQuery completeQuery(db);
-	if(isDelete && !_defaults.property(Defaults::PersistDeleted).toBool())
-		completeQuery.prepare(QStringLiteral("DELETE FROM DataIndex WHERE Type = ? AND Id = ? AND Version = ? AND File IS NULL"));
-	else
-		completeQuery.prepare(QStringLiteral("UPDATE DataIndex SET Changed = 0 WHERE Type = ? AND Id = ? AND Version = ?"));
+	CachedQuery completeQuery{db, isDelete && !_defaults.property(Defaults::PersistDeleted).toBool() ?
+								  QStringLiteral("DELETE FROM DataIndex WHERE Type = ? AND Id = ? AND Version = ? AND File IS NULL") :
+								  QStringLiteral("UPDATE DataIndex SET Changed = 0 WHERE Type = ? AND Id = ? AND Version = ?")};
 	completeQuery.addBindValue(key.typeName);
 	completeQuery.addBindValue(key.id);
 	completeQuery.addBindValue(version);
@@ -898,3 +2191,122 @@ LocalStore::SyncScope::Private::Private(const Defaults &defaults, ObjectKey key,
 	key{std::move(key)},
 	database{defaults.aquireDatabase(owner)}
 {}
+
+// ------------- Cursor -------------
+
+struct LocalStore::Cursor::Private
+{
+	struct Row {
+		QString id;
+		QString fileName;
+		QByteArray data;
+	};
+
+	const LocalStore *owner;
+	QByteArray typeName;
+	QDir typeDir;
+	bool hasTypeDir = false;
+
+	QVector<Row> page;
+	int index = -1;
+	bool lastPage = false;
+	ObjectKey key;
+
+	Private(const LocalStore *owner, QByteArray typeName);
+
+	void fetchPage();
+};
+
+LocalStore::Cursor::Cursor(const LocalStore *owner, const QByteArray &typeName) :
+	d{new Private(owner, typeName)}
+{}
+
+LocalStore::Cursor::Cursor(LocalStore::Cursor &&other) noexcept :
+	d()
+{
+	d.swap(other.d);
+}
+
+LocalStore::Cursor::~Cursor() = default;
+
+bool LocalStore::Cursor::next()
+{
+	if(++d->index >= d->page.size()) {
+		if(d->lastPage)
+			return false;
+		d->fetchPage();
+		if(d->page.isEmpty())
+			return false;
+	}
+
+	d->key = {d->typeName, d->page[d->index].id};
+	return true;
+}
+
+ObjectKey LocalStore::Cursor::key() const
+{
+	return d->key;
+}
+
+QJsonObject LocalStore::Cursor::load() const
+{
+	QJsonObject json;
+	if(d->owner->_emitter->getCached(d->key, json))
+		return json;
+
+	int size;
+	auto &row = d->page[d->index];
+	if(row.fileName == InlineFileName) {
+		json = d->owner->decodeJson(d->key, row.data, d->owner->_database->databaseName(), &size);
+		d->owner->_emitter->putCached(d->key, json, size);
+		return json;
+	}
+
+	if(!d->hasTypeDir) {
+		d->typeDir = d->owner->typeDirectory(d->key);
+		d->hasTypeDir = true;
+	}
+	QFile file(d->owner->filePath(d->typeDir, row.fileName));
+	if(!file.open(QIODevice::ReadOnly)) {
+		if(!file.exists()) //removed after the row was read
+			throw NoDataException(d->owner->_defaults, d->key);
+		throw LocalStoreException(d->owner->_defaults, d->key, file.fileName(), file.errorString());
+	}
+	auto data = file.readAll();
+	file.close();
+	json = d->owner->decodeJson(d->key, data, file.fileName(), &size);
+	d->owner->_emitter->putCached(d->key, json, size);
+	return json;
+}
+
+LocalStore::Cursor::Private::Private(const LocalStore *owner, QByteArray typeName) :
+	owner{owner},
+	typeName{std::move(typeName)}
+{}
+
+void LocalStore::Cursor::Private::fetchPage()
+{
+	//the statement is reset before the rows are handed out, so no snapshot is held
+	//while the caller works with them - it may even modify the store in between
+	CachedQuery pageQuery{owner->_database, QStringLiteral("SELECT Id, File, Data FROM DataIndex "
+														   "WHERE Type = ? AND Id > ? AND File IS NOT NULL "
+														   "ORDER BY Id "
+														   "LIMIT ?")};
+	pageQuery.setForwardOnly(true);
+	pageQuery.addBindValue(typeName);
+	pageQuery.addBindValue(page.isEmpty() ? QStringLiteral("") : page.last().id);
+	pageQuery.addBindValue(CursorPageSize);
+	owner->exec(pageQuery, typeName);
+
+	page.clear();
+	index = 0;
+	while(pageQuery.next()) {
+		Row row;
+		row.id = pageQuery.value(0).toString();
+		row.fileName = pageQuery.value(1).toString();
+		if(row.fileName == InlineFileName)
+			row.data = pageQuery.value(2).toByteArray();
+		page.append(row);
+	}
+	lastPage = page.size() < CursorPageSize;
+}
@@ -8,6 +8,9 @@
 #include <QtCore/QPointer>
 #include <QtCore/QJsonObject>
 #include <QtCore/QUuid>
+#include <QtCore/QPair>
+#include <QtCore/QHash>
+#include <QtCore/QSet>
 
 #include <QtSql/QSqlDatabase>
 
@@ -54,6 +57,33 @@ public:
 		SyncScope(const Defaults &defaults, const ObjectKey &key, LocalStore *owner);
 	};
 
+	class Q_DATASYNC_EXPORT Cursor {
+		friend class LocalStore;
+		Q_DISABLE_COPY(Cursor)
+
+	public:
+		Cursor(Cursor &&other) noexcept;
+		~Cursor();
+
+		bool next();
+		ObjectKey key() const;
+		QJsonObject load() const;
+
+	private:
+		struct Private;
+		QScopedPointer<Private> d;
+
+		Cursor(const LocalStore *owner, const QByteArray &typeName);
+	};
+
+	//position of one pass over all pending changes: first the changed datasets, then the device uploads
+	struct Q_DATASYNC_EXPORT ChangeCursor {
+		ObjectKey key; //the last visited change, empty to start at the beginning
+		QUuid deviceId;
+		bool devicePhase = false;
+		bool done = false;
+	};
+
 	explicit LocalStore(Defaults defaults, QObject *parent = nullptr);
 	~LocalStore() override;
 
@@ -62,20 +92,35 @@ public:
 	// normal store access
 	quint64 count(const QByteArray &typeName) const;
 	QStringList keys(const QByteArray &typeName) const;
+	QStringList keys(const QByteArray &typeName, const QString &afterKey, int limit, bool reverse = false) const;
 	QList<QJsonObject> loadAll(const QByteArray &typeName) const;
+	Cursor iterate(const QByteArray &typeName) const;
 
 	bool contains(const ObjectKey &key) const;
 	QJsonObject load(const ObjectKey &key) const;
+	bool loadCachedValue(const ObjectKey &key, int metaTypeId, QVariant &value) const;
+	void cacheValue(const ObjectKey &key, const QJsonObject &data, const QVariant &value) const;
 	void save(const ObjectKey &key, const QJsonObject &data);
 	bool remove(const ObjectKey &key);
+	void saveAll(const QByteArray &typeName, const QList<QPair<QString, QJsonObject>> &data);
+	int removeAll(const QByteArray &typeName, const QStringList &ids);
 
-	QList<QJsonObject> find(const QByteArray &typeName, const QString &query, DataStore::SearchMode mode) const;
+	QList<QJsonObject> find(const QByteArray &typeName, const QString &query, DataStore::SearchMode mode, int offset = 0, int limit = -1) const;
+	QList<QJsonObject> findBy(const QByteArray &typeName, const QString &property, const QJsonValue &from, const QJsonValue &to) const;
+	QStringList searchText(const QByteArray &typeName, const QString &query, int limit) const;
 	void clear(const QByteArray &typeName);
 	void reset(bool keepData);
 
+	// change subscriptions
+	void subscribe(const QByteArray &typeName, const QString &keyPrefix = {});
+	void unsubscribe(const QByteArray &typeName);
+	void unsubscribeAll();
+	void clearSubscriptions();
+
 	// change access
 	quint32 changeCount() const;
 	void loadChanges(int limit, const std::function<bool(ObjectKey, quint64, QString, QUuid)> &visitor) const; //(key, version, file, device)
+	void loadChanges(int limit, ChangeCursor &cursor, const std::function<bool(ObjectKey, quint64, QString, QUuid)> &visitor) const; //continues after the cursor and moves it
 	void markUnchanged(const ObjectKey &key, quint64 version, bool isDelete);
 	void removeDeviceChange(const ObjectKey &key, QUuid deviceId);
 
@@ -103,15 +148,55 @@ public:
 
 	void prepareAccountAdded(QUuid deviceId);
 
+	// storage maintenance
+	void migrateStorage();
+	void prepareIndexes();
+	bool enableIncrementalVacuum();
+	void compactStorage(int maxPages);
+	void recordWarmupKeys(int maxPerType);
+	int warmupCache();
+
 Q_SIGNALS:
 	void dataChanged(const QtDataSync::ObjectKey &key, bool deleted);
+	void dataChangedBatch(const QByteArray &typeName, const QStringList &ids, bool deleted);
 	void dataResetted();
 
 private:
+	static const QString InlineFileName;
+	static const int ParallelDecodeLimit;
+	static const int CursorPageSize;
+	struct SearchPlan {
+		QString lowerBound; //inclusive, null for none
+		QString upperBound; //exclusive, null for none
+		QString filter; //residual condition, null for none
+		QString filterArg;
+	};
+
+	enum IndexKind {
+		PropertyIndexKind,
+		ContentIndexKind
+	};
+
+	static const char * const IndexClassInfo;
+	static const char * const ContentClassInfo;
+	static const char * const CompressionClassInfo;
+	static const QByteArray CompressionTag;
+
 	Defaults _defaults;
 	Logger *_logger;
 	EmitterAdapter *_emitter;
 	DatabaseRef _database;
+	bool _hasContentIndex;
+	mutable QHash<QPair<QByteArray, int>, QStringList> _indexSpecs;
+	mutable QHash<QByteArray, int> _compressionLevels;
+	QSet<QByteArray> _verifiedIndexes;
+
+	QJsonObject readJson(const ObjectKey &key, const QString &fileName, const QByteArray &inlineData, int *costs) const;
+	QList<QJsonObject> readAllJson(const QByteArray &typeName, QSqlQuery &query) const;
+	QJsonObject decodeJson(const ObjectKey &key, const QByteArray &data, const QString &context, int *costs) const;
+	Setup::StorageMode storageMode() const;
+	static QByteArray typeClassInfo(const QByteArray &typeName, const char *name);
+	int compressionLevel(const QByteArray &typeName) const;
 
 	QDir typeDirectory(const ObjectKey &key) const;
 	QString filePath(const QDir &typeDir, const QString &baseName) const;
@@ -128,6 +213,29 @@ private:
 																 const QJsonObject &data,
 																 bool changed,
 																 bool existing);
+	QString storeDataImpl(const DatabaseRef &db,
+						  const ObjectKey &key,
+						  quint64 version,
+						  const QString &filePath,
+						  const QJsonObject &data,
+						  bool changed,
+						  bool existing);
+	void removeObsoleteFile(const QString &filePath) const;
+
+	static SearchPlan planSearch(const QString &query, DataStore::SearchMode mode);
+	static QString regexpPrefix(const QString &pattern);
+	static QString prefixSuccessor(const QString &prefix);
+
+	QStringList indexedProperties(const QByteArray &typeName, IndexKind kind) const;
+	static QString indexKindName(IndexKind kind);
+	static QVariant indexValue(const QJsonValue &value);
+	static QString indexContent(const QJsonValue &value);
+	void prepareIndexes(const DatabaseRef &db, const QByteArray &typeName);
+	void dropIndex(const DatabaseRef &db, const QByteArray &typeName, IndexKind kind);
+	void updateIndexes(const DatabaseRef &db, const ObjectKey &key, const QJsonObject &data);
+	void insertIndex(const DatabaseRef &db, const ObjectKey &key, IndexKind kind, const QJsonObject &data);
+	void removeIndexes(const DatabaseRef &db, const ObjectKey &key);
+	void removeIndex(const DatabaseRef &db, const ObjectKey &key, IndexKind kind);
 	void markUnchangedImpl(const DatabaseRef &db,
 						   const ObjectKey &key,
 						   quint64 version,
@@ -16,8 +16,10 @@
 
 #ifdef DOXYGEN_RUN
 #define QT_DATASYNC_REVISION_2
+#define QT_DATASYNC_REVISION_3
 #else
 #define QT_DATASYNC_REVISION_2 Q_REVISION(2)
+#define QT_DATASYNC_REVISION_3 Q_REVISION(3)
 #endif
 
 //! The primary namespace of the QtDataSync library
@@ -28,6 +28,18 @@ struct is_storable : public is_gadget<T> {};
 template <typename T>
 struct is_storable<T*> : public std::is_base_of<QObject, T> {};
 
+template <typename T>
+inline typename std::enable_if<!is_object<T>::value, T>::type move_to_thread(T value, QThread *) {
+	return value;
+}
+
+template <typename T>
+inline typename std::enable_if<is_object<T>::value, T>::type move_to_thread(T value, QThread *thread) {
+	if(value)
+		value->moveToThread(thread);
+	return value;
+}
+
 }
 }
 
@@ -3,6 +3,8 @@
 #include "setup_p.h"
 
 #include <QtCore/QSysInfo>
+#include <QtConcurrent/QtConcurrentRun>
+#include <QtConcurrent/QtConcurrentMap>
 
 #include "registermessage_p.h"
 #include "loginmessage_p.h"
@@ -56,6 +58,11 @@ const QVector<seconds> RemoteConnector::Timeouts = {
 	minutes{5}
 };
 
+//far above any sane server download limit, only reached if the server ignores the acks
+const int RemoteConnector::MaxPendingDownloads = 1000;
+//decrypted changes wait here instead of in the sync controller once that many are being applied
+const int RemoteConnector::MaxActiveDownloads = 64;
+
 RemoteConnector::RemoteConnector(const Defaults &defaults, QObject *parent) :
 	Controller{"connector", defaults, parent},
 	_cryptoController{new CryptoController(defaults, this)}
@@ -345,8 +352,19 @@ void RemoteConnector::uploadData(const QByteArray &key, const QByteArray &change
 
 	try {
 		ChangeMessage message(key);
-		tie(message.keyIndex, message.salt, message.data) = _cryptoController->encryptData(changeData);
-		sendMessage(message);
+		if(_serverVersion >= ChangeBatchMessage::MinVersion) {
+			//collect all changes started from the same event loop pass and send them as one message
+			if(_uploadBatch.isEmpty())
+				QMetaObject::invokeMethod(this, "flushUploads", Qt::QueuedConnection);
+			PendingUpload upload;
+			upload.plain = changeData;
+			tie(message.keyIndex, message.salt, upload.encryptor) = _cryptoController->prepareEncryptData();
+			upload.change = std::make_tuple(message.dataId, message.keyIndex, message.salt, QByteArray{});
+			_uploadBatch.append(upload);
+		} else {
+			tie(message.keyIndex, message.salt, message.data) = _cryptoController->encryptData(changeData);
+			sendMessage(message);
+		}
 	} catch(Exception &e) {
 		onError({ErrorMessage::ClientError, e.qWhat()}, Message::messageName<ChangeMessage>());
 	}
@@ -382,7 +400,13 @@ void RemoteConnector::downloadDone(const quint64 key)
 		beginOp(minutes(5), false);
 	} catch(Exception &e) {
 		onError({ErrorMessage::ClientError, e.qWhat()}, Message::messageName<ChangedAckMessage>());
+		return;
 	}
+
+	//make room for the changes that were held back
+	if(_activeDownloads > 0)
+		_activeDownloads--;
+	applyDownloads();
 }
 
 void RemoteConnector::setSyncEnabled(bool syncEnabled)
@@ -479,6 +503,8 @@ void RemoteConnector::binaryMessageReceived(const QByteArray &message)
 			onGrant(Message::deserializeMessage<GrantMessage>(stream));
 		else if(Message::isType<ChangeAckMessage>(name))
 			onChangeAck(Message::deserializeMessage<ChangeAckMessage>(stream));
+		else if(Message::isType<ChangeBatchAckMessage>(name))
+			onChangeBatchAck(Message::deserializeMessage<ChangeBatchAckMessage>(stream));
 		else if(Message::isType<DeviceChangeAckMessage>(name))
 			onDeviceChangeAck(Message::deserializeMessage<DeviceChangeAckMessage>(stream));
 		else if(Message::isType<ChangedMessage>(name))
@@ -569,6 +595,65 @@ void RemoteConnector::tryClose()
 		_socket->close();
 }
 
+void RemoteConnector::flushUploads()
+{
+	if(_uploadBatch.isEmpty())
+		return;
+	if(!isIdle()) {
+		logWarning() << "Can't upload when not in idle state. Dropping" << _uploadBatch.size() << "batched changes";
+		_uploadBatch.clear();
+		return;
+	}
+
+	try {
+		QList<PendingUpload> batch;
+		batch.swap(_uploadBatch);
+		//the ciphers are independent of each other, so the whole batch is encrypted in parallel
+		QtConcurrent::blockingMap(batch, [](PendingUpload &upload) {
+			get<3>(upload.change) = upload.encryptor(upload.plain);
+		});
+
+		ChangeBatchMessage message;
+		message.changes.reserve(batch.size());
+		for(const auto &upload : qAsConst(batch))
+			message.changes.append(upload.change);
+		logDebug() << "Uploading" << message.changes.size() << "changes as one batch";
+		sendMessage(message);
+	} catch(Exception &e) {
+		onError({ErrorMessage::ClientError, e.qWhat()}, Message::messageName<ChangeBatchMessage>());
+	}
+}
+
+void RemoteConnector::applyDownloads()
+{
+	//keep the order of the server, so changes of the same dataset are applied in the order they were made
+	while(!_pendingDownloads.isEmpty() &&
+		  _pendingDownloads.head().watcher->isFinished() &&
+		  _activeDownloads < MaxActiveDownloads) {
+		auto download = _pendingDownloads.dequeue();
+		auto future = download.watcher->future();
+		download.watcher->deleteLater();
+
+		if(!isIdle()) {
+			logWarning() << "Can't download when not in idle state. Dropping decrypted change";
+			continue;
+		}
+
+		try {
+			_activeDownloads++;
+			emit downloadData(download.key, future.result());
+		} catch(Exception &e) {
+			clearDownloads();
+			onError({ErrorMessage::ClientError, e.qWhat()}, Message::messageName<ChangedMessage>());
+			return;
+		} catch(QException &e) {
+			clearDownloads();
+			onError({ErrorMessage::ClientError, QString::fromUtf8(e.what())}, Message::messageName<ChangedMessage>());
+			return;
+		}
+	}
+}
+
 void RemoteConnector::doConnect()
 {
 	emit remoteEvent(RemoteConnecting);
@@ -690,6 +775,8 @@ void RemoteConnector::onEntryIdleState()
 void RemoteConnector::onExitActiveState()
 {
 	clearCaches(false);
+	_uploadBatch.clear();
+	clearDownloads();
 	endOp(); //disconnected -> whatever operation was going on is now done
 	emit remoteEvent(RemoteDisconnected);
 }
@@ -817,6 +904,17 @@ void RemoteConnector::clearCaches(bool includeExport)
 	_activeProofs.clear();
 }
 
+void RemoteConnector::clearDownloads()
+{
+	//running decryptions only work on copies, so they can simply finish in the background
+	for(const auto &download : qAsConst(_pendingDownloads)) {
+		download.watcher->disconnect(this);
+		download.watcher->deleteLater();
+	}
+	_pendingDownloads.clear();
+	_activeDownloads = 0;
+}
+
 QVariant RemoteConnector::sValue(const QString &key) const
 {
 	if(key == keyRemoteHeaders) {
@@ -892,6 +990,8 @@ void RemoteConnector::onError(const ErrorMessage &message, const QByteArray &mes
 		logCritical().noquote() << "Local error on " << messageName << ": " << message.message;
 	else
 		logCritical() << message;
+	//before the error, as that clears all active uploads
+	emit uploadsRejected(message.type == ErrorMessage::QuotaHitError);
 	triggerError(message.canRecover);
 
 	if(!message.canRecover) {
@@ -937,6 +1037,7 @@ void RemoteConnector::onIdentify(const IdentifyMessage &message)
 		logWarning() << "Unexpected IdentifyMessage";
 		triggerError(true);
 	} else {
+		_serverVersion = message.protocolVersion;
 		emit updateUploadLimit(message.uploadLimit);
 		if(!_deviceId.isNull()) {
 			LoginMessage msg(_deviceId,
@@ -1061,6 +1162,14 @@ void RemoteConnector::onChangeAck(const ChangeAckMessage &message)
 		emit uploadDone(message.dataId);
 }
 
+void RemoteConnector::onChangeBatchAck(const ChangeBatchAckMessage &message)
+{
+	if(checkIdle(message)) {
+		for(const auto &dataId : message.dataIds)
+			emit uploadDone(dataId);
+	}
+}
+
 void RemoteConnector::onDeviceChangeAck(const DeviceChangeAckMessage &message)
 {
 	if(checkIdle(message))
@@ -1070,11 +1179,25 @@ void RemoteConnector::onDeviceChangeAck(const DeviceChangeAckMessage &message)
 void RemoteConnector::onChanged(const ChangedMessage &message)
 {
 	if(checkIdle(message)) {
-		auto data = _cryptoController->decryptData(message.keyIndex,
-												   message.salt,
-												   message.data);
+		if(_pendingDownloads.size() >= MaxPendingDownloads) {
+			clearDownloads();
+			onError({ErrorMessage::ClientError, QStringLiteral("Server sent more changes than can be buffered"), true},
+					Message::messageName<ChangedMessage>());
+			return;
+		}
+
+		auto decryptor = _cryptoController->prepareDecryptData(message.keyIndex, message.salt);
 		beginOp();//start download timeout
-		emit downloadData(message.dataIndex, data);
+
+		//the server never sends more changes than its download limit before they are acked
+		auto watcher = new QFutureWatcher<QByteArray>{this};
+		connect(watcher, &QFutureWatcherBase::finished,
+				this, &RemoteConnector::applyDownloads);
+		_pendingDownloads.enqueue({message.dataIndex, watcher});
+		const auto cipher = message.data;
+		watcher->setFuture(QtConcurrent::run([decryptor, cipher]() {
+			return decryptor(cipher);
+		}));
 	}
 }
 
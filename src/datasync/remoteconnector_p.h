@@ -6,7 +6,9 @@
 
 #include <QtCore/QObject>
 #include <QtCore/QUuid>
+#include <QtCore/QVersionNumber>
 #include <QtCore/QTimer>
+#include <QtCore/QFutureWatcher>
 
 #include <QtWebSockets/QWebSocket>
 
@@ -21,6 +23,7 @@
 #include "accountmessage_p.h"
 #include "welcomemessage_p.h"
 #include "changemessage_p.h"
+#include "changebatchmessage_p.h"
 #include "changedmessage_p.h"
 #include "devicesmessage_p.h"
 #include "removemessage_p.h"
@@ -74,6 +77,8 @@ public:
 	static const QString keyImportCmac;
 	static const QString keySendCmac;
 
+	static const int MaxActiveDownloads;
+
 	enum RemoteEvent {
 		RemoteDisconnected,
 		RemoteConnecting,
@@ -124,6 +129,7 @@ Q_SIGNALS:
 	void remoteEvent(RemoteEvent event);
 
 	void uploadDone(const QByteArray &key);
+	void uploadsRejected(bool quotaHit);
 	void deviceUploadDone(const QByteArray &key, const QUuid &deviceId);
 	void downloadData(const quint64 key, const QByteArray &changeData);
 
@@ -142,6 +148,8 @@ private Q_SLOTS:
 	void sslErrors(const QList<QSslError> &errors);
 	void ping();
 	void tryClose();
+	void flushUploads();
+	void applyDownloads();
 
 	//statemachine
 	void doConnect();
@@ -152,7 +160,19 @@ private Q_SLOTS:
 	void machineReady();
 
 private:
+	struct PendingUpload {
+		ChangeBatchMessage::Change change; //the data is only encrypted when flushing
+		QByteArray plain;
+		CryptoController::DataCipher encryptor;
+	};
+
+	struct PendingDownload {
+		quint64 key;
+		QFutureWatcher<QByteArray> *watcher;
+	};
+
 	static const QVector<std::chrono::seconds> Timeouts;
+	static const int MaxPendingDownloads;
 
 	CryptoController *_cryptoController;
 
@@ -167,6 +187,13 @@ private:
 	int _retryIndex = 0;
 	bool _expectChanges = false;
 
+	QVersionNumber _serverVersion;
+	QList<PendingUpload> _uploadBatch;
+	//decrypted on the thread pool, but passed on in the order they were received
+	QQueue<PendingDownload> _pendingDownloads;
+	//passed on to the sync controller, but not acked yet - this bounds the queue of its sync thread
+	int _activeDownloads = 0;
+
 	QUuid _deviceId;
 	QList<DeviceInfo> _deviceCache;
 	QHash<QByteArray, CryptoPP::SecByteBlock> _exportsCache;
@@ -184,6 +211,7 @@ private:
 	bool loadIdentity();
 	std::chrono::seconds retry();
 	void clearCaches(bool includeExport);
+	void clearDownloads();
 
 	QVariant sValue(const QString &key) const;
 	RemoteConfig loadConfig() const;
@@ -197,6 +225,7 @@ private:
 	void onWelcome(const WelcomeMessage &message);
 	void onGrant(const GrantMessage &message);
 	void onChangeAck(const ChangeAckMessage &message);
+	void onChangeBatchAck(const ChangeBatchAckMessage &message);
 	void onDeviceChangeAck(const DeviceChangeAckMessage &message);
 	void onChanged(const ChangedMessage &message);
 	void onChangedInfo(const ChangedInfoMessage &message);
@@ -51,6 +51,16 @@ void Setup::removeSetup(const QString &name, bool waitForFinished)
 	}
 }
 
+CacheStatistics Setup::cacheStatistics(const QString &name)
+{
+	return Defaults{DefaultsPrivate::obtainDefaults(name)}.cacheStatistics();
+}
+
+void Setup::reportMemoryPressure(bool critical)
+{
+	DefaultsPrivate::reportMemoryPressure(critical);
+}
+
 QStringList Setup::keystoreProviders()
 {
 	return CryptoController::allKeystoreKeys();
@@ -210,6 +220,46 @@ Setup::EventMode Setup::eventLoggingMode() const
 	return d->properties.value(Defaults::EventLoggingMode).value<EventMode>();
 }
 
+Setup::StorageMode Setup::storageMode() const
+{
+	return d->properties.value(Defaults::StorageMode).value<StorageMode>();
+}
+
+Setup::SynchronousMode Setup::databaseSynchronous() const
+{
+	return d->properties.value(Defaults::DatabaseSynchronous).value<SynchronousMode>();
+}
+
+qint64 Setup::databaseMmapSize() const
+{
+	return d->properties.value(Defaults::DatabaseMmapSize).toLongLong();
+}
+
+int Setup::databaseCacheSize() const
+{
+	return d->properties.value(Defaults::DatabaseCacheSize).toInt();
+}
+
+int Setup::typedCacheSize() const
+{
+	return d->properties.value(Defaults::TypedCacheSize).toInt();
+}
+
+int Setup::cacheWarmupCount() const
+{
+	return d->properties.value(Defaults::CacheWarmupCount).toInt();
+}
+
+int Setup::minimumCacheSize() const
+{
+	return d->properties.value(Defaults::MinimumCacheSize).toInt();
+}
+
+int Setup::sharedCacheSize() const
+{
+	return d->properties.value(Defaults::SharedCacheSize).toInt();
+}
+
 Setup &Setup::setLocalDir(QString localDir)
 {
 	d->localDir = std::move(localDir);
@@ -319,6 +369,54 @@ Setup &Setup::setEventLoggingMode(Setup::EventMode eventLoggingMode)
 	return *this;
 }
 
+Setup &Setup::setStorageMode(Setup::StorageMode storageMode)
+{
+	d->properties.insert(Defaults::StorageMode, QVariant::fromValue(storageMode));
+	return *this;
+}
+
+Setup &Setup::setDatabaseSynchronous(Setup::SynchronousMode databaseSynchronous)
+{
+	d->properties.insert(Defaults::DatabaseSynchronous, QVariant::fromValue(databaseSynchronous));
+	return *this;
+}
+
+Setup &Setup::setDatabaseMmapSize(qint64 databaseMmapSize)
+{
+	d->properties.insert(Defaults::DatabaseMmapSize, databaseMmapSize);
+	return *this;
+}
+
+Setup &Setup::setDatabaseCacheSize(int databaseCacheSize)
+{
+	d->properties.insert(Defaults::DatabaseCacheSize, databaseCacheSize);
+	return *this;
+}
+
+Setup &Setup::setTypedCacheSize(int typedCacheSize)
+{
+	d->properties.insert(Defaults::TypedCacheSize, typedCacheSize);
+	return *this;
+}
+
+Setup &Setup::setCacheWarmupCount(int cacheWarmupCount)
+{
+	d->properties.insert(Defaults::CacheWarmupCount, cacheWarmupCount);
+	return *this;
+}
+
+Setup &Setup::setMinimumCacheSize(int minimumCacheSize)
+{
+	d->properties.insert(Defaults::MinimumCacheSize, minimumCacheSize);
+	return *this;
+}
+
+Setup &Setup::setSharedCacheSize(int sharedCacheSize)
+{
+	d->properties.insert(Defaults::SharedCacheSize, sharedCacheSize);
+	return *this;
+}
+
 Setup &Setup::resetLocalDir()
 {
 	d->localDir = SetupPrivate::DefaultLocalDir;
@@ -424,6 +522,46 @@ Setup &Setup::resetEventLoggingMode()
 	return setEventLoggingMode(EventMode::Unchanged);
 }
 
+Setup &Setup::resetStorageMode()
+{
+	return setStorageMode(StorageMode::Files);
+}
+
+Setup &Setup::resetDatabaseSynchronous()
+{
+	return setDatabaseSynchronous(SynchronousMode::Normal);
+}
+
+Setup &Setup::resetDatabaseMmapSize()
+{
+	return setDatabaseMmapSize(0);
+}
+
+Setup &Setup::resetDatabaseCacheSize()
+{
+	return setDatabaseCacheSize(-2000);
+}
+
+Setup &Setup::resetTypedCacheSize()
+{
+	return setTypedCacheSize(0);
+}
+
+Setup &Setup::resetCacheWarmupCount()
+{
+	return setCacheWarmupCount(0);
+}
+
+Setup &Setup::resetMinimumCacheSize()
+{
+	return setMinimumCacheSize(0);
+}
+
+Setup &Setup::resetSharedCacheSize()
+{
+	return setSharedCacheSize(0);
+}
+
 Setup &Setup::setAccount(const QJsonObject &importData, bool keepData, bool allowFailure)
 {
 	d->initialImport = ExchangeEngine::ImportData {
@@ -637,7 +775,15 @@ SetupPrivate::SetupPrivate() :
 		{Defaults::SignScheme, Setup::ECDSA_ECP_SHA3_512},
 		{Defaults::CryptScheme, Setup::ECIES_ECP_SHA3_512},
 		{Defaults::SymScheme, Setup::AES_EAX},
-		{Defaults::EventLoggingMode, QVariant::fromValue(Setup::EventMode::Unchanged)}
+		{Defaults::EventLoggingMode, QVariant::fromValue(Setup::EventMode::Unchanged)},
+		{Defaults::StorageMode, QVariant::fromValue(Setup::StorageMode::Files)},
+		{Defaults::DatabaseSynchronous, QVariant::fromValue(Setup::SynchronousMode::Normal)},
+		{Defaults::DatabaseMmapSize, 0ll},
+		{Defaults::DatabaseCacheSize, -2000},
+		{Defaults::TypedCacheSize, 0},
+		{Defaults::CacheWarmupCount, 0},
+		{Defaults::MinimumCacheSize, 0},
+		{Defaults::SharedCacheSize, 0}
 	}
 {}
 
@@ -14,6 +14,7 @@ class QLockFile;
 #include "QtDataSync/qtdatasync_global.h"
 #include "QtDataSync/exception.h"
 #include "QtDataSync/remoteconfig.h"
+#include "QtDataSync/cachestatistics.h"
 
 class QJsonSerializer;
 
@@ -97,6 +98,22 @@ class Q_DATASYNC_EXPORT Setup
 	Q_PROPERTY(qint32 cipherKeySize READ cipherKeySize WRITE setCipherKeySize RESET resetCipherKeySize) //MAJOR make uint
 	//! The logging mode for database change events
 	Q_PROPERTY(EventMode eventLoggingMode READ eventLoggingMode WRITE setEventLoggingMode RESET resetEventLoggingMode REVISION 2)
+	//! The way the serialized data of datasets is stored on the disk
+	Q_PROPERTY(StorageMode storageMode READ storageMode WRITE setStorageMode RESET resetStorageMode REVISION 3)
+	//! The sqlite synchronous mode used for the local database
+	Q_PROPERTY(SynchronousMode databaseSynchronous READ databaseSynchronous WRITE setDatabaseSynchronous RESET resetDatabaseSynchronous REVISION 3)
+	//! The maximum number of bytes of the local database sqlite may memory map
+	Q_PROPERTY(qint64 databaseMmapSize READ databaseMmapSize WRITE setDatabaseMmapSize RESET resetDatabaseMmapSize REVISION 3)
+	//! The size of the sqlite page cache for every connection to the local database
+	Q_PROPERTY(int databaseCacheSize READ databaseCacheSize WRITE setDatabaseCacheSize RESET resetDatabaseCacheSize REVISION 3)
+	//! The size of the cache for deserialized gadget values
+	Q_PROPERTY(int typedCacheSize READ typedCacheSize WRITE setTypedCacheSize RESET resetTypedCacheSize REVISION 3)
+	//! The number of recently used datasets per type to preload into the cache on startup
+	Q_PROPERTY(int cacheWarmupCount READ cacheWarmupCount WRITE setCacheWarmupCount RESET resetCacheWarmupCount REVISION 3)
+	//! The size the cache may be shrunk to under memory pressure
+	Q_PROPERTY(int minimumCacheSize READ minimumCacheSize WRITE setMinimumCacheSize RESET resetMinimumCacheSize REVISION 3)
+	//! The size of the cache shared with passive setups in other processes
+	Q_PROPERTY(int sharedCacheSize READ sharedCacheSize WRITE setSharedCacheSize RESET resetSharedCacheSize REVISION 3)
 
 public:
 	//! Typedef of an error handler function. See Setup::fatalErrorHandler
@@ -174,12 +191,32 @@ public:
 	};
 	Q_ENUM(EventMode)
 
+	//! Possible values for the storage mode of dataset payloads
+	enum class StorageMode {
+		Files, //!< Store every dataset in a separate file next to the database
+		Inline //!< Store the datasets directly inside of the sqlite database
+	};
+	Q_ENUM(StorageMode)
+
+	//! Possible values for the sqlite synchronous mode of the local database
+	enum class SynchronousMode {
+		Off = 0, //!< Do not sync to disk at all. Fastest, but a power loss can corrupt the database
+		Normal = 1, //!< Sync only at critical moments. A power loss may roll back the last transactions
+		Full = 2, //!< Sync on every commit
+		Extra = 3 //!< Like Full, but also syncs the directory of the journal
+	};
+	Q_ENUM(SynchronousMode)
+
 	//! Checks if a setup for the given name does already exist
 	static bool exists(const QString &name = DefaultSetup);
 	//! Sets the maximum timeout for shutting down setups
 	static void setCleanupTimeout(unsigned long timeout);
 	//! Stops the datasync instance and removes it
 	static void removeSetup(const QString &name, bool waitForFinished = false);
+	//! Returns the current statistics of the data cache of the given setup
+	static CacheStatistics cacheStatistics(const QString &name = DefaultSetup);
+	//! Shrinks the caches of all adaptive setups to free memory
+	static void reportMemoryPressure(bool critical = false);
 
 	//! Returns a list of all keystore providers defined via the plugins
 	static QStringList keystoreProviders();
@@ -237,6 +274,22 @@ public:
 	qint32 cipherKeySize() const;
 	//! @readAcFn{Setup::eventLoggingMode}
 	EventMode eventLoggingMode() const;
+	//! @readAcFn{Setup::storageMode}
+	StorageMode storageMode() const;
+	//! @readAcFn{Setup::databaseSynchronous}
+	SynchronousMode databaseSynchronous() const;
+	//! @readAcFn{Setup::databaseMmapSize}
+	qint64 databaseMmapSize() const;
+	//! @readAcFn{Setup::databaseCacheSize}
+	int databaseCacheSize() const;
+	//! @readAcFn{Setup::typedCacheSize}
+	int typedCacheSize() const;
+	//! @readAcFn{Setup::cacheWarmupCount}
+	int cacheWarmupCount() const;
+	//! @readAcFn{Setup::minimumCacheSize}
+	int minimumCacheSize() const;
+	//! @readAcFn{Setup::sharedCacheSize}
+	int sharedCacheSize() const;
 
 	//! @writeAcFn{Setup::localDir}
 	Setup &setLocalDir(QString localDir);
@@ -274,6 +327,22 @@ public:
 	Setup &setCipherKeySize(qint32 cipherKeySize);
 	//! @writeAcFn{Setup::eventLoggingMode}
 	Setup &setEventLoggingMode(EventMode eventLoggingMode);
+	//! @writeAcFn{Setup::storageMode}
+	Setup &setStorageMode(StorageMode storageMode);
+	//! @writeAcFn{Setup::databaseSynchronous}
+	Setup &setDatabaseSynchronous(SynchronousMode databaseSynchronous);
+	//! @writeAcFn{Setup::databaseMmapSize}
+	Setup &setDatabaseMmapSize(qint64 databaseMmapSize);
+	//! @writeAcFn{Setup::databaseCacheSize}
+	Setup &setDatabaseCacheSize(int databaseCacheSize);
+	//! @writeAcFn{Setup::typedCacheSize}
+	Setup &setTypedCacheSize(int typedCacheSize);
+	//! @writeAcFn{Setup::cacheWarmupCount}
+	Setup &setCacheWarmupCount(int cacheWarmupCount);
+	//! @writeAcFn{Setup::minimumCacheSize}
+	Setup &setMinimumCacheSize(int minimumCacheSize);
+	//! @writeAcFn{Setup::sharedCacheSize}
+	Setup &setSharedCacheSize(int sharedCacheSize);
 
 	//! @resetAcFn{Setup::localDir}
 	Setup &resetLocalDir();
@@ -311,6 +380,22 @@ public:
 	Setup &resetCipherKeySize();
 	//! @resetAcFn{Setup::resetEventLoggingMode}
 	Setup &resetEventLoggingMode();
+	//! @resetAcFn{Setup::storageMode}
+	Setup &resetStorageMode();
+	//! @resetAcFn{Setup::databaseSynchronous}
+	Setup &resetDatabaseSynchronous();
+	//! @resetAcFn{Setup::databaseMmapSize}
+	Setup &resetDatabaseMmapSize();
+	//! @resetAcFn{Setup::databaseCacheSize}
+	Setup &resetDatabaseCacheSize();
+	//! @resetAcFn{Setup::typedCacheSize}
+	Setup &resetTypedCacheSize();
+	//! @resetAcFn{Setup::cacheWarmupCount}
+	Setup &resetCacheWarmupCount();
+	//! @resetAcFn{Setup::minimumCacheSize}
+	Setup &resetMinimumCacheSize();
+	//! @resetAcFn{Setup::sharedCacheSize}
+	Setup &resetSharedCacheSize();
 
 	//! Sets an account to be imported on creation of the instance
 	Setup &setAccount(const QJsonObject &importData, bool keepData = false, bool allowFailure = false);
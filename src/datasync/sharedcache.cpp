@@ -0,0 +1,214 @@
+#include "sharedcache_p.h"
+
+#include <atomic>
+#include <cstring>
+
+#include <QtCore/QCryptographicHash>
+using namespace QtDataSync;
+
+const quint32 SharedCache::Magic = 0x51445343; // "QDSC"
+const quint32 SharedCache::LayoutVersion = 1;
+const int SharedCache::HeaderSize = 64;
+const int SharedCache::SlotSize = 4096;
+
+QString SharedCache::segmentKey(const QDir &storageDir)
+{
+	//all processes of a setup share the storage directory
+	return QStringLiteral("qtdatasync_cache_") +
+			QString::fromUtf8(QCryptographicHash::hash(storageDir.absolutePath().toUtf8(), QCryptographicHash::Sha3_256).toHex());
+}
+
+SharedCache *SharedCache::create(const QString &key, int size, QString &error)
+{
+	if(size < HeaderSize + SlotSize) {
+		error = QStringLiteral("Shared cache size must be at least %1 bytes").arg(HeaderSize + SlotSize);
+		return nullptr;
+	}
+
+	QScopedPointer<SharedCache> cache{new SharedCache{key}};
+	cache->_writable = true;
+	if(cache->_memory.create(size)) {
+		if(!cache->initialize(error))
+			return nullptr;
+	} else if(cache->_memory.error() == QSharedMemory::AlreadyExists) {
+		//left over by a crashed primary - safe to reuse, as every entry is validated on lookup
+		if(!cache->_memory.attach(QSharedMemory::ReadWrite)) {
+			error = cache->_memory.errorString();
+			return nullptr;
+		}
+		if(!cache->validate(error))
+			return nullptr;
+		cache->unlockSlots();
+	} else {
+		error = cache->_memory.errorString();
+		return nullptr;
+	}
+	return cache.take();
+}
+
+SharedCache *SharedCache::attach(const QString &key, QString &error)
+{
+	QScopedPointer<SharedCache> cache{new SharedCache{key}};
+	if(!cache->_memory.attach(QSharedMemory::ReadOnly)) {
+		error = cache->_memory.errorString();
+		return nullptr;
+	}
+	if(!cache->validate(error))
+		return nullptr;
+	return cache.take();
+}
+
+bool SharedCache::isWritable() const
+{
+	return _writable;
+}
+
+int SharedCache::slotCount() const
+{
+	return _slotCount;
+}
+
+bool SharedCache::insert(const ObjectKey &key, quint64 version, const QByteArray &checksum, const QByteArray &data)
+{
+	if(!_writable)
+		return false;
+	const auto kData = keyData(key);
+	if(static_cast<int>(sizeof(Slot)) + kData.size() + checksum.size() + data.size() > SlotSize)
+		return false; //too large for a slot
+
+	const auto hash = keyHash(kData);
+	auto entry = slot(hash);
+	//lock the slot by making the sequence odd - if another thread is writing it, just skip this one
+	const auto sequence = entry->sequence.load();
+	if((sequence & 1) != 0 || !entry->sequence.testAndSetRelaxed(sequence, sequence + 1))
+		return false;
+	std::atomic_thread_fence(std::memory_order_release);
+
+	entry->keyHash = hash;
+	entry->keySize = static_cast<quint32>(kData.size());
+	entry->checksumSize = static_cast<quint32>(checksum.size());
+	entry->version = version;
+	entry->dataSize = static_cast<quint32>(data.size());
+	auto payload = reinterpret_cast<char*>(entry + 1);
+	std::memcpy(payload, kData.constData(), static_cast<size_t>(kData.size()));
+	payload += kData.size();
+	std::memcpy(payload, checksum.constData(), static_cast<size_t>(checksum.size()));
+	payload += checksum.size();
+	std::memcpy(payload, data.constData(), static_cast<size_t>(data.size()));
+
+	entry->sequence.storeRelease(sequence + 2);
+	return true;
+}
+
+bool SharedCache::lookup(const ObjectKey &key, quint64 version, const QByteArray &checksum, QByteArray &data) const
+{
+	const auto kData = keyData(key);
+	const auto hash = keyHash(kData);
+	auto entry = slot(hash);
+
+	const auto sequence = entry->sequence.loadAcquire();
+	if((sequence & 1) != 0 || sequence == 0) //being written or never used
+		return false;
+	//the header may be torn by a concurrent write - the sequence check below catches that
+	const auto keySize = static_cast<int>(entry->keySize);
+	const auto checksumSize = static_cast<int>(entry->checksumSize);
+	const auto dataSize = static_cast<int>(entry->dataSize);
+	if(entry->keyHash != hash ||
+	   entry->version != version ||
+	   keySize != kData.size() ||
+	   checksumSize != checksum.size() ||
+	   dataSize < 0 ||
+	   static_cast<int>(sizeof(Slot)) + keySize + checksumSize + dataSize > SlotSize)
+		return false;
+
+	QByteArray buffer(keySize + checksumSize + dataSize, Qt::Uninitialized);
+	std::memcpy(buffer.data(), reinterpret_cast<const char*>(entry + 1), static_cast<size_t>(buffer.size()));
+	std::atomic_thread_fence(std::memory_order_acquire);
+	if(entry->sequence.load() != sequence)
+		return false;
+
+	//the copy is consistent, now verify it really is the requested entry
+	if(std::memcmp(buffer.constData(), kData.constData(), static_cast<size_t>(keySize)) != 0 ||
+	   std::memcmp(buffer.constData() + keySize, checksum.constData(), static_cast<size_t>(checksumSize)) != 0)
+		return false;
+	data = buffer.mid(keySize + checksumSize);
+	return true;
+}
+
+SharedCache::SharedCache(const QString &key) :
+	_memory{key},
+	_writable{false},
+	_slotCount{0}
+{}
+
+bool SharedCache::initialize(QString &error)
+{
+	auto header = static_cast<Header*>(_memory.data());
+	if(!header) {
+		error = _memory.errorString();
+		return false;
+	}
+
+	_slotCount = (_memory.size() - HeaderSize) / SlotSize;
+	std::memset(static_cast<char*>(_memory.data()) + sizeof(Header), 0, static_cast<size_t>(_memory.size()) - sizeof(Header));
+	header->layoutVersion = LayoutVersion;
+	header->slotSize = static_cast<quint32>(SlotSize);
+	header->slotCount = static_cast<quint32>(_slotCount);
+	header->magic.storeRelease(Magic);
+	return true;
+}
+
+bool SharedCache::validate(QString &error)
+{
+	auto header = static_cast<const Header*>(_memory.constData());
+	if(!header || header->magic.loadAcquire() != Magic) {
+		error = QStringLiteral("Shared cache segment has not been initialized");
+		return false;
+	}
+	if(header->layoutVersion != LayoutVersion ||
+	   header->slotSize != static_cast<quint32>(SlotSize) ||
+	   header->slotCount == 0 ||
+	   HeaderSize + static_cast<qint64>(header->slotCount) * SlotSize > _memory.size()) {
+		error = QStringLiteral("Shared cache segment has an incompatible layout");
+		return false;
+	}
+
+	_slotCount = static_cast<int>(header->slotCount);
+	return true;
+}
+
+void SharedCache::unlockSlots()
+{
+	//a primary that crashed while writing leaves odd sequences, which would block these slots forever
+	for(auto i = 0; i < _slotCount; i++) {
+		auto entry = reinterpret_cast<Slot*>(static_cast<char*>(_memory.data()) + HeaderSize + i * SlotSize);
+		const auto sequence = entry->sequence.load();
+		if((sequence & 1) == 0)
+			continue;
+		//the content may be torn - make sure it never matches a lookup before releasing the slot
+		entry->keyHash = 0;
+		entry->keySize = 0;
+		entry->checksumSize = 0;
+		entry->version = 0;
+		entry->dataSize = 0;
+		entry->sequence.storeRelease(sequence + 1);
+	}
+}
+
+QByteArray SharedCache::keyData(const ObjectKey &key)
+{
+	return key.typeName + '\0' + key.id.toUtf8();
+}
+
+uint SharedCache::keyHash(const QByteArray &keyData)
+{
+	//explicit seed, as the default one differs between processes
+	return qHashBits(keyData.constData(), static_cast<size_t>(keyData.size()), 0);
+}
+
+SharedCache::Slot *SharedCache::slot(uint hash) const
+{
+	auto base = static_cast<const char*>(_memory.constData()) + HeaderSize;
+	auto offset = static_cast<int>(hash % static_cast<uint>(_slotCount)) * SlotSize;
+	return reinterpret_cast<Slot*>(const_cast<char*>(base + offset));
+}
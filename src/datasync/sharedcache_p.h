@@ -0,0 +1,71 @@
+#ifndef QTDATASYNC_SHAREDCACHE_P_H
+#define QTDATASYNC_SHAREDCACHE_P_H
+
+#include <QtCore/QAtomicInteger>
+#include <QtCore/QDir>
+#include <QtCore/QSharedMemory>
+
+#include "qtdatasync_global.h"
+#include "objectkey.h"
+
+namespace QtDataSync {
+
+//! A cache in shared memory, written by the primary setup and read lock-free by passive ones
+class Q_DATASYNC_EXPORT SharedCache
+{
+	Q_DISABLE_COPY(SharedCache)
+
+public:
+	static const quint32 Magic;
+	static const quint32 LayoutVersion;
+	static const int HeaderSize;
+	static const int SlotSize;
+
+	static QString segmentKey(const QDir &storageDir);
+	//both return nullptr and set the error if the segment is not usable
+	static SharedCache *create(const QString &key, int size, QString &error);
+	static SharedCache *attach(const QString &key, QString &error);
+
+	bool isWritable() const;
+	int slotCount() const;
+
+	bool insert(const ObjectKey &key, quint64 version, const QByteArray &checksum, const QByteArray &data);
+	bool lookup(const ObjectKey &key, quint64 version, const QByteArray &checksum, QByteArray &data) const;
+
+private:
+	struct Header {
+		QAtomicInteger<quint32> magic; //written last, readers must not use the segment before
+		quint32 layoutVersion;
+		quint32 slotSize;
+		quint32 slotCount;
+	};
+
+	// every slot is a seqlock: odd sequence numbers mean the slot is being written
+	struct Slot {
+		QAtomicInteger<quint32> sequence;
+		quint32 keyHash;
+		quint32 keySize;
+		quint32 checksumSize;
+		quint64 version;
+		quint32 dataSize;
+		quint32 reserved;
+		//followed by the key, the checksum and the data
+	};
+
+	QSharedMemory _memory;
+	bool _writable;
+	int _slotCount;
+
+	explicit SharedCache(const QString &key);
+
+	bool initialize(QString &error);
+	bool validate(QString &error);
+	void unlockSlots();
+	static QByteArray keyData(const ObjectKey &key);
+	static uint keyHash(const QByteArray &keyData);
+	Slot *slot(uint hash) const;
+};
+
+}
+
+#endif // QTDATASYNC_SHAREDCACHE_P_H
@@ -2,6 +2,8 @@
 #include "synchelper_p.h"
 #include "conflictresolver.h"
 
+#include <QtCore/QScopedPointer>
+
 using namespace QtDataSync;
 using std::tie;
 
@@ -11,15 +13,35 @@ SyncController::SyncController(const Defaults &defaults, QObject *parent) :
 	Controller{"sync", defaults, parent}
 {}
 
+SyncController::~SyncController()
+{
+	stopStage();
+}
+
 void SyncController::initialize(const QVariantHash &params)
 {
-	_store = params.value(QStringLiteral("store")).value<LocalStore*>();
-	Q_ASSERT_X(_store, Q_FUNC_INFO, "Missing parameter: store (LocalStore)");
+	Q_UNUSED(params)
+	//downloaded changes are applied on an extra thread, so the engine stays responsive during large syncs
+	_stopped = false;
+	_stage = new Stage{this};
+	_stage->setObjectName(QStringLiteral("qtdatasync_sync_%1").arg(defaults().setupName()));
+	_stage->start();
+}
+
+void SyncController::finalize()
+{
+	stopStage();
 }
 
 void SyncController::setSyncEnabled(bool enabled)
 {
 	_enabled = enabled;
+	if(!enabled) {
+		//changes not applied yet are sent again by the server, and acks of the old connection must not reach the new one
+		QMutexLocker _(&_lock);
+		_generation++;
+		_queue.clear();
+	}
 }
 
 void SyncController::syncChange(quint64 key, const QByteArray &changeData)
@@ -27,6 +49,98 @@ void SyncController::syncChange(quint64 key, const QByteArray &changeData)
 	if(!_enabled)
 		return;
 
+	QMutexLocker _(&_lock);
+	if(_stopped) {
+		logWarning() << "Sync thread is not running. Dropping downloaded change";
+		return;
+	}
+	_queue.enqueue({key, changeData, _generation});
+	_queueChanged.wakeAll();
+}
+
+void SyncController::stageDone(quint64 key, quint64 generation)
+{
+	if(_enabled && generation == _generation)
+		emit syncDone(key);
+}
+
+void SyncController::stageFailed(quint64 generation)
+{
+	if(generation == _generation)
+		emit controllerError(tr("Data downloaded from server is invalid."));
+}
+
+void SyncController::resolveQueued()
+{
+	QMutexLocker locker(&_lock);
+	auto conflict = _conflict;
+	if(!conflict || conflict->done)
+		return;
+	locker.unlock();
+
+	try {
+		conflict->result = defaults().conflictResolver()->resolveConflict(conflict->typeId,
+																		  conflict->localData,
+																		  conflict->remoteData);
+	} catch(QException &e) {
+		conflict->error.reset(e.clone());
+	}
+
+	locker.relock();
+	conflict->done = true;
+	_conflictResolved.wakeAll();
+}
+
+void SyncController::work()
+{
+	//the thread needs it's own store, as database connections are per thread
+	QScopedPointer<LocalStore> store;
+	try {
+		store.reset(new LocalStore{defaults()});
+		store->unsubscribeAll(); //only used for storage access, there is no event loop to deliver change signals to
+	} catch(QException &e) {
+		logCritical() << "Failed to open the store of the sync thread:" << e.what();
+	}
+
+	QMutexLocker locker(&_lock);
+	if(!store) {
+		_stopped = true;
+		_queue.clear();
+		QMetaObject::invokeMethod(this, "stageFailed", Qt::QueuedConnection,
+								  Q_ARG(quint64, _generation));
+		return;
+	}
+
+	forever {
+		while(_queue.isEmpty() && !_stopped)
+			_queueChanged.wait(&_lock);
+		if(_stopped)
+			break;
+
+		//the queue is strictly FIFO, so changes are applied and acked in the order the server sent them
+		const auto change = _queue.dequeue();
+		locker.unlock();
+		const auto ok = applyChange(store.data(), change.data);
+		locker.relock();
+
+		if(_stopped) //shutting down, the change might have been aborted while waiting for the resolver
+			break;
+		else if(ok) {
+			QMetaObject::invokeMethod(this, "stageDone", Qt::QueuedConnection,
+									  Q_ARG(quint64, change.key),
+									  Q_ARG(quint64, change.generation));
+		} else {
+			//the engine goes into the error state, so the rest of the connection must not be applied anymore
+			if(change.generation == _generation)
+				_queue.clear();
+			QMetaObject::invokeMethod(this, "stageFailed", Qt::QueuedConnection,
+									  Q_ARG(quint64, change.generation));
+		}
+	}
+}
+
+bool SyncController::applyChange(LocalStore *store, const QByteArray &changeData)
+{
 	try {
 		bool remoteDeleted;
 		ObjectKey objKey;
@@ -34,133 +148,197 @@ void SyncController::syncChange(quint64 key, const QByteArray &changeData)
 		QJsonObject remoteData;
 		tie(remoteDeleted, objKey, remoteVersion, remoteData) = SyncHelper::extract(changeData);
 
-		auto scope = _store->startSync(objKey);
-		LocalStore::ChangeType localState;
-		quint64 localVersion;
-		QString localFileName;
-		QByteArray localChecksum;
-		tie(localState, localVersion, localFileName, localChecksum) = _store->loadChangeInfo(scope);
-
-		const char *syncActionStr = "invalid";
-		const char *syncActionRes = "invalid";
-
-		switch (localState) {
-		case LocalStore::Exists:
-			if(remoteDeleted) { // exists<->deleted
-				syncActionStr = "exists<->deleted";
-				if(localVersion < remoteVersion) {
-					auto persist = defaults().property(Defaults::PersistDeleted).toBool();
-					_store->storeDeleted(scope, remoteVersion, !persist, localState); //store the delete either unchanged or changed, see exchange.txt
-					syncActionRes = "remote";
-				} else if(localVersion == remoteVersion) {
-					switch (static_cast<Setup::SyncPolicy>(defaults().property(Defaults::ConflictPolicy).toInt())) {
-					case Setup::PreferChanged:
-						_store->updateVersion(scope, localVersion, localVersion + 1ull, true); //keep as "v1 + 1"
-						syncActionRes = "local";
-						break;
-					case Setup::PreferDeleted:
-						_store->storeDeleted(scope, remoteVersion + 1ull, true, localState); //store as "v2 + 1"
-						syncActionRes = "remote";
-						break;
-					default:
-						Q_UNREACHABLE();
-						break;
-					}
-				} else //(localVersion > remoteVersion): do nothing
+		Resolution resolution{0, {}, {}, {}, false};
+		while(!storeChange(store, remoteDeleted, objKey, remoteVersion, remoteData, resolution)) {
+			if(!resolveConflict(QMetaType::type(objKey.typeName.constData()), resolution.localData, remoteData, resolution.resolvedData))
+				return false;
+			resolution.resolved = true;
+		}
+		return true;
+	} catch (QException &e) {
+		logCritical() << "Failed to synchronize data:" << e.what();
+		return false;
+	}
+}
+
+bool SyncController::storeChange(LocalStore *store, bool remoteDeleted, const ObjectKey &objKey, quint64 remoteVersion, const QJsonObject &remoteData, Resolution &resolution)
+{
+	auto scope = store->startSync(objKey);
+	LocalStore::ChangeType localState;
+	quint64 localVersion;
+	QString localFileName;
+	QByteArray localChecksum;
+	tie(localState, localVersion, localFileName, localChecksum) = store->loadChangeInfo(scope);
+
+	const char *syncActionStr = "invalid";
+	const char *syncActionRes = "invalid";
+
+	switch (localState) {
+	case LocalStore::Exists:
+		if(remoteDeleted) { // exists<->deleted
+			syncActionStr = "exists<->deleted";
+			if(localVersion < remoteVersion) {
+				auto persist = defaults().property(Defaults::PersistDeleted).toBool();
+				store->storeDeleted(scope, remoteVersion, !persist, localState); //store the delete either unchanged or changed, see exchange.txt
+				syncActionRes = "remote";
+			} else if(localVersion == remoteVersion) {
+				switch (static_cast<Setup::SyncPolicy>(defaults().property(Defaults::ConflictPolicy).toInt())) {
+				case Setup::PreferChanged:
+					store->updateVersion(scope, localVersion, localVersion + 1ull, true); //keep as "v1 + 1"
 					syncActionRes = "local";
-			} else { // exists<->changed
-				syncActionStr = "exists<->changed";
-				if(localVersion < remoteVersion) {
-					_store->storeChanged(scope, remoteVersion, localFileName, remoteData, false, localState); //simply update the local data
+					break;
+				case Setup::PreferDeleted:
+					store->storeDeleted(scope, remoteVersion + 1ull, true, localState); //store as "v2 + 1"
 					syncActionRes = "remote";
-				} else if(localVersion == remoteVersion) {
-					auto remoteChecksum = SyncHelper::jsonHash(remoteData);
-					if(localChecksum != remoteChecksum) { //conflict!
-						QJsonObject resolvedData;
-						auto resolver = defaults().conflictResolver();
-						if(resolver) {
-							auto localData = _store->readJson(objKey, localFileName);
-							resolvedData = resolver->resolveConflict(QMetaType::type(objKey.typeName.constData()), localData, remoteData);
-						}
-						//deterministic alg the chooses 1 dataset no matter which one is local
-						if(!resolvedData.isEmpty()) {
-							_store->storeChanged(scope, localVersion + 1ull, localFileName, resolvedData, true, localState); //store as "v2 + 1"
-							syncActionRes = "merged";
-						} else if(localChecksum > remoteChecksum) {
-							_store->updateVersion(scope, localVersion, localVersion + 1ull, true); //keep as "v1 + 1"
-							syncActionRes = "local";
-						} else {
-							_store->storeChanged(scope, remoteVersion + 1ull, localFileName, remoteData, true, localState); //store as "v2 + 1"
-							syncActionRes = "remote";
+					break;
+				default:
+					Q_UNREACHABLE();
+					break;
+				}
+			} else //(localVersion > remoteVersion): do nothing
+				syncActionRes = "local";
+		} else { // exists<->changed
+			syncActionStr = "exists<->changed";
+			if(localVersion < remoteVersion) {
+				store->storeChanged(scope, remoteVersion, localFileName, remoteData, false, localState); //simply update the local data
+				syncActionRes = "remote";
+			} else if(localVersion == remoteVersion) {
+				auto remoteChecksum = SyncHelper::jsonHash(remoteData);
+				if(localChecksum != remoteChecksum) { //conflict!
+					QJsonObject resolvedData;
+					if(defaults().conflictResolver()) {
+						if(!resolution.resolved ||
+						   resolution.localVersion != localVersion ||
+						   resolution.localChecksum != localChecksum) {
+							//leave the transaction while the resolver runs, and try again with its result
+							resolution = Resolution{localVersion, localChecksum, store->readJson(objKey, localFileName), {}, false};
+							return false;
 						}
-					} else {//(localChecksum == remoteChecksum): mark unchanged, if it was changed, because same data does not need another upload
-						_store->markUnchanged(scope, localVersion, false);
-						syncActionRes = "identical";
+						resolvedData = resolution.resolvedData;
 					}
-				} else //(localVersion > remoteVersion): do nothing
-					syncActionRes = "local";
-			}
-			break;
-		case LocalStore::ExistsDeleted:
-			if(remoteDeleted) { // cachedDelete<->deleted
-				syncActionStr = "cachedDelete<->deleted";
-				syncActionRes = "identical";
-				if(localVersion <= remoteVersion) {
-					if(defaults().property(Defaults::PersistDeleted).toBool()) //when persisting, store the delete
-						_store->updateVersion(scope, localVersion, remoteVersion, false);
-					else //if not, simply delete the cached delete as it is not needed anymore
-						_store->markUnchanged(scope, localVersion, true); //pass local version to make shure it's accepted
-				} //else: do nothing
-			} else { // cachedDelete<->changed
-				syncActionStr = "cachedDelete<->changed";
-				if(localVersion < remoteVersion) {
-					_store->storeChanged(scope, remoteVersion, localFileName, remoteData, false, localState); //simply update the local data
-					syncActionRes = "remote";
-				} else if(localVersion == remoteVersion) {
-					switch (static_cast<Setup::SyncPolicy>(defaults().property(Defaults::ConflictPolicy).toInt())) {
-					case Setup::PreferChanged:
-						_store->storeChanged(scope, remoteVersion + 1ull, localFileName, remoteData, true, localState); //store as "v2 + 1"
-						syncActionRes = "remote";
-						break;
-					case Setup::PreferDeleted:
-						_store->updateVersion(scope, localVersion, localVersion + 1ull, true); //keep as "v1 + 1"
+					//deterministic alg the chooses 1 dataset no matter which one is local
+					if(!resolvedData.isEmpty()) {
+						store->storeChanged(scope, localVersion + 1ull, localFileName, resolvedData, true, localState); //store as "v2 + 1"
+						syncActionRes = "merged";
+					} else if(localChecksum > remoteChecksum) {
+						store->updateVersion(scope, localVersion, localVersion + 1ull, true); //keep as "v1 + 1"
 						syncActionRes = "local";
-						break;
-					default:
-						Q_UNREACHABLE();
-						break;
+					} else {
+						store->storeChanged(scope, remoteVersion + 1ull, localFileName, remoteData, true, localState); //store as "v2 + 1"
+						syncActionRes = "remote";
 					}
-				} else //(localVersion > remoteVersion): do nothing
-					syncActionRes = "local";
-			}
-			break;
-		case LocalStore::NoExists:
-			if(remoteDeleted) { // noexists<->deleted
-				syncActionStr = "noexists<->deleted";
-				syncActionRes = "identical";
+				} else {//(localChecksum == remoteChecksum): mark unchanged, if it was changed, because same data does not need another upload
+					store->markUnchanged(scope, localVersion, false);
+					syncActionRes = "identical";
+				}
+			} else //(localVersion > remoteVersion): do nothing
+				syncActionRes = "local";
+		}
+		break;
+	case LocalStore::ExistsDeleted:
+		if(remoteDeleted) { // cachedDelete<->deleted
+			syncActionStr = "cachedDelete<->deleted";
+			syncActionRes = "identical";
+			if(localVersion <= remoteVersion) {
 				if(defaults().property(Defaults::PersistDeleted).toBool()) //when persisting, store the delete
-					_store->storeDeleted(scope, remoteVersion, false, localState);
-				//else: do nothing
-			} else { // noexists<->changed
-				syncActionStr = "noexists<->changed";
+					store->updateVersion(scope, localVersion, remoteVersion, false);
+				else //if not, simply delete the cached delete as it is not needed anymore
+					store->markUnchanged(scope, localVersion, true); //pass local version to make shure it's accepted
+			} //else: do nothing
+		} else { // cachedDelete<->changed
+			syncActionStr = "cachedDelete<->changed";
+			if(localVersion < remoteVersion) {
+				store->storeChanged(scope, remoteVersion, localFileName, remoteData, false, localState); //simply update the local data
 				syncActionRes = "remote";
-				//no additional info, simply take it (See exchange.txt)
-				_store->storeChanged(scope, remoteVersion, localFileName, remoteData, false, localState);
-			}
-			break;
-		default:
-			Q_UNREACHABLE();
-			break;
+			} else if(localVersion == remoteVersion) {
+				switch (static_cast<Setup::SyncPolicy>(defaults().property(Defaults::ConflictPolicy).toInt())) {
+				case Setup::PreferChanged:
+					store->storeChanged(scope, remoteVersion + 1ull, localFileName, remoteData, true, localState); //store as "v2 + 1"
+					syncActionRes = "remote";
+					break;
+				case Setup::PreferDeleted:
+					store->updateVersion(scope, localVersion, localVersion + 1ull, true); //keep as "v1 + 1"
+					syncActionRes = "local";
+					break;
+				default:
+					Q_UNREACHABLE();
+					break;
+				}
+			} else //(localVersion > remoteVersion): do nothing
+				syncActionRes = "local";
 		}
+		break;
+	case LocalStore::NoExists:
+		if(remoteDeleted) { // noexists<->deleted
+			syncActionStr = "noexists<->deleted";
+			syncActionRes = "identical";
+			if(defaults().property(Defaults::PersistDeleted).toBool()) //when persisting, store the delete
+				store->storeDeleted(scope, remoteVersion, false, localState);
+			//else: do nothing
+		} else { // noexists<->changed
+			syncActionStr = "noexists<->changed";
+			syncActionRes = "remote";
+			//no additional info, simply take it (See exchange.txt)
+			store->storeChanged(scope, remoteVersion, localFileName, remoteData, false, localState);
+		}
+		break;
+	default:
+		Q_UNREACHABLE();
+		break;
+	}
 
-		logDebug().nospace() << "Synced " << objKey
-							 << " with action(" << syncActionStr << "), result is data of: "
-							 << syncActionRes;
+	logDebug().nospace() << "Synced " << objKey
+						 << " with action(" << syncActionStr << "), result is data of: "
+						 << syncActionRes;
 
-		_store->commitSync(scope);
-		emit syncDone(key);
-	} catch (QException &e) {
-		logCritical() << "Failed to synchronize data:" << e.what();
-		emit controllerError(tr("Data downloaded from server is invalid."));
+	store->commitSync(scope);
+	return true;
+}
+
+bool SyncController::resolveConflict(int typeId, const QJsonObject &localData, const QJsonObject &remoteData, QJsonObject &result)
+{
+	//the resolver lives on the engine thread, so it is called there while the sync thread waits for the result
+	QMutexLocker _(&_lock);
+	auto conflict = QSharedPointer<Conflict>::create(Conflict{typeId, localData, remoteData, {}, {}, false});
+	_conflict = conflict;
+	QMetaObject::invokeMethod(this, "resolveQueued", Qt::QueuedConnection);
+	while(!conflict->done && !_stopped)
+		_conflictResolved.wait(&_lock);
+	_conflict.reset();
+
+	if(!conflict->done)
+		return false;
+	if(conflict->error)
+		conflict->error->raise();
+	result = conflict->result;
+	return true;
+}
+
+void SyncController::stopStage()
+{
+	if(!_stage)
+		return;
+
+	{
+		QMutexLocker _(&_lock);
+		_stopped = true;
+		_queue.clear();
+		_queueChanged.wakeAll();
+		_conflictResolved.wakeAll();
 	}
+	_stage->wait();
+	delete _stage;
+	_stage = nullptr;
 }
+
+
+
+SyncController::Stage::Stage(SyncController *owner) :
+	_owner{owner}
+{}
+
+void SyncController::Stage::run()
+{
+	_owner->work();
+}
+
@@ -1,6 +1,12 @@
 #ifndef QTDATASYNC_SYNCCONTROLLER_P_H
 #define QTDATASYNC_SYNCCONTROLLER_P_H
 
+#include <QtCore/QMutex>
+#include <QtCore/QQueue>
+#include <QtCore/QSharedPointer>
+#include <QtCore/QThread>
+#include <QtCore/QWaitCondition>
+
 #include "qtdatasync_global.h"
 #include "controller_p.h"
 #include "localstore_p.h"
@@ -13,8 +19,10 @@ class Q_DATASYNC_EXPORT SyncController : public Controller
 
 public:
 	explicit SyncController(const Defaults &defaults, QObject *parent = nullptr);
+	~SyncController() override;
 
 	void initialize(const QVariantHash &params) override;
+	void finalize() override;
 
 public Q_SLOTS:
 	void setSyncEnabled(bool enabled);
@@ -23,9 +31,70 @@ public Q_SLOTS:
 Q_SIGNALS:
 	void syncDone(quint64 key);
 
+private Q_SLOTS:
+	void stageDone(quint64 key, quint64 generation);
+	void stageFailed(quint64 generation);
+	void resolveQueued();
+
 private:
-	LocalStore *_store = nullptr;
+	class Stage : public QThread
+	{
+	public:
+		Stage(SyncController *owner);
+
+	protected:
+		void run() override;
+
+	private:
+		SyncController *_owner;
+	};
+
+	struct QueuedChange {
+		quint64 key;
+		QByteArray data;
+		quint64 generation;
+	};
+
+	struct Conflict {
+		int typeId;
+		QJsonObject localData;
+		QJsonObject remoteData;
+		QJsonObject result;
+		QSharedPointer<QException> error;
+		bool done;
+	};
+
+	struct Resolution {
+		quint64 localVersion;
+		QByteArray localChecksum;
+		QJsonObject localData;
+		QJsonObject resolvedData;
+		bool resolved;
+	};
+
 	bool _enabled = false;
+	Stage *_stage = nullptr;
+
+	//guards everything below, shared with the sync thread
+	QMutex _lock;
+	QWaitCondition _queueChanged;
+	bool _stopped = true; //until initialize() started the thread
+	quint64 _generation = 0;
+	QQueue<QueuedChange> _queue; //bounded by the remote connector, which passes on only RemoteConnector::MaxActiveDownloads unacked changes
+	QWaitCondition _conflictResolved;
+	QSharedPointer<Conflict> _conflict;
+
+	void work();
+	bool applyChange(LocalStore *store, const QByteArray &changeData);
+	//returns false if a conflict must be resolved first, without storing anything
+	bool storeChange(LocalStore *store,
+					 bool remoteDeleted,
+					 const ObjectKey &objKey,
+					 quint64 remoteVersion,
+					 const QJsonObject &remoteData,
+					 Resolution &resolution);
+	bool resolveConflict(int typeId, const QJsonObject &localData, const QJsonObject &remoteData, QJsonObject &result);
+	void stopStage();
 };
 
 }
@@ -73,6 +73,12 @@ void SyncManager::initReplica(QRemoteObjectNode *node)
 			this, PSIG(&SyncManager::syncProgressChanged));
 	connect(d->replica, &SyncManagerPrivateReplica::lastErrorChanged,
 			this, PSIG(&SyncManager::lastErrorChanged));
+	connect(d->replica, &SyncManagerPrivateReplica::uploadWindowChanged,
+			this, PSIG(&SyncManager::uploadWindowChanged));
+	connect(d->replica, &SyncManagerPrivateReplica::uploadRttChanged,
+			this, PSIG(&SyncManager::uploadRttChanged));
+	connect(d->replica, &SyncManagerPrivateReplica::pendingChangesChanged,
+			this, PSIG(&SyncManager::pendingChangesChanged));
 	connect(d->replica, &SyncManagerPrivateReplica::stateReached,
 			this, &SyncManager::onStateReached);
 	connect(d->replica, &SyncManagerPrivateReplica::initialized,
@@ -111,6 +117,21 @@ QString SyncManager::lastError() const
 	return d->replica->lastError();
 }
 
+int SyncManager::uploadWindow() const
+{
+	return d->replica->uploadWindow();
+}
+
+int SyncManager::uploadRtt() const
+{
+	return d->replica->uploadRtt();
+}
+
+int SyncManager::pendingChanges() const
+{
+	return d->replica->pendingChanges();
+}
+
 void SyncManager::runOnDownloaded(const function<void (SyncManager::SyncState)> &resultFn, bool triggerSync)
 {
 	runImp(true, triggerSync, resultFn);
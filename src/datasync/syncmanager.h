@@ -31,6 +31,12 @@ class Q_DATASYNC_EXPORT SyncManager : public QObject
 	Q_PROPERTY(qreal syncProgress READ syncProgress NOTIFY syncProgressChanged)
 	//! Holds a description of the last internal error
 	Q_PROPERTY(QString lastError READ lastError NOTIFY lastErrorChanged)
+	//! Holds the number of changes that are currently uploaded in parallel at most
+	Q_PROPERTY(int uploadWindow READ uploadWindow NOTIFY uploadWindowChanged REVISION 3)
+	//! Holds the smoothed round trip time of change uploads, in milliseconds
+	Q_PROPERTY(int uploadRtt READ uploadRtt NOTIFY uploadRttChanged REVISION 3)
+	//! Holds the number of local changes that still have to be uploaded
+	Q_PROPERTY(int pendingChanges READ pendingChanges NOTIFY pendingChangesChanged REVISION 3)
 
 public:
 	//! The possible states the sync engine can be in
@@ -65,6 +71,12 @@ public:
 	qreal syncProgress() const;
 	//! @readAcFn{lastError}
 	QString lastError() const;
+	//! @readAcFn{uploadWindow}
+	int uploadWindow() const;
+	//! @readAcFn{uploadRtt}
+	int uploadRtt() const;
+	//! @readAcFn{pendingChanges}
+	int pendingChanges() const;
 
 	//! Performs an operation once all changes have been downloaded
 	void runOnDownloaded(const std::function<void(SyncState)> &resultFn, bool triggerSync = true);
@@ -91,6 +103,12 @@ Q_SIGNALS:
 	void syncProgressChanged(qreal syncProgress, QPrivateSignal);
 	//! @notifyAcFn{lastError}
 	void lastErrorChanged(const QString &lastError, QPrivateSignal);
+	//! @notifyAcFn{uploadWindow}
+	QT_DATASYNC_REVISION_3 void uploadWindowChanged(int uploadWindow, QPrivateSignal);
+	//! @notifyAcFn{uploadRtt}
+	QT_DATASYNC_REVISION_3 void uploadRttChanged(int uploadRtt, QPrivateSignal);
+	//! @notifyAcFn{pendingChanges}
+	QT_DATASYNC_REVISION_3 void pendingChangesChanged(int pendingChanges, QPrivateSignal);
 
 protected:
 	//! @private
@@ -13,6 +13,12 @@ SyncManagerPrivate::SyncManagerPrivate(ExchangeEngine *engineParent) :
 			this, &SyncManagerPrivate::lastErrorChanged);
 	connect(_engine->remoteConnector(), &RemoteConnector::syncEnabledChanged,
 			this, &SyncManagerPrivate::syncEnabledChanged);
+	connect(_engine->changeController(), &ChangeController::uploadWindowChanged,
+			this, &SyncManagerPrivate::uploadWindowChanged);
+	connect(_engine->changeController(), &ChangeController::uploadRttChanged,
+			this, &SyncManagerPrivate::uploadRttChanged);
+	connect(_engine->changeController(), &ChangeController::pendingChangesChanged,
+			this, &SyncManagerPrivate::pendingChangesChanged);
 }
 
 QString SyncManagerPrivate::setupName() const
@@ -40,6 +46,21 @@ QString SyncManagerPrivate::lastError() const
 	return _engine->lastError();
 }
 
+int SyncManagerPrivate::uploadWindow() const
+{
+	return _engine->changeController()->uploadWindow();
+}
+
+int SyncManagerPrivate::uploadRtt() const
+{
+	return _engine->changeController()->uploadRtt();
+}
+
+int SyncManagerPrivate::pendingChanges() const
+{
+	return _engine->changeController()->pendingChanges();
+}
+
 void SyncManagerPrivate::setSyncEnabled(bool syncEnabled)
 {
 	_engine->remoteConnector()->setSyncEnabled(syncEnabled);
@@ -23,6 +23,9 @@ public:
 	SyncManager::SyncState syncState() const override;
 	qreal syncProgress() const override;
 	QString lastError() const override;
+	int uploadWindow() const override;
+	int uploadRtt() const override;
+	int pendingChanges() const override;
 
 	void setSyncEnabled(bool syncEnabled) override;
 
@@ -1,7 +1,64 @@
 #include "qqmldatastore.h"
 #include <QtQml>
+#include <QtCore/QFutureWatcher>
 using namespace QtDataSync;
 
+namespace {
+
+template <typename T>
+void watchAsync(const QQmlDataStore *store,
+				const QFuture<T> &future,
+				const QJSValue &resultFn,
+				const QJSValue &errorFn,
+				const std::function<QJSValueList(QJSEngine*, QFuture<T>)> &resultArgs)
+{
+	auto owner = const_cast<QQmlDataStore*>(store);
+	auto watcher = new QFutureWatcher<T>{owner};
+	QObject::connect(watcher, &QFutureWatcherBase::finished, owner, [owner, watcher, resultFn, errorFn, resultArgs]() {
+		watcher->deleteLater();
+		auto future = watcher->future();
+		try {
+			future.waitForFinished(); //rethrows the error of the operation
+			if(resultFn.isCallable()) {
+				auto fnCopy = resultFn;
+				fnCopy.call(resultArgs(qjsEngine(owner), future));
+			}
+		} catch(QException &e) {
+			if(errorFn.isCallable()) {
+				auto fnCopy = errorFn;
+				fnCopy.call({ QString::fromUtf8(e.what()) });
+			} else
+				qmlWarning(owner) << e.what();
+		}
+	});
+	watcher->setFuture(future);
+}
+
+QJSValue toJsValue(QJSEngine *engine, const QVariant &result)
+{
+	if(!engine)
+		return {};
+	//loaded objects have no parent and would leak, unless the JS engine takes them
+	if(QMetaType::typeFlags(result.userType()).testFlag(QMetaType::PointerToQObject)) {
+		auto object = result.value<QObject*>();
+		if(object && !object->parent())
+			QQmlEngine::setObjectOwnership(object, QQmlEngine::JavaScriptOwnership);
+	}
+	return engine->toScriptValue(result);
+}
+
+QJSValue toJsList(QJSEngine *engine, const QList<QVariant> &results)
+{
+	if(!engine)
+		return {};
+	auto list = engine->newArray(static_cast<uint>(results.size()));
+	for(auto i = 0; i < results.size(); i++)
+		list.setProperty(static_cast<quint32>(i), toJsValue(engine, results[i]));
+	return list;
+}
+
+}
+
 QQmlDataStore::QQmlDataStore(QObject *parent) :
 	DataStore(parent, nullptr),
 	QQmlParserStatus(),
@@ -121,6 +178,46 @@ void QQmlDataStore::clear(const QString &typeName)
 	}
 }
 
+void QQmlDataStore::loadAsync(const QString &typeName, const QString &key, const QJSValue &resultFn, const QJSValue &errorFn) const
+{
+	watchAsync<QVariant>(this, DataStore::loadAsync(QMetaType::type(typeName.toUtf8()), key), resultFn, errorFn,
+						 [](QJSEngine *engine, const QFuture<QVariant> &future) -> QJSValueList {
+		return { toJsValue(engine, future.result()) };
+	});
+}
+
+void QQmlDataStore::loadAllAsync(const QString &typeName, const QJSValue &resultFn, const QJSValue &errorFn) const
+{
+	watchAsync<QVariant>(this, DataStore::loadAllAsync(QMetaType::type(typeName.toUtf8())), resultFn, errorFn,
+						 [](QJSEngine *engine, const QFuture<QVariant> &future) -> QJSValueList {
+		return { toJsList(engine, future.results()) };
+	});
+}
+
+void QQmlDataStore::saveAsync(const QString &typeName, const QVariant &value, const QJSValue &completedFn, const QJSValue &errorFn)
+{
+	watchAsync<void>(this, DataStore::saveAsync(QMetaType::type(typeName.toUtf8()), value), completedFn, errorFn,
+					 [](QJSEngine *, const QFuture<void> &) -> QJSValueList {
+		return {};
+	});
+}
+
+void QQmlDataStore::removeAsync(const QString &typeName, const QString &key, const QJSValue &resultFn, const QJSValue &errorFn)
+{
+	watchAsync<bool>(this, DataStore::removeAsync(QMetaType::type(typeName.toUtf8()), key), resultFn, errorFn,
+					 [](QJSEngine *, const QFuture<bool> &future) -> QJSValueList {
+		return { future.result() };
+	});
+}
+
+void QQmlDataStore::searchAsync(const QString &typeName, const QString &query, const QJSValue &resultFn, DataStore::SearchMode mode, const QJSValue &errorFn) const
+{
+	watchAsync<QVariant>(this, DataStore::searchAsync(QMetaType::type(typeName.toUtf8()), query, mode), resultFn, errorFn,
+						 [](QJSEngine *engine, const QFuture<QVariant> &future) -> QJSValueList {
+		return { toJsList(engine, future.results()) };
+	});
+}
+
 QString QQmlDataStore::typeName(int typeId) const
 {
 	return QString::fromUtf8(QMetaType::typeName(typeId));
@@ -4,6 +4,7 @@
 #include <QtCore/QObject>
 
 #include <QtQml/QQmlParserStatus>
+#include <QtQml/QJSValue>
 
 #include <QtDataSync/datastore.h>
 
@@ -152,6 +153,57 @@ public:
 	 */
 	Q_INVOKABLE void clear(const QString &typeName);
 
+	/*! @brief @copybrief ::QtDataSync::DataStore::loadAsync(const QString &) const
+	 *
+	 * @param typeName The QMetaType type name of the type
+	 * @param key The key of the dataset to be loaded
+	 * @param resultFn A function to be called with the loaded dataset
+	 * @param errorFn A function to be called with the error message if loading failed
+	 *
+	 * @sa ::QtDataSync::DataStore::loadAsync(int, const QString &) const
+	 */
+	Q_INVOKABLE QT_DATASYNC_REVISION_3 void loadAsync(const QString &typeName, const QString &key, const QJSValue &resultFn, const QJSValue &errorFn = {}) const;
+	/*! @brief @copybrief ::QtDataSync::DataStore::loadAllAsync() const
+	 *
+	 * @param typeName The QMetaType type name of the type
+	 * @param resultFn A function to be called with a list of all datasets stored for the given type
+	 * @param errorFn A function to be called with the error message if loading failed
+	 *
+	 * @sa ::QtDataSync::DataStore::loadAllAsync(int) const
+	 */
+	Q_INVOKABLE QT_DATASYNC_REVISION_3 void loadAllAsync(const QString &typeName, const QJSValue &resultFn, const QJSValue &errorFn = {}) const;
+	/*! @brief @copybrief ::QtDataSync::DataStore::saveAsync(const T &)
+	 *
+	 * @param typeName The QMetaType type name of the type
+	 * @param value The dataset to be stored
+	 * @param completedFn A function to be called without arguments once the dataset was saved
+	 * @param errorFn A function to be called with the error message if saving failed
+	 *
+	 * @sa ::QtDataSync::DataStore::saveAsync(int, QVariant)
+	 */
+	Q_INVOKABLE QT_DATASYNC_REVISION_3 void saveAsync(const QString &typeName, const QVariant &value, const QJSValue &completedFn = {}, const QJSValue &errorFn = {});
+	/*! @brief @copybrief ::QtDataSync::DataStore::removeAsync(const QString &)
+	 *
+	 * @param typeName The QMetaType type name of the type
+	 * @param key The key of the dataset to be removed
+	 * @param resultFn A function to be called with `true` in case the dataset was removed, `false` if it did not exist
+	 * @param errorFn A function to be called with the error message if removing failed
+	 *
+	 * @sa ::QtDataSync::DataStore::removeAsync(int, const QString &)
+	 */
+	Q_INVOKABLE QT_DATASYNC_REVISION_3 void removeAsync(const QString &typeName, const QString &key, const QJSValue &resultFn = {}, const QJSValue &errorFn = {});
+	/*! @brief @copybrief ::QtDataSync::DataStore::searchAsync(const QString &, DataStore::SearchMode) const
+	 *
+	 * @param typeName The QMetaType type name of the type
+	 * @param query A search query to be used to find fitting datasets. Format depends on mode
+	 * @param resultFn A function to be called with a list of all datasets that keys matched the search query
+	 * @param mode Specifies how to interpret the search `query` See DataStore::SearchMode documentation
+	 * @param errorFn A function to be called with the error message if searching failed
+	 *
+	 * @sa ::QtDataSync::DataStore::searchAsync(int, const QString &, DataStore::SearchMode) const
+	 */
+	Q_INVOKABLE QT_DATASYNC_REVISION_3 void searchAsync(const QString &typeName, const QString &query, const QJSValue &resultFn, DataStore::SearchMode mode = DataStore::RegexpMode, const QJSValue &errorFn = {}) const;
+
 	/*! @brief Returns the name of the type identified by the given type id
 	 *
 	 * @param typeId The QMetaType type id of the type
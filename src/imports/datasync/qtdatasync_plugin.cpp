@@ -54,8 +54,10 @@ void QtDataSyncDeclarativeModule::registerTypes(const char *uri)
 
 	//Version 4.1
 	qmlRegisterModule(uri, 4, 1);
+	qmlRegisterType<QtDataSync::QQmlDataStore, 2>(uri, 4, 1, "DataStore");
 
 	//Version 4.2
+	qmlRegisterType<QtDataSync::QQmlDataStore, 3>(uri, 4, 2, "DataStore");
 	qmlRegisterUncreatableType<QtDataSync::EventCursor>(uri, 4, 2, "EventCursor", QStringLiteral("Use the EventLog singleton to create EventCursors"));
 	qmlRegisterSingletonType<QtDataSync::QQmlEventCursor>(uri, 4, 2, "EventLog", createEventLogInstance);
 #ifdef Q_OS_ANDROID
@@ -0,0 +1,29 @@
+#include "changebatchmessage_p.h"
+using namespace QtDataSync;
+using std::get;
+
+const QVersionNumber ChangeBatchMessage::MinVersion(1, 1);
+
+const QMetaObject *ChangeBatchMessage::getMetaObject() const
+{
+	return &staticMetaObject;
+}
+
+bool ChangeBatchMessage::validate()
+{
+	return !changes.isEmpty();
+}
+
+
+
+ChangeBatchAckMessage::ChangeBatchAckMessage(const ChangeBatchMessage &message)
+{
+	dataIds.reserve(message.changes.size());
+	for(const auto &change : message.changes)
+		dataIds.append(get<0>(change));
+}
+
+const QMetaObject *ChangeBatchAckMessage::getMetaObject() const
+{
+	return &staticMetaObject;
+}
@@ -0,0 +1,53 @@
+#ifndef QTDATASYNC_CHANGEBATCHMESSAGE_P_H
+#define QTDATASYNC_CHANGEBATCHMESSAGE_P_H
+
+#include <tuple>
+
+#include <QtCore/QList>
+#include <QtCore/QVersionNumber>
+
+#include "message_p.h"
+
+namespace QtDataSync {
+
+class Q_DATASYNC_EXPORT ChangeBatchMessage : public Message
+{
+	Q_GADGET
+
+	Q_PROPERTY(QList<QtDataSync::ChangeBatchMessage::Change> changes MEMBER changes)
+
+public:
+	using Change = std::tuple<QByteArray, quint32, QByteArray, QByteArray>; // (dataId, keyIndex, salt, data)
+
+	//the protocol version a remote must have to understand batches
+	static const QVersionNumber MinVersion;
+
+	QList<Change> changes;
+
+protected:
+	const QMetaObject *getMetaObject() const override;
+	bool validate() override;
+};
+
+class Q_DATASYNC_EXPORT ChangeBatchAckMessage : public Message
+{
+	Q_GADGET
+
+	Q_PROPERTY(QByteArrayList dataIds MEMBER dataIds)
+
+public:
+	ChangeBatchAckMessage(const ChangeBatchMessage &message = {});
+
+	QByteArrayList dataIds;
+
+protected:
+	const QMetaObject *getMetaObject() const override;
+};
+
+}
+
+Q_DECLARE_METATYPE(QtDataSync::ChangeBatchMessage)
+Q_DECLARE_METATYPE(QtDataSync::ChangeBatchMessage::Change)
+Q_DECLARE_METATYPE(QtDataSync::ChangeBatchAckMessage)
+
+#endif // QTDATASYNC_CHANGEBATCHMESSAGE_P_H
@@ -4,6 +4,7 @@
 #include <QtCore/QMetaProperty>
 #include <QtCore/QVersionNumber>
 
+#include "changebatchmessage_p.h"
 #include "devicesmessage_p.h"
 #include "devicekeysmessage_p.h"
 #include "newkeymessage_p.h"
@@ -28,6 +29,7 @@ void Message::registerTypes()
 
 	qRegisterMetaType<Utf8String>();
 	qRegisterMetaTypeStreamOperators<Utf8String>();
+	REGISTER_LIST(QtDataSync::ChangeBatchMessage::Change);
 	REGISTER_LIST(QtDataSync::DevicesMessage::DeviceInfo);
 	REGISTER_LIST(QtDataSync::DeviceKeysMessage::DeviceKey);
 	REGISTER_LIST(QtDataSync::NewKeyMessage::KeyUpdate);
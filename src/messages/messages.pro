@@ -17,6 +17,7 @@ HEADERS += \
 	errormessage_p.h \
 	syncmessage_p.h \
 	changemessage_p.h \
+	changebatchmessage_p.h \
 	changedmessage_p.h \
 	devicesmessage_p.h \
 	removemessage_p.h \
@@ -40,6 +41,7 @@ SOURCES += \
 	errormessage.cpp \
 	syncmessage.cpp \
 	changemessage.cpp \
+	changebatchmessage.cpp \
 	changedmessage.cpp \
 	devicesmessage.cpp \
 	removemessage.cpp \
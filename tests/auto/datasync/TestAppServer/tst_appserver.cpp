@@ -23,6 +23,7 @@
 #include <QtDataSync/private/grantmessage_p.h>
 #include <QtDataSync/private/macupdatemessage_p.h>
 #include <QtDataSync/private/changemessage_p.h>
+#include <QtDataSync/private/changebatchmessage_p.h>
 #include <QtDataSync/private/changedmessage_p.h>
 #include <QtDataSync/private/syncmessage_p.h>
 #include <QtDataSync/private/devicechangemessage_p.h>
@@ -1015,6 +1016,18 @@ void TestAppServer::testChangeUpload()
 			QCOMPARE(message.dataId, dataId1);
 			ok = true;
 		}));
+
+		//send 1 and 2 again, as one batch
+		ChangeBatchMessage batchMsg;
+		batchMsg.changes.append(std::make_tuple(dataId1, keyIndex, salt, data));
+		batchMsg.changes.append(std::make_tuple(dataId2, keyIndex, salt, data));
+		client->send(batchMsg);
+
+		//wait for the single ack
+		QVERIFY(client->waitForReply<ChangeBatchAckMessage>([&](ChangeBatchAckMessage message, bool &ok) {
+			QCOMPARE(message.dataIds, QByteArrayList({dataId1, dataId2}));
+			ok = true;
+		}));
 	} catch(std::exception &e) {
 		QFAIL(e.what());
 	}
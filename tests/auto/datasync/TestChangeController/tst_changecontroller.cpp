@@ -26,6 +26,7 @@ private Q_SLOTS:
 	void testChanges();
 
 	void testDeviceChanges();
+	void testUploadWindow();
 
 	//last test, to avoid problems
 	void testChangeTriggers();
@@ -181,6 +182,7 @@ void TestChangeController::testDeviceChanges()
 	QSignalSpy deviceChangeSpy(controller, &ChangeController::uploadDeviceChange);
 	QSignalSpy addedSpy(controller, &ChangeController::progressAdded);
 	QSignalSpy incrementSpy(controller, &ChangeController::progressIncrement);
+	QSignalSpy pendingSpy(controller, &ChangeController::pendingChangesChanged);
 	QSignalSpy errorSpy(controller, &ChangeController::controllerError);
 
 	try {
@@ -209,6 +211,9 @@ void TestChangeController::testDeviceChanges()
 		QCOMPARE(addedSpy.takeFirst()[0].toUInt(), 5u);
 		QVERIFY(activeSpy.last()[0].toBool());
 		QCOMPARE(store->changeCount(), 5u);
+		QCOMPARE(controller->pendingChanges(), 5);
+		QVERIFY(!pendingSpy.isEmpty());
+		QCOMPARE(pendingSpy.last()[0].toInt(), 5);
 
 		auto change = changeSpy.takeFirst();
 		auto keyHash = change[0].toByteArray();
@@ -216,6 +221,7 @@ void TestChangeController::testDeviceChanges()
 		QCOMPARE(changeSpy.size(), 1);
 		QCOMPARE(deviceChangeSpy.size(), 3);
 		QCOMPARE(store->changeCount(), 4u);
+		QCOMPARE(controller->pendingChanges(), 4); //updated by the ack itself
 		QCOMPARE(incrementSpy.size(), 1);
 
 		change = changeSpy.takeFirst();
@@ -224,6 +230,7 @@ void TestChangeController::testDeviceChanges()
 		QCOMPARE(changeSpy.size(), 0);
 		QCOMPARE(deviceChangeSpy.size(), 3);
 		QCOMPARE(store->changeCount(), 3u);
+		QCOMPARE(controller->pendingChanges(), 3);
 		QCOMPARE(incrementSpy.size(), 2);
 
 		change = deviceChangeSpy.takeFirst();
@@ -232,6 +239,7 @@ void TestChangeController::testDeviceChanges()
 		QCOMPARE(changeSpy.size(), 0);
 		QCOMPARE(deviceChangeSpy.size(), 2);
 		QCOMPARE(store->changeCount(), 2u);
+		QCOMPARE(controller->pendingChanges(), 2);
 		QCOMPARE(incrementSpy.size(), 3);
 
 		change = deviceChangeSpy.takeFirst();
@@ -240,6 +248,7 @@ void TestChangeController::testDeviceChanges()
 		QCOMPARE(changeSpy.size(), 0);
 		QCOMPARE(deviceChangeSpy.size(), 1);
 		QCOMPARE(store->changeCount(), 1u);
+		QCOMPARE(controller->pendingChanges(), 1);
 		QCOMPARE(incrementSpy.size(), 4);
 
 		change = deviceChangeSpy.takeFirst();
@@ -249,6 +258,8 @@ void TestChangeController::testDeviceChanges()
 		QCOMPARE(deviceChangeSpy.size(), 0);
 		QCOMPARE(store->changeCount(), 0u);
 		QCOMPARE(incrementSpy.size(), 5);
+		QCOMPARE(controller->pendingChanges(), 0);
+		QCOMPARE(pendingSpy.last()[0].toInt(), 0);
 
 		QVERIFY(!deviceChangeSpy.wait());
 		QVERIFY(changeSpy.isEmpty());
@@ -261,6 +272,81 @@ void TestChangeController::testDeviceChanges()
 	controller->clearUploads();
 }
 
+void TestChangeController::testUploadWindow()
+{
+	controller->setUploadingEnabled(false);
+	QCoreApplication::processEvents();
+	QSignalSpy changeSpy(controller, &ChangeController::uploadChange);
+	QSignalSpy windowSpy(controller, &ChangeController::uploadWindowChanged);
+	QSignalSpy rttSpy(controller, &ChangeController::uploadRttChanged);
+	QSignalSpy errorSpy(controller, &ChangeController::controllerError);
+
+	try {
+		//the server limit caps the window
+		controller->updateUploadLimit(4);
+		QCOMPARE(controller->uploadWindow(), 4);
+		QCOMPARE(controller->uploadRtt(), -1);
+		QCOMPARE(windowSpy.size(), 1);
+		QCOMPARE(windowSpy.takeFirst()[0].toInt(), 4);
+		rttSpy.clear();
+
+		store->reset(false);
+		for(auto i = 0; i < 6; i++)
+			store->save(TestLib::generateKey(50 + i), TestLib::generateDataJson(50 + i));
+
+		//only as many as the window allows are uploaded
+		controller->setUploadingEnabled(true);
+		if(!errorSpy.isEmpty())
+			QFAIL(errorSpy.takeFirst()[0].toString().toUtf8().constData());
+		QCOMPARE(changeSpy.size(), 4);
+
+		//a fast ack measures the rtt, but the window can't grow beyond the limit
+		controller->uploadDone(changeSpy.takeFirst()[0].toByteArray());
+		QCOMPARE(rttSpy.size(), 1);
+		QVERIFY(controller->uploadRtt() >= 0);
+		QCOMPARE(controller->uploadWindow(), 4);
+		QVERIFY(windowSpy.isEmpty());
+		QTRY_COMPARE(changeSpy.size(), 4); //the free spot is used again
+
+		//errors halve the window, quota errors reset it to the minimum
+		controller->uploadsRejected(false);
+		QCOMPARE(controller->uploadWindow(), 2);
+		controller->uploadsRejected(true);
+		QCOMPARE(controller->uploadWindow(), 1);
+		QCOMPARE(windowSpy.size(), 2);
+		QCOMPARE(windowSpy.takeFirst()[0].toInt(), 2);
+		QCOMPARE(windowSpy.takeFirst()[0].toInt(), 1);
+
+		//without active uploads, nothing was rejected
+		controller->clearUploads();
+		controller->uploadsRejected(false);
+		QCOMPARE(controller->uploadWindow(), 1);
+
+		//a new connection starts over with the initial window and no rtt
+		controller->updateUploadLimit(20);
+		QCOMPARE(controller->uploadWindow(), ChangeController::InitialUploadWindow);
+		QCOMPARE(controller->uploadRtt(), -1);
+		QCOMPARE(windowSpy.size(), 1);
+		QCOMPARE(rttSpy.size(), 2);
+		QCOMPARE(rttSpy.last()[0].toInt(), -1);
+
+		//a lower limit clamps the window itself, so backing off works right away
+		controller->updateUploadLimit(4);
+		QCOMPARE(controller->uploadWindow(), 4);
+		changeSpy.clear();
+		controller->setUploadingEnabled(true);
+		QTRY_COMPARE(changeSpy.size(), 4);
+		controller->uploadsRejected(false);
+		QCOMPARE(controller->uploadWindow(), 2);
+		controller->updateUploadLimit(10);
+
+		store->reset(false);
+	} catch(QException &e) {
+		QFAIL(e.what());
+	}
+	controller->clearUploads();
+}
+
 void TestChangeController::testChangeTriggers()
 {
 	for(auto i = 0; i < 5; i++) { //wait for the engine to init itself
@@ -0,0 +1,8 @@
+include(../tests.pri)
+
+QT       += concurrent
+
+TARGET = tst_concurrentcache
+
+SOURCES += \
+		tst_concurrentcache.cpp
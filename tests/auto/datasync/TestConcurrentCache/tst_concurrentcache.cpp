@@ -0,0 +1,260 @@
+#include <QString>
+#include <QtTest>
+#include <QCoreApplication>
+#include <QtConcurrent>
+#include <QtDataSync/private/concurrentcache_p.h>
+#include <QtDataSync/objectkey.h>
+using namespace QtDataSync;
+
+class TestConcurrentCache : public QObject
+{
+	Q_OBJECT
+
+private Q_SLOTS:
+	void testInsertLookup();
+	void testEviction();
+	void testOversized();
+	void testStatistics();
+	void testResize();
+	void testParallelAccess();
+
+	void testReadScaling_data();
+	void testReadScaling();
+
+private:
+	static const int KeyCount = 1000;
+	static const int ReadsPerThread = 200000;
+
+	static ObjectKey key(int index);
+	static QJsonObject value(int index);
+};
+
+void TestConcurrentCache::testInsertLookup()
+{
+	ConcurrentCache<ObjectKey, QJsonObject> cache{1024};
+	QJsonObject data;
+	QVERIFY(!cache.object(key(1), data));
+	QVERIFY(!cache.contains(key(1)));
+
+	QVERIFY(cache.insert(key(1), value(1), 10));
+	QVERIFY(cache.insert(key(2), value(2), 20));
+	QVERIFY(cache.contains(key(1)));
+	QVERIFY(cache.object(key(2), data));
+	QCOMPARE(data, value(2));
+	QCOMPARE(cache.count(), 2);
+	QCOMPARE(cache.totalCost(), 30);
+
+	//replace
+	QVERIFY(cache.insert(key(1), value(3), 5));
+	QVERIFY(cache.object(key(1), data));
+	QCOMPARE(data, value(3));
+	QCOMPARE(cache.count(), 2);
+	QCOMPARE(cache.totalCost(), 25);
+
+	QVERIFY(cache.remove(key(1)));
+	QVERIFY(!cache.remove(key(1)));
+	QCOMPARE(cache.totalCost(), 20);
+
+	cache.clear();
+	QCOMPARE(cache.count(), 0);
+	QCOMPARE(cache.totalCost(), 0);
+	QVERIFY(!cache.object(key(2), data));
+}
+
+void TestConcurrentCache::testEviction()
+{
+	ConcurrentCache<ObjectKey, QJsonObject> cache{100}; //small -> single shard
+	for(auto i = 0; i < 10; i++)
+		QVERIFY(cache.insert(key(i), value(i), 10));
+	QCOMPARE(cache.totalCost(), 100);
+
+	//recently read entries survive the next eviction
+	QJsonObject data;
+	QVERIFY(cache.object(key(0), data));
+	QVERIFY(cache.insert(key(10), value(10), 10));
+	QCOMPARE(cache.totalCost(), 100);
+	QCOMPARE(cache.count(), 10);
+	QVERIFY(cache.contains(key(0)));
+	QVERIFY(!cache.contains(key(1)));
+	QVERIFY(cache.contains(key(10)));
+
+	//larger entries evict as many as needed
+	QVERIFY(cache.insert(key(11), value(11), 35));
+	QVERIFY(cache.totalCost() <= 100);
+	QVERIFY(cache.contains(key(11)));
+}
+
+void TestConcurrentCache::testOversized()
+{
+	ConcurrentCache<ObjectKey, QJsonObject> cache{100};
+	QVERIFY(cache.insert(key(1), value(1), 50));
+	QVERIFY(!cache.insert(key(1), value(2), 101));
+	//an oversized replacement drops the old entry, like QCache
+	QVERIFY(!cache.contains(key(1)));
+	QCOMPARE(cache.totalCost(), 0);
+}
+
+void TestConcurrentCache::testStatistics()
+{
+	ConcurrentCache<ObjectKey, QJsonObject> cache{100};
+	QJsonObject data;
+	for(auto i = 0; i < 10; i++)
+		QVERIFY(cache.insert(key(i), value(i), 10));
+	QVERIFY(cache.object(key(0), data));
+	QVERIFY(cache.object(key(1), data));
+	QVERIFY(!cache.object(key(20), data));
+	QVERIFY(cache.peek(key(2), data)); //not counted
+	QVERIFY(cache.insert(key(10), value(10), 20));
+
+	auto statistics = cache.statistics();
+	QCOMPARE(statistics.hits, 2ull);
+	QCOMPARE(statistics.misses, 1ull);
+	QCOMPARE(statistics.evictions, 2ull);
+
+	auto entries = 0;
+	auto cost = 0;
+	cache.forEach([&](const ObjectKey &, int entryCost) {
+		entries++;
+		cost += entryCost;
+	});
+	QCOMPARE(entries, cache.count());
+	QCOMPARE(cost, cache.totalCost());
+}
+
+void TestConcurrentCache::testResize()
+{
+	ConcurrentCache<ObjectKey, QJsonObject> cache{100};
+	for(auto i = 0; i < 10; i++)
+		QVERIFY(cache.insert(key(i), value(i), 10));
+
+	//shrinking evicts right away
+	cache.setMaxCost(40);
+	QCOMPARE(cache.maxCost(), 40);
+	QCOMPARE(cache.totalCost(), 40);
+	QCOMPARE(cache.count(), 4);
+	QVERIFY(!cache.insert(key(20), value(20), 50));
+
+	//growing makes room again
+	cache.setMaxCost(100);
+	for(auto i = 10; i < 16; i++)
+		QVERIFY(cache.insert(key(i), value(i), 10));
+	QCOMPARE(cache.totalCost(), 100);
+}
+
+void TestConcurrentCache::testParallelAccess()
+{
+	ConcurrentCache<ObjectKey, QJsonObject> cache{4 * 1024 * 1024};
+	QThreadPool pool;
+	pool.setMaxThreadCount(8);
+
+	QList<QFuture<bool>> futures;
+	for(auto t = 0; t < 8; t++) {
+		futures.append(QtConcurrent::run(&pool, [&cache, t]() {
+			QJsonObject data;
+			for(auto i = 0; i < 20000; i++) {
+				auto index = (i * 7 + t) % 500;
+				switch(i % 4) {
+				case 0:
+					cache.insert(key(index), value(index), 100);
+					break;
+				case 1:
+					cache.remove(key(index));
+					break;
+				default:
+					//a hit must always deliver the value of its key
+					if(cache.object(key(index), data) && data != value(index))
+						return false;
+					break;
+				}
+			}
+			return true;
+		}));
+	}
+	for(auto &future : futures)
+		QVERIFY(future.result());
+	QVERIFY(cache.totalCost() <= cache.maxCost());
+}
+
+void TestConcurrentCache::testReadScaling_data()
+{
+	QTest::addColumn<int>("threads");
+	QTest::addColumn<bool>("sharded");
+
+	for(auto threads : {1, 2, 4, 8}) {
+		QTest::addRow("qcache-%d", threads) << threads << false;
+		QTest::addRow("sharded-%d", threads) << threads << true;
+	}
+}
+
+void TestConcurrentCache::testReadScaling()
+{
+	QFETCH(int, threads);
+	QFETCH(bool, sharded);
+
+	//baseline: what the setup cache used before - QCache reorders on read, so it needs exclusive locking
+	QMutex baseLock;
+	QCache<ObjectKey, QJsonObject> baseCache{64 * 1024 * 1024};
+	ConcurrentCache<ObjectKey, QJsonObject> cache{64 * 1024 * 1024};
+	for(auto i = 0; i < KeyCount; i++) {
+		if(sharded)
+			cache.insert(key(i), value(i), 100);
+		else
+			baseCache.insert(key(i), new QJsonObject{value(i)}, 100);
+	}
+	QVector<ObjectKey> keys;
+	keys.reserve(KeyCount);
+	for(auto i = 0; i < KeyCount; i++)
+		keys.append(key(i));
+
+	QThreadPool pool;
+	pool.setMaxThreadCount(threads);
+	QElapsedTimer timer;
+	QBENCHMARK_ONCE {
+		timer.start();
+		QList<QFuture<int>> futures;
+		for(auto t = 0; t < threads; t++) {
+			futures.append(QtConcurrent::run(&pool, [&, t]() {
+				auto hits = 0;
+				QJsonObject data;
+				for(auto i = 0; i < ReadsPerThread; i++) {
+					const auto &readKey = keys[(i * 31 + t) % KeyCount];
+					if(sharded) {
+						if(cache.object(readKey, data))
+							hits++;
+					} else {
+						QMutexLocker _(&baseLock);
+						auto json = baseCache.object(readKey);
+						if(json) {
+							data = *json;
+							hits++;
+						}
+					}
+				}
+				return hits;
+			}));
+		}
+		for(auto &future : futures)
+			QCOMPARE(future.result(), static_cast<int>(ReadsPerThread));
+	}
+
+	auto elapsed = std::max<qint64>(timer.elapsed(), 1);
+	qInfo() << (sharded ? "sharded cache:" : "qcache:") << threads << "threads performed"
+			<< (static_cast<qint64>(ReadsPerThread) * threads) / elapsed << "reads/ms";
+}
+
+ObjectKey TestConcurrentCache::key(int index)
+{
+	return {"TestData", QString::number(index)};
+}
+
+QJsonObject TestConcurrentCache::value(int index)
+{
+	return QJsonObject {
+		{QStringLiteral("id"), index},
+		{QStringLiteral("text"), QString::number(index)}
+	};
+}
+
+QTEST_MAIN(TestConcurrentCache)
+
+#include "tst_concurrentcache.moc"
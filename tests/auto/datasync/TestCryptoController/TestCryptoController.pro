@@ -1,5 +1,7 @@
 include(../tests.pri)
 
+QT       += concurrent
+
 TARGET = tst_cryptocontroller
 
 SOURCES += \
@@ -1,6 +1,7 @@
 #include <QString>
 #include <QtTest>
 #include <QCoreApplication>
+#include <QtConcurrent>
 #include <testlib.h>
 #include <QtDataSync/private/cryptocontroller_p.h>
 
@@ -244,6 +245,19 @@ void TestCryptoController::testSymCrypto()
 		fakeMsg[2] = fakeMsg[2] + (char)1;
 		QVERIFY_EXCEPTION_THROWN(controller->decryptData(index, salt, fakeMsg), CryptoException);
 
+		//split encryption, with the cipher run on another thread
+		CryptoController::DataCipher encryptor;
+		std::tie(index, salt, encryptor) = controller->prepareEncryptData();
+		cipher = QtConcurrent::run([encryptor, message]() {
+			return encryptor(message);
+		}).result();
+		QCOMPARE(controller->decryptData(index, salt, cipher), message);
+		auto decryptor = controller->prepareDecryptData(index, salt);
+		QCOMPARE(QtConcurrent::run([decryptor, cipher]() {
+			return decryptor(cipher);
+		}).result(), message);
+		QVERIFY_EXCEPTION_THROWN(controller->prepareDecryptData(index, fakeSalt)(cipher), CryptoException);
+
 		//cmac
 		QByteArray mac;
 		mac = controller->createCmac(message);
@@ -1,5 +1,7 @@
 include(../tests.pri)
 
+QT       += concurrent
+
 TARGET = tst_datastore
 
 SOURCES += \
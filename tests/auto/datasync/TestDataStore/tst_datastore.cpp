@@ -1,6 +1,7 @@
 #include <QString>
 #include <QtTest>
 #include <QCoreApplication>
+#include <QtConcurrent>
 #include <testlib.h>
 #include <testobject.h>
 using namespace QtDataSync;
@@ -24,11 +25,18 @@ private Q_SLOTS:
 	void testRemove_data();
 	void testRemove();
 	void testClear();
+	void testBatch();
+	void testFindBy();
+	void testTypedCache();
+	void testKeyPages();
 
 	void testUpdate();
 	void testUpdateInvalid();
 
 	void testChangeSignals();
+	void testBatchSignals();
+	void testSubscriptions();
+	void testAsync();
 
 private:
 	DataStore *store;
@@ -225,6 +233,207 @@ void TestDataStore::testClear()
 	}
 }
 
+void TestDataStore::testBatch()
+{
+	QSignalSpy changeSpy(store, &DataStore::dataChanged);
+
+	try {
+		auto data = TestLib::generateData(80, 89);
+		store->saveAll(data);
+		QCOMPARE(store->count<TestData>(), 10ull);
+		QCOMPAREUNORDERED(store->loadAll<TestData>(), data);
+		QCOMPARE(changeSpy.size(), 10);
+		changeSpy.clear();
+
+		//update existing and add new ones
+		data = TestLib::generateData(85, 94);
+		for(auto &d : data)
+			d.text = QStringLiteral("batched");
+		store->saveAll(data);
+		QCOMPARE(store->count<TestData>(), 15ull);
+		QCOMPARE(store->load<TestData>(85), data.first());
+		QCOMPARE(changeSpy.size(), 10);
+		changeSpy.clear();
+
+		//remove, including non existing keys
+		QCOMPARE(store->removeAll<TestData>(QList<int>{80, 81, 82, 200}), 3);
+		QCOMPARE(store->count<TestData>(), 12ull);
+		QVERIFY_EXCEPTION_THROWN(store->load<TestData>(80), NoDataException);
+		QCOMPARE(changeSpy.size(), 3);
+		for(const auto &sig : changeSpy)
+			QCOMPARE(sig[2].toBool(), true);
+		changeSpy.clear();
+
+		//invalid data must not store anything
+		QVERIFY_EXCEPTION_THROWN(store->saveAll(qMetaTypeId<TestData>(), {
+											QVariant::fromValue(TestLib::generateData(95)),
+											42
+										}), InvalidDataException);
+		QCOMPARE(store->count<TestData>(), 12ull);
+		QVERIFY(changeSpy.isEmpty());
+
+		QCOMPARE(store->removeAll<TestData>(store->keys<TestData>()), 12);
+		QCOMPARE(store->count<TestData>(), 0ull);
+	} catch(QException &e) {
+		QFAIL(e.what());
+	}
+}
+
+void TestDataStore::testFindBy()
+{
+	auto generate = [](int from, int to) {
+		QList<IndexedData> list;
+		for(auto i = from; i <= to; i++)
+			list.append({i, QString::number(i)});
+		return list;
+	};
+
+	try {
+		store->saveAll(generate(100, 109));
+
+		//exact and range matches
+		QCOMPARE(store->findBy<IndexedData>(QStringLiteral("text"), QStringLiteral("105")),
+				 generate(105, 105));
+		QCOMPARE(store->findBy<IndexedData>(QStringLiteral("text"), QStringLiteral("101"), QStringLiteral("103")),
+				 generate(101, 103));
+		QVERIFY(store->findBy<IndexedData>(QStringLiteral("text"), QStringLiteral("baum")).isEmpty());
+
+		//index follows updates and removals
+		store->save<IndexedData>({105, QStringLiteral("baum")});
+		QVERIFY(store->findBy<IndexedData>(QStringLiteral("text"), QStringLiteral("105")).isEmpty());
+		QCOMPARE(store->findBy<IndexedData>(QStringLiteral("text"), QStringLiteral("baum")),
+				 (QList<IndexedData>{IndexedData{105, QStringLiteral("baum")}}));
+		QVERIFY(store->remove<IndexedData>(102));
+		QCOMPARE(store->findBy<IndexedData>(QStringLiteral("text"), QStringLiteral("101"), QStringLiteral("103")),
+				 generate(101, 101) + generate(103, 103));
+
+		//only declared properties can be queried
+		QVERIFY_EXCEPTION_THROWN(store->findBy<IndexedData>(QStringLiteral("id"), 101), LocalStoreException);
+		QVERIFY_EXCEPTION_THROWN(store->findBy<TestData>(QStringLiteral("text"), QStringLiteral("101")), LocalStoreException);
+
+		store->clear<IndexedData>();
+		QVERIFY(store->findBy<IndexedData>(QStringLiteral("text"), QStringLiteral("101"), QStringLiteral("109")).isEmpty());
+	} catch(QException &e) {
+		QFAIL(e.what());
+	}
+}
+
+void TestDataStore::testKeyPages()
+{
+	try {
+		store->saveAll(TestLib::generateData(1000, 1249));
+		QCOMPARE(store->count<TestData>(), 250ull);
+
+		//forward enumeration, page by page
+		QStringList allKeys;
+		QString afterKey;
+		forever {
+			auto page = store->keys<TestData>(afterKey, 100);
+			allKeys.append(page);
+			if(page.size() < 100)
+				break;
+			afterKey = page.last();
+		}
+		QCOMPARE(allKeys.size(), 250);
+		QCOMPARE(allKeys.first(), QStringLiteral("1000"));
+		QCOMPARE(allKeys.last(), QStringLiteral("1249"));
+		auto sortedKeys = allKeys;
+		std::sort(sortedKeys.begin(), sortedKeys.end());
+		QCOMPARE(allKeys, sortedKeys);
+
+		//reverse enumeration
+		auto page = store->keys<TestData>(QStringLiteral("1100"), 3, true);
+		QCOMPARE(page, (QStringList{QStringLiteral("1099"), QStringLiteral("1098"), QStringLiteral("1097")}));
+		page = store->keys<TestData>({}, 2, true);
+		QCOMPARE(page, (QStringList{QStringLiteral("1249"), QStringLiteral("1248")}));
+
+		//removed keys are skipped, the counts follow every change
+		QVERIFY(store->remove<TestData>(1001));
+		store->save(TestLib::generateData(1001));
+		QVERIFY(store->remove<TestData>(1001));
+		QCOMPARE(store->removeAll<TestData>({QStringLiteral("1002"), QStringLiteral("1003")}), 2);
+		page = store->keys<TestData>(QStringLiteral("1000"), 2);
+		QCOMPARE(page, (QStringList{QStringLiteral("1004"), QStringLiteral("1005")}));
+		QCOMPARE(store->count<TestData>(), 247ull);
+		QCOMPARE(store->count<TestData>(), static_cast<quint64>(store->keys<TestData>().size()));
+
+		//the model only loads the pages it needs
+		DataStoreModel model(store);
+		model.setTypeId<TestData>();
+		QCOMPARE(model.rowCount(), 0);
+		QVERIFY(model.canFetchMore({}));
+		model.fetchMore({});
+		QCOMPARE(model.rowCount(), 100);
+		//new keys after the current page come with a later page, only once
+		store->save(TestLib::generateData(1300));
+		model.fetchMore({});
+		QCOMPARE(model.rowCount(), 200);
+		while(model.canFetchMore({}))
+			model.fetchMore({});
+		QCOMPARE(model.rowCount(), 248);
+		QCOMPARE(model.key(model.index(247)), QStringLiteral("1300"));
+
+		store->clear<TestData>();
+		QCOMPARE(store->count<TestData>(), 0ull);
+	} catch(QException &e) {
+		QFAIL(e.what());
+	}
+}
+
+void TestDataStore::testTypedCache()
+{
+	try {
+		const auto sName = QStringLiteral("testTypedCache_setup");
+		Setup setup;
+		TestLib::setup(setup);
+		setup.setLocalDir(setup.localDir() + QLatin1Char('/') + sName)
+				.setTypedCacheSize(1024 * 1024);
+		setup.create(sName);
+		{
+			DataStore cachedStore{sName};
+			cachedStore.save(TestLib::generateData(42));
+
+			//repeated loads are served from the value cache
+			QCOMPARE(cachedStore.load<TestData>(42), TestLib::generateData(42));
+			QCOMPARE(cachedStore.load<TestData>(42), TestLib::generateData(42));
+
+			//saving replaces the cached value
+			cachedStore.save<TestData>({42, QStringLiteral("baum")});
+			QCOMPARE(cachedStore.load<TestData>(42), TestData(42, QStringLiteral("baum")));
+
+			//changes from other stores of the same setup are seen as well
+			DataStore otherStore{sName};
+			otherStore.save<TestData>({42, QStringLiteral("tree")});
+			QCOMPARE(cachedStore.load<TestData>(42), TestData(42, QStringLiteral("tree")));
+			QVERIFY(otherStore.remove<TestData>(42));
+			QVERIFY_EXCEPTION_THROWN(cachedStore.load<TestData>(42), NoDataException);
+
+			//values loaded while saving must never outlive the save
+			for(auto i = 0; i < 20; i++) {
+				QAtomicInt started;
+				auto reader = QtConcurrent::run([&](){
+					DataStore readStore{sName};
+					started = 1;
+					for(auto j = 0; j < 100; j++) {
+						try {
+							readStore.load<TestData>(43);
+						} catch(NoDataException &) {}
+					}
+				});
+				while(started == 0)
+					QThread::yieldCurrentThread();
+				const TestData data{43, QStringLiteral("race%1").arg(i)};
+				otherStore.save(data);
+				reader.waitForFinished();
+				QCOMPARE(cachedStore.load<TestData>(43), data);
+			}
+		}
+		Setup::removeSetup(sName, true);
+	} catch(QException &e) {
+		QFAIL(e.what());
+	}
+}
+
 void TestDataStore::testUpdate()
 {
 	auto dataObj = new TestObject(this);
@@ -342,6 +551,196 @@ void TestDataStore::testChangeSignals()
 	}
 }
 
+void TestDataStore::testBatchSignals()
+{
+	try {
+		store->clear<TestData>();
+	} catch(QException &e) {
+		QFAIL(e.what());
+	}
+
+	QSignalSpy store1Spy(store, &DataStore::dataChangedBatch);
+	do //clear out any remaining signals
+		store1Spy.clear();
+	while(store1Spy.wait());
+
+	DataStore second(this);
+	QSignalSpy store2Spy(&second, &DataStore::dataChangedBatch);
+	DataStoreModel model(&second);
+	model.setTypeId<TestData>();
+	QSignalSpy resetSpy(&model, &DataStoreModel::modelReset);
+	QSignalSpy removeSpy(&model, &DataStoreModel::rowsRemoved);
+
+	try {
+		//local batches are reported once, synchronously
+		store->saveAll(TestLib::generateData(500, 599));
+		QCOMPARE(store1Spy.size(), 1);
+		auto sig = store1Spy.takeFirst();
+		QCOMPARE(sig[0].toInt(), qMetaTypeId<TestData>());
+		QCOMPARE(sig[1].toStringList().size(), 100);
+		QCOMPARE(sig[2].toBool(), false);
+
+		//other stores get the whole batch in one event
+		QVERIFY(store2Spy.wait());
+		QCOMPARE(store2Spy.size(), 1);
+		sig = store2Spy.takeFirst();
+		QCOMPARE(sig[1].toStringList().size(), 100);
+		QCOMPARE(sig[2].toBool(), false);
+		while(model.canFetchMore({}))
+			model.fetchMore({});
+		QCOMPARE(model.rowCount(), 100);
+
+		//single changes in quick succession are merged
+		store->save(TestLib::generateData(600));
+		store->save(TestLib::generateData(601));
+		QCOMPARE(store1Spy.size(), 2);
+		QStringList keys;
+		while(keys.size() < 2 && store2Spy.wait()) {
+			for(const auto &batch : qAsConst(store2Spy))
+				keys.append(batch[1].toStringList());
+			store2Spy.clear();
+		}
+		QCOMPARE(keys, (QStringList{QStringLiteral("600"), QStringLiteral("601")}));
+
+		while(model.canFetchMore({}))
+			model.fetchMore({});
+		QCOMPARE(model.rowCount(), 102);
+
+		//removed rows are reported as one range per adjacent block
+		resetSpy.clear();
+		store2Spy.clear();
+		QList<int> removedIds;
+		for(auto i = 510; i < 520; i++)
+			removedIds.append(i);
+		removedIds.append(530);
+		QCOMPARE(store->removeAll<TestData>(removedIds), 11);
+		QVERIFY(store2Spy.wait());
+		QCOMPARE(store2Spy.size(), 1);
+		QCOMPARE(removeSpy.size(), 2);
+		QCOMPARE(removeSpy[0][1].toInt(), 30); //removed backwards
+		QCOMPARE(removeSpy[0][2].toInt(), 30);
+		QCOMPARE(removeSpy[1][1].toInt(), 10);
+		QCOMPARE(removeSpy[1][2].toInt(), 19);
+		QCOMPARE(model.rowCount(), 91);
+		QCOMPARE(model.key(model.index(10, 0)), QStringLiteral("520"));
+
+		//clearing removes all rows at once
+		removeSpy.clear();
+		store2Spy.clear();
+		store->clear<TestData>();
+		QVERIFY(store2Spy.wait());
+		QCOMPARE(store2Spy.size(), 1);
+		QCOMPARE(store2Spy.first()[2].toBool(), true);
+		QCOMPARE(resetSpy.size(), 0);
+		QCOMPARE(removeSpy.size(), 1);
+		QCOMPARE(removeSpy[0][1].toInt(), 0);
+		QCOMPARE(removeSpy[0][2].toInt(), 90);
+		QCOMPARE(model.rowCount(), 0);
+	} catch(QException &e) {
+		QFAIL(e.what());
+	}
+}
+
+void TestDataStore::testSubscriptions()
+{
+	DataStore all(this);
+	QSignalSpy allSpy(&all, &DataStore::dataChangedBatch);
+	DataStore prefixed(this);
+	prefixed.subscribe<TestData>(QStringLiteral("71"));
+	QSignalSpy prefixSpy(&prefixed, &DataStore::dataChangedBatch);
+	DataStore muted(this);
+	muted.subscribe<TestData>();
+	muted.unsubscribe<TestData>();
+	QSignalSpy mutedSpy(&muted, &DataStore::dataChangedBatch);
+
+	try {
+		//only the matching keys are delivered
+		store->saveAll(TestLib::generateData(700, 719));
+		QTRY_COMPARE(allSpy.size(), 1);
+		QTRY_COMPARE(prefixSpy.size(), 1);
+		QCOMPARE(allSpy.takeFirst()[1].toStringList().size(), 20);
+		auto keys = prefixSpy.takeFirst()[1].toStringList();
+		QCOMPARE(keys.size(), 10);
+		for(const auto &key : keys)
+			QVERIFY(key.startsWith(QStringLiteral("71")));
+		QCOMPARE(mutedSpy.size(), 0);
+
+		//own changes are filtered as well
+		prefixed.save(TestLib::generateData(720));
+		QCOMPARE(prefixSpy.size(), 0);
+		prefixed.save(TestLib::generateData(711));
+		QCOMPARE(prefixSpy.size(), 1);
+		prefixSpy.clear();
+		keys.clear();
+		forever {
+			for(const auto &batch : qAsConst(allSpy))
+				keys.append(batch[1].toStringList());
+			allSpy.clear();
+			if(keys.size() >= 2 || !allSpy.wait())
+				break;
+		}
+		QCOMPARE(keys, (QStringList{QStringLiteral("720"), QStringLiteral("711")}));
+		QCOMPARE(mutedSpy.size(), 0);
+
+		//without subscriptions, everything is reported again
+		muted.clearSubscriptions();
+		store->remove<TestData>(700);
+		QTRY_COMPARE(mutedSpy.size(), 1);
+		QCOMPARE(mutedSpy.takeFirst()[2].toBool(), true);
+		QCOMPARE(prefixSpy.size(), 0);
+
+		store->clear<TestData>();
+	} catch(QException &e) {
+		QFAIL(e.what());
+	}
+}
+
+void TestDataStore::testAsync()
+{
+	try {
+		//writes and reads of one type are ordered, so no waiting is needed in between
+		QList<QFuture<void>> saves;
+		for(const auto &data : TestLib::generateData(800, 819))
+			saves.append(store->saveAsync(data));
+		auto loadFuture = store->loadAsync<TestData>(QStringLiteral("805"));
+		auto allFuture = store->loadAllAsync<TestData>();
+		auto searchFuture = store->searchAsync<TestData>(QStringLiteral("81*"), DataStore::WildcardMode);
+		auto removeFuture = store->removeAsync<TestData>(QStringLiteral("805"));
+		auto missingFuture = store->loadAsync<TestData>(QStringLiteral("805"));
+
+		for(auto &future : saves) {
+			future.waitForFinished();
+			QVERIFY(future.isFinished());
+		}
+		QCOMPARE(loadFuture.result(), TestLib::generateData(805));
+		QCOMPARE(allFuture.results().size(), 20);
+		auto found = searchFuture.results();
+		QCOMPARE(found.size(), 10);
+		for(const auto &data : found)
+			QVERIFY(QString::number(data.id).startsWith(QStringLiteral("81")));
+		QCOMPARE(removeFuture.result(), true);
+		QVERIFY_EXCEPTION_THROWN(missingFuture.waitForFinished(), NoDataException);
+		QCOMPARE(store->count<TestData>(), 19ull);
+
+		//the generic variants report the same
+		auto variantFuture = store->loadAsync(qMetaTypeId<TestData>(), QStringLiteral("806"));
+		QCOMPARE(variantFuture.result().value<TestData>(), TestLib::generateData(806));
+		QCOMPARE(store->removeAsync(qMetaTypeId<TestData>(), QStringLiteral("805")).result(), false);
+
+		//changes made on the I/O threads are reported as usual
+		QSignalSpy spy(store, &DataStore::dataChanged);
+		store->saveAsync(TestLib::generateData(820)).waitForFinished();
+		//earlier async changes may still be queued as well
+		QTRY_VERIFY(std::any_of(spy.constBegin(), spy.constEnd(), [](const QList<QVariant> &args) {
+			return args[1].toString() == QStringLiteral("820");
+		}));
+
+		store->clear<TestData>();
+	} catch(QException &e) {
+		QFAIL(e.what());
+	}
+}
+
 QTEST_MAIN(TestDataStore)
 
 #include "tst_datastore.moc"
@@ -10,3 +10,14 @@ bool TestData::operator ==(const TestData &other) const
 	return id == other.id &&
 			text == other.text;
 }
+
+IndexedData::IndexedData(int id, QString text) :
+	id(id),
+	text(text)
+{}
+
+bool IndexedData::operator ==(const IndexedData &other) const
+{
+	return id == other.id &&
+			text == other.text;
+}
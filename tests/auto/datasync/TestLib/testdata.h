@@ -21,4 +21,24 @@ public:
 
 Q_DECLARE_METATYPE(TestData)
 
+class IndexedData
+{
+	Q_GADGET
+	Q_CLASSINFO("qtdatasync_index", "text")
+	Q_CLASSINFO("qtdatasync_fulltext", "text")
+
+	Q_PROPERTY(int id MEMBER id USER true)
+	Q_PROPERTY(QString text MEMBER text)
+
+public:
+	IndexedData(int id = -1, QString text = {});
+
+	bool operator ==(const IndexedData &other) const;
+
+	int id;
+	QString text;
+};
+
+Q_DECLARE_METATYPE(IndexedData)
+
 #endif // TESTDATA_H
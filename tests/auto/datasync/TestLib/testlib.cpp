@@ -9,6 +9,8 @@ void TestLib::init(const QByteArray &keystorePath)
 	qputenv("PLUGIN_KEYSTORES_PATH", keystorePath);
 	qRegisterMetaType<TestData>();
 	QJsonSerializer::registerListConverters<TestData>();
+	qRegisterMetaType<IndexedData>();
+	QJsonSerializer::registerListConverters<IndexedData>();
 	Setup::setCleanupTimeout(10000);
 #ifdef VERBOSE_TESTS
 	QLoggingCategory::setFilterRules(QStringLiteral("qtdatasync.*.debug=true"));
@@ -5,8 +5,18 @@
 #include <testlib.h>
 #include <QtDataSync/private/localstore_p.h>
 #include <QtDataSync/private/defaults_p.h>
+#include <QtDataSync/private/sharedcache_p.h>
+#include <QtDataSync/private/emitteradapter_p.h>
 using namespace QtDataSync;
 
+class CompressedData
+{
+	Q_GADGET
+	Q_CLASSINFO("qtdatasync_compression", "9")
+};
+
+Q_DECLARE_METATYPE(CompressedData)
+
 class TestLocalStore : public QObject
 {
 	Q_OBJECT
@@ -23,6 +33,7 @@ private Q_SLOTS:
 	void testContains();
 	void testFind_data();
 	void testFind();
+	void testFindPaged();
 	void testRemove_data();
 	void testRemove();
 	void testClear();
@@ -39,7 +50,17 @@ private Q_SLOTS:
 	//special
 	void testChangeSignals();
 	void testAsync();
+	void testParallelLoad();
+	void testCursor();
+	void testContentIndex();
 	void testPassiveSetup();
+	void testInlineStorage();
+	void testCompression();
+	void testExistenceCache();
+	void testCacheWarmup();
+	void testCacheStatistics();
+	void testSharedCache();
+	void testReadLatency();
 
 private:
 	LocalStore *store;
@@ -150,12 +171,37 @@ void TestLocalStore::testFind_data()
 								  TestLib::generateDataJson(430),
 								  TestLib::generateDataJson(432)
 							   };
+	QTest::newRow("regexpAnchored") << QStringLiteral(R"__(^43\d)__")
+									<< DataStore::RegexpMode
+									<< QList<QJsonObject> {
+										  TestLib::generateDataJson(430),
+										  TestLib::generateDataJson(431),
+										  TestLib::generateDataJson(432)
+									   };
+	QTest::newRow("regexpOptional") << QStringLiteral("^42?9")
+									<< DataStore::RegexpMode
+									<< QList<QJsonObject> {
+										  TestLib::generateDataJson(429)
+									   };
+	QTest::newRow("regexpAlternative") << QStringLiteral("^430|1$")
+									   << DataStore::RegexpMode
+									   << QList<QJsonObject> {
+											 TestLib::generateDataJson(430),
+											 TestLib::generateDataJson(431)
+										  };
 	QTest::newRow("wildcard") << QStringLiteral("*2*")
 							  << DataStore::WildcardMode
 							  << QList<QJsonObject> {
 									TestLib::generateDataJson(429),
 									TestLib::generateDataJson(432)
 								 };
+	QTest::newRow("wildcardPrefix") << QStringLiteral("43?")
+									<< DataStore::WildcardMode
+									<< QList<QJsonObject> {
+										  TestLib::generateDataJson(430),
+										  TestLib::generateDataJson(431),
+										  TestLib::generateDataJson(432)
+									   };
 	QTest::newRow("startswith") << QStringLiteral("4")
 								<< DataStore::StartsWithMode
 								<< QList<QJsonObject> {
@@ -190,6 +236,29 @@ void TestLocalStore::testFind()
 	}
 }
 
+void TestLocalStore::testFindPaged()
+{
+	try {
+		//pages are sorted by key
+		QCOMPARE(store->find(TestLib::TypeName, QStringLiteral("4"), DataStore::StartsWithMode, 0, 2),
+				 (QList<QJsonObject> {
+					  TestLib::generateDataJson(429),
+					  TestLib::generateDataJson(430)
+				  }));
+		QCOMPARE(store->find(TestLib::TypeName, QStringLiteral("4"), DataStore::StartsWithMode, 2, 2),
+				 (QList<QJsonObject> {
+					  TestLib::generateDataJson(431),
+					  TestLib::generateDataJson(432)
+				  }));
+		QVERIFY(store->find(TestLib::TypeName, QStringLiteral("4"), DataStore::StartsWithMode, 4, 2).isEmpty());
+		//residual filters are applied before paging
+		QCOMPARE(store->find(TestLib::TypeName, QStringLiteral("^4.[12]"), DataStore::RegexpMode, 1, 5),
+				 QList<QJsonObject>{TestLib::generateDataJson(432)});
+	} catch(QException &e) {
+		QFAIL(e.what());
+	}
+}
+
 void TestLocalStore::testRemove_data()
 {
 	QTest::addColumn<ObjectKey>("key");
@@ -371,6 +440,31 @@ void TestLocalStore::testDeviceChanges()
 			return true;
 		});
 
+		//page through local and device changes with a cursor
+		store->save(TestLib::generateKey(44), TestLib::generateDataJson(44));
+		QCOMPARE(store->changeCount(), 3u);
+		LocalStore::ChangeCursor cursor;
+		QList<QPair<ObjectKey, QUuid>> visited;
+		auto passes = 0;
+		while(!cursor.done) {
+			QVERIFY(passes++ < 10);
+			store->loadChanges(1, cursor, [&](ObjectKey k, quint64, QString, QUuid d) {
+				visited.append({k, d});
+				return true;
+			});
+		}
+		QCOMPARE(visited.size(), 3);
+		QCOMPARE(visited[0], qMakePair(TestLib::generateKey(44), QUuid()));
+		QCOMPARE(visited[1], qMakePair(TestLib::generateKey(42), devId));
+		QCOMPARE(visited[2], qMakePair(TestLib::generateKey(43), devId));
+		//a finished cursor does not visit anything anymore
+		store->loadChanges(10, cursor, [&](ObjectKey, quint64, QString, QUuid) {
+			[](){ QFAIL("Visited a change with a finished cursor"); }();
+			return true;
+		});
+		store->markUnchanged(TestLib::generateKey(44), 1, false);
+		QCOMPARE(store->changeCount(), 2u);
+
 		store->removeDeviceChange(TestLib::generateKey(42), QUuid::createUuid());
 		QCOMPARE(store->changeCount(), 2u);
 		store->removeDeviceChange(TestLib::generateKey(42), devId);
@@ -659,6 +753,155 @@ void TestLocalStore::testAsync()
 	}
 }
 
+void TestLocalStore::testParallelLoad()
+{
+	try {
+		store->reset(false);
+
+		//enough datasets to be decoded in parallel
+		auto data = TestLib::generateDataJson(1000, 1299);
+		QList<QPair<QString, QJsonObject>> saveList;
+		for(auto it = data.constBegin(); it != data.constEnd(); it++)
+			saveList.append({it.key().id, it.value()});
+		store->saveAll(TestLib::TypeName, saveList);
+
+		//results must be in the order of the index
+		auto keys = store->keys(TestLib::TypeName);
+		auto allData = store->loadAll(TestLib::TypeName);
+		QCOMPARE(allData.size(), keys.size());
+		for(auto i = 0; i < keys.size(); i++)
+			QCOMPARE(allData[i], data.value(TestLib::generateKey(keys[i].toInt())));
+
+		auto found = store->find(TestLib::TypeName, QStringLiteral("11"), DataStore::StartsWithMode);
+		QCOMPARE(found.size(), 100);
+		for(const auto &json : found)
+			QVERIFY(json[QStringLiteral("id")].toInt() / 100 == 11);
+
+		store->reset(false);
+	} catch(QException &e) {
+		QFAIL(e.what());
+	}
+}
+
+void TestLocalStore::testCursor()
+{
+	try {
+		store->reset(false);
+
+		//more datasets than fit into one page
+		auto data = TestLib::generateDataJson(1000, 1249);
+		QList<QPair<QString, QJsonObject>> saveList;
+		for(auto it = data.constBegin(); it != data.constEnd(); it++)
+			saveList.append({it.key().id, it.value()});
+		store->saveAll(TestLib::TypeName, saveList);
+
+		//full iteration, sorted by key
+		auto cursor = store->iterate(TestLib::TypeName);
+		QStringList keys;
+		while(cursor.next()) {
+			QCOMPARE(cursor.load(), data.value(cursor.key()));
+			keys.append(cursor.key().id);
+		}
+		QCOMPARE(keys.size(), data.size());
+		auto sortedKeys = keys;
+		std::sort(sortedKeys.begin(), sortedKeys.end());
+		QCOMPARE(keys, sortedKeys);
+		QVERIFY(!cursor.next());
+
+		//modify while iterating
+		auto modCursor = store->iterate(TestLib::TypeName);
+		auto count = 0;
+		while(modCursor.next()) {
+			if(count == 0)
+				QVERIFY(store->remove(TestLib::generateKey(1120)));
+			QVERIFY(modCursor.key() != TestLib::generateKey(1120));
+			if(++count == 150)
+				break;
+		}
+		QCOMPARE(count, 150);
+		QCOMPARE(store->count(TestLib::TypeName), 249ull);
+
+		store->reset(false);
+	} catch(QException &e) {
+		QFAIL(e.what());
+	}
+}
+
+void TestLocalStore::testContentIndex()
+{
+	const QByteArray typeName{"IndexedData"};
+	auto indexedKey = [&](int index) {
+		return ObjectKey{typeName, QString::number(index)};
+	};
+
+	try {
+		store->reset(false);
+
+		store->save(indexedKey(1), TestLib::generateDataJson(1, QStringLiteral("the quick brown fox")));
+		store->save(indexedKey(2), TestLib::generateDataJson(2, QStringLiteral("a lazy dog")));
+		store->save(indexedKey(3), TestLib::generateDataJson(3, QStringLiteral("quick quick dog")));
+
+		//ranked: more hits first
+		QCOMPARE(store->searchText(typeName, QStringLiteral("quick"), -1),
+				 (QStringList{TestLib::generateDataKey(3), TestLib::generateDataKey(1)}));
+		QCOMPAREUNORDERED(store->searchText(typeName, QStringLiteral("dog"), -1),
+						  TestLib::generateDataKeys(2, 3));
+		QCOMPARE(store->searchText(typeName, QStringLiteral("dog NOT lazy"), -1),
+				 QStringList{TestLib::generateDataKey(3)});
+		QCOMPARE(store->searchText(typeName, QStringLiteral("quick"), 1).size(), 1);
+
+		//follows updates and removals
+		store->save(indexedKey(3), TestLib::generateDataJson(3, QStringLiteral("sleepy cat")));
+		QCOMPARE(store->searchText(typeName, QStringLiteral("quick"), -1),
+				 QStringList{TestLib::generateDataKey(1)});
+		QVERIFY(store->remove(indexedKey(1)));
+		QVERIFY(store->searchText(typeName, QStringLiteral("quick"), -1).isEmpty());
+
+		//types without declared properties cannot be searched
+		QVERIFY_EXCEPTION_THROWN(store->searchText(TestLib::TypeName, QStringLiteral("dog"), -1), LocalStoreException);
+
+		//reset must not leave stale entries behind
+		store->reset(false);
+		QVERIFY(store->searchText(typeName, QStringLiteral("dog"), -1).isEmpty());
+		store->save(indexedKey(4), TestLib::generateDataJson(4, QStringLiteral("another dog")));
+		QCOMPARE(store->searchText(typeName, QStringLiteral("dog"), -1),
+				 QStringList{TestLib::generateDataKey(4)});
+
+		//simulate data stored before the index was declared
+		{
+			auto name = QStringLiteral("index_upgrade");
+			auto db = QSqlDatabase::addDatabase(QStringLiteral("QSQLITE"), name);
+			db.setDatabaseName(QDir{TestLib::tDir.path()}.absoluteFilePath(QStringLiteral("store.db")));
+			QVERIFY2(db.open(), qUtf8Printable(db.lastError().text()));
+			for(const auto &statement : {
+					QStringLiteral("DELETE FROM ContentIndex WHERE rowid IN (SELECT RowId FROM ContentKeys WHERE Type = ?)"),
+					QStringLiteral("DELETE FROM ContentKeys WHERE Type = ?"),
+					QStringLiteral("DELETE FROM IndexInfo WHERE Type = ?")
+				}) {
+				QSqlQuery dropQuery{db};
+				dropQuery.prepare(statement);
+				dropQuery.addBindValue(typeName);
+				QVERIFY2(dropQuery.exec(), qUtf8Printable(dropQuery.lastError().text()));
+			}
+			db.close();
+		}
+		QSqlDatabase::removeDatabase(QStringLiteral("index_upgrade"));
+
+		//queries do not build the index, preparing it at startup does
+		{
+			LocalStore indexStore(DefaultsPrivate::obtainDefaults(DefaultSetup));
+			QVERIFY(indexStore.searchText(typeName, QStringLiteral("dog"), -1).isEmpty());
+			indexStore.prepareIndexes();
+			QCOMPARE(indexStore.searchText(typeName, QStringLiteral("dog"), -1),
+					 QStringList{TestLib::generateDataKey(4)});
+		}
+
+		store->reset(false);
+	} catch(QException &e) {
+		QFAIL(e.what());
+	}
+}
+
 void TestLocalStore::testPassiveSetup()
 {
 	const auto key = TestLib::generateKey(77);
@@ -721,6 +964,514 @@ void TestLocalStore::testPassiveSetup()
 	}
 }
 
+void TestLocalStore::testInlineStorage()
+{
+	const auto setupName = QStringLiteral("inline");
+	const auto localDir = TestLib::tDir.filePath(setupName);
+	const QDir storageDir{localDir};
+
+	try {
+		//store data as files first
+		{
+			Setup setup;
+			TestLib::setup(setup)
+					.setLocalDir(localDir)
+					.setStorageMode(Setup::StorageMode::Files);
+			setup.create(setupName);
+
+			LocalStore fileStore(DefaultsPrivate::obtainDefaults(setupName));
+			fileStore.save(TestLib::generateKey(50), TestLib::generateDataJson(50));
+			fileStore.save(TestLib::generateKey(51), TestLib::generateDataJson(51));
+		}
+		Setup::removeSetup(setupName, true);
+		QVERIFY(storageDir.exists(QStringLiteral("store")));
+		//a file that is not part of the index must survive the migration
+		{
+			QFile unknownFile{storageDir.absoluteFilePath(QStringLiteral("store/unknown.dat"))};
+			QVERIFY(unknownFile.open(QIODevice::WriteOnly));
+			unknownFile.write("keep me");
+		}
+
+		//restart in inline mode -> migrates all files into the database
+		Setup setup;
+		TestLib::setup(setup)
+				.setLocalDir(localDir)
+				.setStorageMode(Setup::StorageMode::Inline);
+		setup.create(setupName);
+		QTRY_VERIFY(QDir{storageDir.absoluteFilePath(QStringLiteral("store"))}.entryList(QDir::Dirs | QDir::NoDotAndDotDot).isEmpty());
+		QVERIFY(storageDir.exists(QStringLiteral("store/unknown.dat")));
+
+		LocalStore inlineStore(DefaultsPrivate::obtainDefaults(setupName));
+		QCOMPARE(inlineStore.load(TestLib::generateKey(50)), TestLib::generateDataJson(50));
+		QCOMPAREUNORDERED(inlineStore.loadAll(TestLib::TypeName), TestLib::generateDataJson(50, 51).values());
+
+		//new data is stored inline as well
+		inlineStore.save(TestLib::generateKey(52), TestLib::generateDataJson(52));
+		QVERIFY(QDir{storageDir.absoluteFilePath(QStringLiteral("store"))}.entryList(QDir::Dirs | QDir::NoDotAndDotDot).isEmpty());
+		QCOMPARE(inlineStore.count(TestLib::TypeName), 3ull);
+		QCOMPAREUNORDERED(inlineStore.find(TestLib::TypeName, QStringLiteral("5"), DataStore::StartsWithMode),
+						  TestLib::generateDataJson(50, 52).values());
+
+		//remove and compact
+		QVERIFY(inlineStore.remove(TestLib::generateKey(50)));
+		QVERIFY_EXCEPTION_THROWN(inlineStore.load(TestLib::generateKey(50)), NoDataException);
+		//normally done by the engine in the background - only needed once
+		inlineStore.enableIncrementalVacuum();
+		QVERIFY(!inlineStore.enableIncrementalVacuum());
+		inlineStore.compactStorage(100);
+		QCOMPARE(inlineStore.count(TestLib::TypeName), 2ull);
+	} catch(QException &e) {
+		QFAIL(e.what());
+	}
+
+	Setup::removeSetup(setupName, true);
+}
+
+void TestLocalStore::testCompression()
+{
+	const auto setupName = QStringLiteral("compressed");
+	const auto localDir = TestLib::tDir.filePath(setupName);
+	const ObjectKey key{QMetaType::typeName(qMetaTypeId<CompressedData>()), QStringLiteral("log")};
+
+	QJsonObject data;
+	data[QStringLiteral("id")] = key.id;
+	QJsonArray records;
+	for(auto i = 0; i < 500; i++)
+		records.append(QStringLiteral("Record %1 - everything is still fine").arg(i % 10));
+	data[QStringLiteral("records")] = records;
+	const auto binSize = QJsonDocument(data).toBinaryData().size();
+
+	try {
+		{
+			Setup setup;
+			TestLib::setup(setup)
+					.setLocalDir(localDir)
+					.setStorageMode(Setup::StorageMode::Files);
+			setup.create(setupName);
+
+			LocalStore compressedStore(DefaultsPrivate::obtainDefaults(setupName));
+			compressedStore.save(key, data);
+			compressedStore.save(TestLib::generateKey(60), TestLib::generateDataJson(60));
+		}
+		Setup::removeSetup(setupName, true);
+
+		//the compressed file must be much smaller than the binary json
+		QDirIterator iterator(QDir{localDir}.filePath(QStringLiteral("store")), QDir::Files, QDirIterator::Subdirectories);
+		qint64 maxSize = 0;
+		auto fileCount = 0;
+		while(iterator.hasNext()) {
+			iterator.next();
+			maxSize = std::max(maxSize, iterator.fileInfo().size());
+			fileCount++;
+		}
+		QCOMPARE(fileCount, 2);
+		QVERIFY2(maxSize * 3 < binSize, qUtf8Printable(QStringLiteral("%1 compressed vs %2 uncompressed bytes").arg(maxSize).arg(binSize)));
+
+		//restart with an empty cache -> data is read from disk
+		Setup setup;
+		TestLib::setup(setup).setLocalDir(localDir);
+		setup.create(setupName);
+		LocalStore compressedStore(DefaultsPrivate::obtainDefaults(setupName));
+		QCOMPARE(compressedStore.load(key), data);
+		QCOMPARE(compressedStore.loadAll(key.typeName), QList<QJsonObject>{data});
+		QCOMPARE(compressedStore.load(TestLib::generateKey(60)), TestLib::generateDataJson(60));
+	} catch(QException &e) {
+		QFAIL(e.what());
+	}
+
+	Setup::removeSetup(setupName, true);
+}
+
+void TestLocalStore::testExistenceCache()
+{
+	const auto setupName = QStringLiteral("existence");
+	const auto key = TestLib::generateKey(70);
+
+	try {
+		Setup setup;
+		TestLib::setup(setup).setLocalDir(TestLib::tDir.filePath(setupName));
+		setup.create(setupName);
+		{
+			LocalStore firstStore(DefaultsPrivate::obtainDefaults(setupName));
+			LocalStore secondStore(DefaultsPrivate::obtainDefaults(setupName));
+
+			//misses are remembered, both for contains and load
+			QVERIFY(!firstStore.contains(key));
+			QVERIFY_EXCEPTION_THROWN(firstStore.load(key), NoDataException);
+			QVERIFY(!firstStore.contains(key));
+
+			//a save from another store of the setup replaces the cached miss
+			secondStore.save(key, TestLib::generateDataJson(70));
+			QVERIFY(firstStore.contains(key));
+			QCOMPARE(firstStore.load(key), TestLib::generateDataJson(70));
+
+			//removed datasets do not exist anymore, even though their deletion still has to be synced
+			QVERIFY(secondStore.remove(key));
+			QVERIFY(!firstStore.contains(key));
+			QVERIFY_EXCEPTION_THROWN(firstStore.load(key), NoDataException);
+			firstStore.reset(true); //drops the cache
+			QVERIFY(!firstStore.contains(key));
+
+			//clearing marks all keys as missing
+			firstStore.save(key, TestLib::generateDataJson(70));
+			QVERIFY(secondStore.contains(key));
+			firstStore.clear(key.typeName);
+			QVERIFY(!secondStore.contains(key));
+			QVERIFY_EXCEPTION_THROWN(secondStore.load(key), NoDataException);
+		}
+		Setup::removeSetup(setupName, true);
+
+		//misses found while a save was running must not hide the saved data. The cache is small, so the
+		//saved data gets evicted again and only the existence cache answers
+		const auto raceName = QStringLiteral("existenceRace");
+		Setup raceSetup;
+		TestLib::setup(raceSetup)
+				.setLocalDir(TestLib::tDir.filePath(raceName))
+				.setCacheSize(4096);
+		raceSetup.create(raceName);
+		{
+			LocalStore writeStore(DefaultsPrivate::obtainDefaults(raceName));
+			for(auto i = 0; i < 20; i++) {
+				const auto raceKey = TestLib::generateKey(100 + i);
+				QAtomicInt started;
+				auto reader = QtConcurrent::run([&](){
+					LocalStore readStore(DefaultsPrivate::obtainDefaults(raceName));
+					started = 1;
+					for(auto j = 0; j < 100; j++)
+						readStore.contains(raceKey);
+				});
+				while(started == 0)
+					QThread::yieldCurrentThread();
+				writeStore.save(raceKey, TestLib::generateDataJson(100 + i));
+				reader.waitForFinished();
+
+				QList<QPair<QString, QJsonObject>> fillData;
+				for(auto j = 0; j < 40; j++)
+					fillData.append({QStringLiteral("fill_%1").arg(j), TestLib::generateDataJson(j)});
+				writeStore.saveAll(TestLib::TypeName, fillData);
+				QVERIFY(writeStore.contains(raceKey));
+			}
+		}
+		Setup::removeSetup(raceName, true);
+	} catch(QException &e) {
+		QFAIL(e.what());
+	}
+}
+
+void TestLocalStore::testCacheWarmup()
+{
+	const auto setupName = QStringLiteral("warmup");
+	const auto localDir = TestLib::tDir.filePath(setupName);
+
+	try {
+		{
+			Setup setup;
+			TestLib::setup(setup).setLocalDir(localDir);
+			setup.create(setupName);
+
+			LocalStore warmupStore(DefaultsPrivate::obtainDefaults(setupName));
+			for(auto i = 80; i < 85; i++)
+				warmupStore.save(TestLib::generateKey(i), TestLib::generateDataJson(i));
+			warmupStore.recordWarmupKeys(10);
+			//datasets removed after recording are skipped
+			QVERIFY(warmupStore.remove(TestLib::generateKey(80)));
+			QVERIFY(warmupStore.remove(TestLib::generateKey(81)));
+		}
+		Setup::removeSetup(setupName, true);
+
+		//simulate a store created before warm-ups existed
+		{
+			auto name = QStringLiteral("warmup_upgrade");
+			auto db = QSqlDatabase::addDatabase(QStringLiteral("QSQLITE"), name);
+			db.setDatabaseName(QDir{localDir}.absoluteFilePath(QStringLiteral("store.db")));
+			QVERIFY2(db.open(), qUtf8Printable(db.lastError().text()));
+			QSqlQuery keysQuery{db};
+			QVERIFY2(keysQuery.exec(QStringLiteral("SELECT Id FROM CacheWarmup")), qUtf8Printable(keysQuery.lastError().text()));
+			QStringList recordedIds;
+			while(keysQuery.next())
+				recordedIds.append(keysQuery.value(0).toString());
+			QCOMPAREUNORDERED(recordedIds, (QStringList {
+									   TestLib::generateKey(80).id,
+									   TestLib::generateKey(81).id,
+									   TestLib::generateKey(82).id,
+									   TestLib::generateKey(83).id,
+									   TestLib::generateKey(84).id
+								   }));
+			keysQuery.finish();
+
+			QSqlQuery dropQuery{db};
+			QVERIFY2(dropQuery.exec(QStringLiteral("DROP TABLE CacheWarmup")), qUtf8Printable(dropQuery.lastError().text()));
+			dropQuery.finish();
+			db.close();
+		}
+		QSqlDatabase::removeDatabase(QStringLiteral("warmup_upgrade"));
+
+		//restart with an empty cache -> the table is recreated, but nothing is recorded yet
+		{
+			Setup setup;
+			TestLib::setup(setup).setLocalDir(localDir);
+			setup.create(setupName);
+			LocalStore warmupStore(DefaultsPrivate::obtainDefaults(setupName));
+			QCOMPARE(warmupStore.warmupCache(), 0);
+			for(auto i = 82; i < 85; i++)
+				warmupStore.load(TestLib::generateKey(i));
+			warmupStore.recordWarmupKeys(10);
+		}
+		Setup::removeSetup(setupName, true);
+
+		//restart again -> exactly the recorded keys that still exist are preloaded
+		Setup setup;
+		TestLib::setup(setup).setLocalDir(localDir);
+		setup.create(setupName);
+		LocalStore warmupStore(DefaultsPrivate::obtainDefaults(setupName));
+		QCOMPARE(warmupStore.warmupCache(), 3);
+		auto statistics = Setup::cacheStatistics(setupName);
+		QCOMPARE(statistics.entries, 3);
+		for(auto i = 82; i < 85; i++)
+			warmupStore.load(TestLib::generateKey(i));
+		QCOMPARE(Setup::cacheStatistics(setupName).hits, statistics.hits + 3ull);
+		QCOMPARE(Setup::cacheStatistics(setupName).entries, 3);
+
+		//a reset forgets the recorded keys
+		warmupStore.reset(false);
+		QCOMPARE(warmupStore.warmupCache(), 0);
+		Setup::removeSetup(setupName, true);
+	} catch(QException &e) {
+		QFAIL(e.what());
+	}
+}
+
+void TestLocalStore::testCacheStatistics()
+{
+	const auto setupName = QStringLiteral("statistics");
+
+	try {
+		Setup setup;
+		TestLib::setup(setup)
+				.setLocalDir(TestLib::tDir.filePath(setupName))
+				.setCacheSize(MB(8))
+				.setMinimumCacheSize(MB(1));
+		setup.create(setupName);
+		{
+			LocalStore statisticsStore(DefaultsPrivate::obtainDefaults(setupName));
+			for(auto i = 90; i < 95; i++)
+				statisticsStore.save(TestLib::generateKey(i), TestLib::generateDataJson(i));
+			statisticsStore.load(TestLib::generateKey(90));
+			statisticsStore.load(TestLib::generateKey(91));
+			QVERIFY_EXCEPTION_THROWN(statisticsStore.load(TestLib::generateKey(99)), NoDataException);
+
+			auto statistics = Setup::cacheStatistics(setupName);
+			QCOMPARE(statistics.hits, 2ull);
+			QCOMPARE(statistics.misses, 1ull);
+			QCOMPARE(statistics.entries, 5);
+			QVERIFY(statistics.bytes > 0);
+			QCOMPARE(statistics.maxBytes, static_cast<qint64>(MB(8)));
+			QCOMPARE(statistics.types.size(), 1);
+			QCOMPARE(statistics.types.value(TestLib::TypeName).entries, 5);
+			QCOMPARE(statistics.types.value(TestLib::TypeName).bytes, statistics.bytes);
+			QCOMPARE(statistics.hitRatio(), 2.0 / 3.0);
+
+			//iterating is served from the cache as well
+			auto cursor = statisticsStore.iterate(TestLib::TypeName);
+			while(cursor.next())
+				QCOMPARE(cursor.load(), TestLib::generateDataJson(cursor.key().id.toInt()));
+			QCOMPARE(Setup::cacheStatistics(setupName).hits, 7ull);
+
+			//memory pressure shrinks the cache, but not below the minimum
+			Setup::reportMemoryPressure();
+			QCOMPARE(Setup::cacheStatistics(setupName).maxBytes, static_cast<qint64>(MB(4)));
+			Setup::reportMemoryPressure(true);
+			QCOMPARE(Setup::cacheStatistics(setupName).maxBytes, static_cast<qint64>(MB(1)));
+			QCOMPARE(statisticsStore.load(TestLib::generateKey(92)), TestLib::generateDataJson(92));
+		}
+		Setup::removeSetup(setupName, true);
+	} catch(QException &e) {
+		QFAIL(e.what());
+	}
+}
+
+void TestLocalStore::testSharedCache()
+{
+	const auto setupName = QStringLiteral("shared");
+	const auto passiveName = QStringLiteral("shared_passive");
+	const auto localDir = TestLib::tDir.filePath(setupName);
+	const auto key = TestLib::generateKey(42);
+	auto data = TestLib::generateDataJson(42);
+	const auto checksum = QByteArrayLiteral("checksum");
+	//only the data files are removed, so anything loaded afterwards must come from memory
+	const auto removeDataFiles = [&]() {
+		QDirIterator iterator{localDir, {QStringLiteral("*.dat")}, QDir::Files, QDirIterator::Subdirectories};
+		while(iterator.hasNext())
+			QVERIFY(QFile::remove(iterator.next()));
+	};
+
+	//the segment itself
+	{
+		QString error;
+		const auto segmentKey = SharedCache::segmentKey(QDir{TestLib::tDir.filePath(QStringLiteral("segment"))});
+		QScopedPointer<SharedCache> writer{SharedCache::create(segmentKey, 64 * 1024, error)};
+		QVERIFY2(writer, qUtf8Printable(error));
+		QScopedPointer<SharedCache> reader{SharedCache::attach(segmentKey, error)};
+		QVERIFY2(reader, qUtf8Printable(error));
+		QVERIFY(writer->isWritable());
+		QVERIFY(!reader->isWritable());
+		QCOMPARE(reader->slotCount(), writer->slotCount());
+
+		QByteArray result;
+		QVERIFY(!reader->lookup(key, 1, checksum, result));
+		QVERIFY(writer->insert(key, 1, checksum, QByteArrayLiteral("data")));
+		QVERIFY(reader->lookup(key, 1, checksum, result));
+		QCOMPARE(result, QByteArrayLiteral("data"));
+		//other versions or checksums never match
+		QVERIFY(!reader->lookup(key, 2, checksum, result));
+		QVERIFY(!reader->lookup(key, 1, QByteArrayLiteral("other"), result));
+		QVERIFY(!reader->insert(key, 2, checksum, QByteArrayLiteral("data")));
+		//too large data is not stored and does not touch the slot
+		QVERIFY(!writer->insert(key, 2, checksum, QByteArray(SharedCache::SlotSize, 'x')));
+		QVERIFY(reader->lookup(key, 1, checksum, result));
+	}
+
+	//a primary crashing while writing a slot
+	{
+		QString error;
+		const auto segmentKey = SharedCache::segmentKey(QDir{TestLib::tDir.filePath(QStringLiteral("crashed"))});
+		QScopedPointer<SharedCache> writer{SharedCache::create(segmentKey, SharedCache::HeaderSize + SharedCache::SlotSize, error)};
+		QVERIFY2(writer, qUtf8Printable(error));
+		QCOMPARE(writer->slotCount(), 1);
+		QVERIFY(writer->insert(key, 1, checksum, QByteArrayLiteral("data")));
+
+		//keeps the segment alive and leaves the only slot locked, with a torn version
+		QSharedMemory memory{segmentKey};
+		QVERIFY2(memory.attach(), qUtf8Printable(memory.errorString()));
+		auto slot = static_cast<char*>(memory.data()) + SharedCache::HeaderSize;
+		reinterpret_cast<QAtomicInteger<quint32>*>(slot)->fetchAndAddOrdered(1);
+		writer.reset();
+
+		//the next primary reuses the segment and releases the slot, without serving its content
+		writer.reset(SharedCache::create(segmentKey, SharedCache::HeaderSize + SharedCache::SlotSize, error));
+		QVERIFY2(writer, qUtf8Printable(error));
+		QScopedPointer<SharedCache> reader{SharedCache::attach(segmentKey, error)};
+		QVERIFY2(reader, qUtf8Printable(error));
+		QByteArray result;
+		QVERIFY(!reader->lookup(key, 1, checksum, result));
+		QVERIFY(writer->insert(key, 2, checksum, QByteArrayLiteral("data2")));
+		QVERIFY(reader->lookup(key, 2, checksum, result));
+		QCOMPARE(result, QByteArrayLiteral("data2"));
+	}
+
+	//passive setups started before the primary attach later, but not on every lookup
+	{
+		QString error;
+		EmitterAdapter::CacheInfo cacheInfo{MB(1)};
+		cacheInfo.sharedKey = SharedCache::segmentKey(QDir{TestLib::tDir.filePath(QStringLiteral("late"))});
+		QVERIFY(!cacheInfo.sharedCache());
+		QScopedPointer<SharedCache> writer{SharedCache::create(cacheInfo.sharedKey, 64 * 1024, error)};
+		QVERIFY2(writer, qUtf8Printable(error));
+		QVERIFY(!cacheInfo.sharedCache());
+		cacheInfo.lastSharedAttach.store(QDateTime::currentMSecsSinceEpoch() - EmitterAdapter::CacheInfo::SharedAttachInterval);
+		QVERIFY(cacheInfo.sharedCache());
+		QVERIFY(!cacheInfo.sharedCache()->isWritable());
+	}
+
+	try {
+		Setup setup;
+		TestLib::setup(setup)
+				.setLocalDir(localDir)
+				.setSharedCacheSize(MB(1));
+		setup.create(setupName);
+		Setup passiveSetup;
+		TestLib::setup(passiveSetup)
+				.setLocalDir(localDir)
+				.setSharedCacheSize(MB(1))
+				.setRemoteObjectHost(QStringLiteral("threaded:/qtdatasync/%1/enginenode").arg(setupName));
+		QVERIFY(passiveSetup.createPassive(passiveName, 5000));
+
+		{
+			LocalStore primary(DefaultsPrivate::obtainDefaults(setupName));
+			LocalStore passive(DefaultsPrivate::obtainDefaults(passiveName));
+			QSignalSpy passiveSpy(&passive, &LocalStore::dataChanged);
+
+			primary.save(key, data);
+			removeDataFiles();
+			QCOMPARE(passive.load(key), data);
+			QVERIFY(passiveSpy.wait());
+
+			//a new version replaces the old one, the passive setup never sees the old data again
+			data.insert(QStringLiteral("baum"), 42);
+			primary.save(key, data);
+			removeDataFiles();
+			QVERIFY(passiveSpy.wait());
+			QCOMPARE(passive.load(key), data);
+
+			//passive setups only read the shared cache, their changes are loaded from disk
+			const auto otherKey = TestLib::generateKey(43);
+			passive.save(otherKey, TestLib::generateDataJson(43));
+			QCOMPARE(primary.load(otherKey), TestLib::generateDataJson(43));
+		}
+
+		Setup::removeSetup(passiveName);
+		Setup::removeSetup(setupName, true);
+	} catch(QException &e) {
+		QFAIL(e.what());
+	}
+}
+
+void TestLocalStore::testReadLatency()
+{
+	const auto setupName = QStringLiteral("latency");
+	const auto changeCount = 10000;
+	const auto readCount = 500;
+
+	try {
+		//without a cache, every load has to read and deserialize from the database
+		Setup setup;
+		TestLib::setup(setup)
+				.setLocalDir(TestLib::tDir.filePath(setupName))
+				.setCacheSize(0);
+		setup.create(setupName);
+		{
+			LocalStore readStore(DefaultsPrivate::obtainDefaults(setupName));
+			for(auto i = 0; i < readCount; i++)
+				readStore.save(TestLib::generateKey(i), TestLib::generateDataJson(i));
+
+			//apply a large "download" the same way the sync controller does
+			QAtomicInt written = 0;
+			auto writer = QtConcurrent::run([changeCount, readCount, setupName, &written](){
+				LocalStore wStore(DefaultsPrivate::obtainDefaults(setupName));//thread without eventloop!
+				for(auto i = readCount; i < readCount + changeCount; i++) {
+					auto key = TestLib::generateKey(i);
+					auto scope = wStore.startSync(key);
+					wStore.storeChanged(scope, 1ull, QString(), TestLib::generateDataJson(i), false, LocalStore::NoExists);
+					wStore.commitSync(scope);
+					written.fetchAndAddOrdered(1);
+				}
+			});
+
+			//load distinct keys while the download is running, and remember how far the writer was
+			QList<int> progress;
+			for(auto i = 0; !writer.isFinished(); i = (i + 1) % readCount) {
+				QCOMPARE(readStore.load(TestLib::generateKey(i)), TestLib::generateDataJson(i));
+				progress.append(written.load());
+			}
+			writer.waitForFinished();
+
+			qInfo() << "Performed" << progress.size() << "uncached loads while applying" << changeCount << "changes";
+			//reads must not wait for the whole download: they complete all along the way
+			QVERIFY(!progress.isEmpty());
+			QVERIFY2(progress.first() < changeCount / 2,
+					 qUtf8Printable(QStringLiteral("First load completed after %1 of %2 writes").arg(progress.first()).arg(changeCount)));
+			auto readsInSecondHalf = std::count_if(progress.begin(), progress.end(), [changeCount](int p) {
+				return p >= changeCount / 2 && p < changeCount;
+			});
+			QVERIFY(readsInSecondHalf > 0);
+			QCOMPARE(readStore.count(TestLib::TypeName), static_cast<quint64>(changeCount + readCount));
+		}
+		Setup::removeSetup(setupName, true);
+	} catch(QException &e) {
+		QFAIL(e.what());
+	}
+}
+
 QTEST_MAIN(TestLocalStore)
 
 #include "tst_localstore.moc"
@@ -7,6 +7,7 @@
 #include <QtDataSync/private/accountmessage_p.h>
 #include <QtDataSync/private/changedmessage_p.h>
 #include <QtDataSync/private/changemessage_p.h>
+#include <QtDataSync/private/changebatchmessage_p.h>
 #include <QtDataSync/private/devicechangemessage_p.h>
 #include <QtDataSync/private/devicekeysmessage_p.h>
 #include <QtDataSync/private/devicesmessage_p.h>
@@ -55,6 +56,8 @@ void TestMessages::initTestCase()
 {
 	qRegisterMetaType<QtDataSync::Message*>();
 	QMetaType::registerComparators<Utf8String>();
+	QMetaType::registerComparators<ChangeBatchMessage::Change>();
+	QMetaType::registerComparators<QList<ChangeBatchMessage::Change>>();
 	QMetaType::registerComparators<DevicesMessage::DeviceInfo>();
 	QMetaType::registerComparators<QList<DevicesMessage::DeviceInfo>>();
 	QMetaType::registerComparators<DeviceKeysMessage::DeviceKey>();
@@ -296,6 +299,20 @@ void TestMessages::addAllData()
 		msg.data = "encrypted_data";
 		return ChangeAckMessage(msg);
 	});
+	addData<ChangeBatchMessage>([&]() {
+		ChangeBatchMessage msg;
+		msg.changes.append(std::make_tuple(QByteArray("id_hash"), 42u, QByteArray("random_salt"), QByteArray("encrypted_data")));
+		msg.changes.append(std::make_tuple(QByteArray("id_hash2"), 43u, QByteArray("random_salt2"), QByteArray("encrypted_data2")));
+		return msg;
+	});
+	addData<ChangeBatchMessage>([&]() {
+		return ChangeBatchMessage();
+	}, false);
+	addData<ChangeBatchAckMessage>([&]() {
+		ChangeBatchMessage msg;
+		msg.changes.append(std::make_tuple(QByteArray("id_hash"), 42u, QByteArray("random_salt"), QByteArray("encrypted_data")));
+		return ChangeBatchAckMessage(msg);
+	});
 
 	addData<SyncMessage>([&]() {
 		return SyncMessage();
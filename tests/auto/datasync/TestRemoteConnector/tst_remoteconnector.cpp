@@ -38,11 +38,12 @@ private Q_SLOTS:
 	void testInvalidIdentify();
 	void testInvalidVersion();
 	void testRegistering();
-	void testLogin(bool hasChanges = false, bool withDisconnect = true);
+	void testLogin(bool hasChanges = false, bool withDisconnect = true, const QVersionNumber &serverVersion = InitMessage::CurrentVersion);
 	void testInvalidKeystoreData();
 	void testLoginWithChanges();
 
 	void testUploading();
+	void testBatchUploading();
 	void testDeviceUploading();
 	void testDownloading();
 	void testDownloadingInvalid();
@@ -268,7 +269,7 @@ void TestRemoteConnector::testRegistering()
 	}
 }
 
-void TestRemoteConnector::testLogin(bool hasChanges, bool withDisconnect)
+void TestRemoteConnector::testLogin(bool hasChanges, bool withDisconnect, const QVersionNumber &serverVersion)
 {
 	QSignalSpy errorSpy(remote, &RemoteConnector::controllerError);
 	QSignalSpy eventSpy(remote, &RemoteConnector::remoteEvent);
@@ -288,6 +289,7 @@ void TestRemoteConnector::testLogin(bool hasChanges, bool withDisconnect)
 
 		//send the identifiy message
 		auto iMsg = IdentifyMessage::createRandom(20, rng);
+		iMsg.protocolVersion = serverVersion;
 		connection->send(iMsg);
 
 		//wait for login message
@@ -346,11 +348,13 @@ void TestRemoteConnector::testLoginWithChanges()
 
 void TestRemoteConnector::testUploading()
 {
+	//servers older than 1.1 do not know batches and get one message per change
+	testLogin(false, true, QVersionNumber(1, 0));
+
 	QSignalSpy errorSpy(remote, &RemoteConnector::controllerError);
 	QSignalSpy uploadSpy(remote, &RemoteConnector::uploadDone);
 
 	try {
-		//assume already logged in
 		QVERIFY(connection);
 
 		//trigger a data change to be send
@@ -376,6 +380,55 @@ void TestRemoteConnector::testUploading()
 	} catch(std::exception &e) {
 		QFAIL(e.what());
 	}
+
+	//back to a current server for the following tests
+	testLogin();
+}
+
+void TestRemoteConnector::testBatchUploading()
+{
+	QSignalSpy errorSpy(remote, &RemoteConnector::controllerError);
+	QSignalSpy uploadSpy(remote, &RemoteConnector::uploadDone);
+
+	try {
+		//assume already logged in
+		QVERIFY(connection);
+
+		//trigger data changes to be send - the server supports batches, so they are send as one message
+		QByteArray key("special_key");
+		QByteArray data("very_secret_message_data");
+		QByteArray key2("special_key2");
+		QByteArray data2("another_secret_message_data");
+		remote->uploadData(key, data);
+		remote->uploadData(key2, data2);
+
+		//wait for reply
+		QVERIFY(connection->waitForReply<ChangeBatchMessage>([&](ChangeBatchMessage message, bool &ok) {
+			QCOMPARE(message.changes.size(), 2);
+			QCOMPARE(std::get<0>(message.changes[0]), key);
+			auto plain = remote->cryptoController()->decryptData(std::get<1>(message.changes[0]),
+																 std::get<2>(message.changes[0]),
+																 std::get<3>(message.changes[0]));
+			QCOMPARE(plain, data);
+			QCOMPARE(std::get<0>(message.changes[1]), key2);
+			plain = remote->cryptoController()->decryptData(std::get<1>(message.changes[1]),
+															std::get<2>(message.changes[1]),
+															std::get<3>(message.changes[1]));
+			QCOMPARE(plain, data2);
+			//send from here because msg copy
+			connection->send(ChangeBatchAckMessage(message));
+			ok = true;
+		}));
+
+		//wait for the acks
+		QTRY_COMPARE(uploadSpy.size(), 2);
+		QCOMPARE(uploadSpy.takeFirst()[0].toByteArray(), key);
+		QCOMPARE(uploadSpy.takeFirst()[0].toByteArray(), key2);
+
+		QVERIFY(errorSpy.isEmpty());
+	} catch(std::exception &e) {
+		QFAIL(e.what());
+	}
 }
 
 void TestRemoteConnector::testDeviceUploading()
@@ -477,6 +530,55 @@ void TestRemoteConnector::testDownloading()
 		}));
 		QCOMPARE(progIncSpy.size(), 2);
 
+		//send multiple changes at once: decrypted in parallel, but passed on in order
+		QList<QByteArray> datas;
+		for(auto i = 0; i < 10; i++) {
+			datas.append("random_dataset_multi_" + QByteArray::number(i));
+			ChangedMessage multiMsg;
+			multiMsg.dataIndex = 30 + static_cast<quint64>(i);
+			std::tie(multiMsg.keyIndex, multiMsg.salt, multiMsg.data) = remote->cryptoController()->encryptData(datas.last());
+			connection->send(multiMsg);
+		}
+		for(auto i = 0; i < 10 && downloadSpy.size() < datas.size(); i++)
+			downloadSpy.wait();
+		QCOMPARE(downloadSpy.size(), datas.size());
+		for(auto i = 0; i < datas.size(); i++) {
+			cChange = downloadSpy.takeFirst();
+			QCOMPARE(cChange[0].toULongLong(), 30ull + static_cast<quint64>(i));
+			QCOMPARE(cChange[1].toByteArray(), datas[i]);
+			remote->downloadDone(cChange[0].toULongLong());
+			QVERIFY(connection->waitForReply<ChangedAckMessage>([&](ChangedAckMessage message, bool &ok) {
+				QCOMPARE(message.dataIndex, 30ull + static_cast<quint64>(i));
+				ok = true;
+			}));
+		}
+		QCOMPARE(progIncSpy.size(), 12);
+
+		//send more changes than can be applied at once: the rest is only passed on after acks
+		const auto windowCount = RemoteConnector::MaxActiveDownloads + 2;
+		for(auto i = 0; i < windowCount; i++) {
+			ChangedMessage multiMsg;
+			multiMsg.dataIndex = 100 + static_cast<quint64>(i);
+			std::tie(multiMsg.keyIndex, multiMsg.salt, multiMsg.data) = remote->cryptoController()->encryptData("random_dataset_window_" + QByteArray::number(i));
+			connection->send(multiMsg);
+		}
+		for(auto i = 0; i < 10 && downloadSpy.size() < RemoteConnector::MaxActiveDownloads; i++)
+			downloadSpy.wait();
+		QVERIFY(!downloadSpy.wait(500));
+		QCOMPARE(downloadSpy.size(), RemoteConnector::MaxActiveDownloads);
+		for(auto i = 0; i < windowCount; i++) {
+			if(downloadSpy.isEmpty())
+				QVERIFY(downloadSpy.wait());
+			cChange = downloadSpy.takeFirst();
+			QCOMPARE(cChange[0].toULongLong(), 100ull + static_cast<quint64>(i));
+			remote->downloadDone(cChange[0].toULongLong());
+			QVERIFY(connection->waitForReply<ChangedAckMessage>([&](ChangedAckMessage message, bool &ok) {
+				QCOMPARE(message.dataIndex, 100ull + static_cast<quint64>(i));
+				ok = true;
+			}));
+		}
+		QCOMPARE(progIncSpy.size(), 12 + windowCount);
+
 		//complete downloading
 		connection->send(LastChangedMessage());
 		QVERIFY(eventSpy.wait());
@@ -580,6 +682,7 @@ void TestRemoteConnector::testErrorMessage()
 
 		//send the identifiy message
 		auto iMsg = IdentifyMessage::createRandom(20, rng);
+		iMsg.protocolVersion = serverVersion;
 		connection->send(iMsg);
 
 		//wait for login message
@@ -1548,6 +1651,8 @@ void TestRemoteConnector::testUnexpectedMessage_data()
 								  << true;
 	QTest::newRow("ChangeAckMessage") << create<ChangeAckMessage>(ChangeMessage("test"))
 									  << false;
+	QTest::newRow("ChangeBatchAckMessage") << create<ChangeBatchAckMessage>()
+										   << false;
 	QTest::newRow("DeviceChangeAckMessage") << create<DeviceChangeAckMessage>(DeviceChangeMessage("test", partnerDevId))
 											<< false;
 	QTest::newRow("ChangedMessage") << create<ChangedMessage>()
@@ -108,7 +108,14 @@ void TestSetup::testProperties()
 				.setRemoteConfiguration(RemoteConfig{QStringLiteral("wss://example.com")})
 				.setCipherScheme(Setup::TWOFISH_GCM)
 				.setCipherKeySize(24)
-				.setEventLoggingMode(Setup::EventMode::Disabled);
+				.setEventLoggingMode(Setup::EventMode::Disabled)
+				.setDatabaseSynchronous(Setup::SynchronousMode::Full)
+				.setDatabaseMmapSize(1024 * 1024)
+				.setDatabaseCacheSize(-4000)
+				.setTypedCacheSize(21000)
+				.setCacheWarmupCount(50)
+				.setMinimumCacheSize(21000)
+				.setSharedCacheSize(65536);
 
 		QCOMPARE(setup.localDir(), TestLib::tDir.path() + QLatin1Char('/') + sName);
 		QCOMPARE(setup.remoteObjectHost(), QStringLiteral("local:tst_setup"));
@@ -127,6 +134,13 @@ void TestSetup::testProperties()
 		QCOMPARE(setup.cipherScheme(), Setup::TWOFISH_GCM);
 		QCOMPARE(setup.cipherKeySize(), 24);
 		QCOMPARE(setup.eventLoggingMode(), Setup::EventMode::Disabled);
+		QCOMPARE(setup.databaseSynchronous(), Setup::SynchronousMode::Full);
+		QCOMPARE(setup.databaseMmapSize(), 1024ll * 1024ll);
+		QCOMPARE(setup.databaseCacheSize(), -4000);
+		QCOMPARE(setup.typedCacheSize(), 21000);
+		QCOMPARE(setup.cacheWarmupCount(), 50);
+		QCOMPARE(setup.minimumCacheSize(), 21000);
+		QCOMPARE(setup.sharedCacheSize(), 65536);
 
 		//test transfer to defaults
 		setup.create(sName);
@@ -154,6 +168,13 @@ void TestSetup::testProperties()
 		QCOMPARE(defaults.property(Defaults::SymScheme), QVariant::fromValue(setup.cipherScheme()));
 		QCOMPARE(defaults.property(Defaults::SymKeyParam), QVariant::fromValue(setup.cipherKeySize()));
 		QCOMPARE(defaults.property(Defaults::EventLoggingMode), QVariant::fromValue(setup.eventLoggingMode()));
+		QCOMPARE(defaults.property(Defaults::DatabaseSynchronous), QVariant::fromValue(setup.databaseSynchronous()));
+		QCOMPARE(defaults.property(Defaults::DatabaseMmapSize), QVariant::fromValue(setup.databaseMmapSize()));
+		QCOMPARE(defaults.property(Defaults::DatabaseCacheSize), QVariant::fromValue(setup.databaseCacheSize()));
+		QCOMPARE(defaults.property(Defaults::TypedCacheSize), QVariant::fromValue(setup.typedCacheSize()));
+		QCOMPARE(defaults.property(Defaults::CacheWarmupCount), QVariant::fromValue(setup.cacheWarmupCount()));
+		QCOMPARE(defaults.property(Defaults::MinimumCacheSize), QVariant::fromValue(setup.minimumCacheSize()));
+		QCOMPARE(defaults.property(Defaults::SharedCacheSize), QVariant::fromValue(setup.sharedCacheSize()));
 
 		// test other defaults stuff
 		QVERIFY(defaults.remoteNode());
@@ -163,6 +184,17 @@ void TestSetup::testProperties()
 			auto dbRef = defaults.aquireDatabase(this);
 			QVERIFY(dbRef.isValid());
 			QVERIFY(dbRef.database().isOpen());
+			QSqlQuery pragmaQuery(dbRef);
+			QVERIFY(pragmaQuery.exec(QStringLiteral("PRAGMA journal_mode")));
+			QVERIFY(pragmaQuery.first());
+			QCOMPARE(pragmaQuery.value(0).toString().toLower(), QStringLiteral("wal"));
+			QVERIFY(pragmaQuery.exec(QStringLiteral("PRAGMA synchronous")));
+			QVERIFY(pragmaQuery.first());
+			QCOMPARE(pragmaQuery.value(0).toInt(), static_cast<int>(Setup::SynchronousMode::Full));
+			QVERIFY(pragmaQuery.exec(QStringLiteral("PRAGMA cache_size")));
+			QVERIFY(pragmaQuery.first());
+			QCOMPARE(pragmaQuery.value(0).toInt(), -4000);
+			pragmaQuery.finish();
 			dbRef.drop();
 			QVERIFY(!dbRef.isValid());
 		}
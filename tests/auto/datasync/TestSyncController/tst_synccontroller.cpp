@@ -27,6 +27,11 @@ private Q_SLOTS:
 	void testResolver_data();
 	void testResolver();
 
+	void testOrderedApply();
+
+	void testSyncThroughput_data();
+	void testSyncThroughput();
+
 private:
 	LocalStore *store;
 	SyncController *controller;
@@ -448,6 +453,7 @@ void TestSyncController::testSyncOperation()
 		//step 3: trigger the change
 		QVERIFY(doneSpy.isEmpty());
 		controller->syncChange(42ull, message);
+		QTRY_VERIFY(!doneSpy.isEmpty() || !errorSpy.isEmpty());
 		if(!errorSpy.isEmpty())
 			QFAIL(errorSpy.takeFirst()[0].toString().toUtf8().constData());
 		QCOMPARE(doneSpy.size(), 1);
@@ -544,6 +550,7 @@ void TestSyncController::testResolver()
 		//step 3: trigger the change
 		QVERIFY(doneSpy.isEmpty());
 		controller->syncChange(42ull, message);
+		QTRY_VERIFY(!doneSpy.isEmpty() || !errorSpy.isEmpty());
 		if(!errorSpy.isEmpty())
 			QFAIL(errorSpy.takeFirst()[0].toString().toUtf8().constData());
 		QCOMPARE(doneSpy.size(), 1);
@@ -581,6 +588,98 @@ void TestSyncController::testResolver()
 	}
 }
 
+void TestSyncController::testOrderedApply()
+{
+	QSignalSpy doneSpy(controller, &SyncController::syncDone);
+	QSignalSpy errorSpy(controller, &SyncController::controllerError);
+
+	auto key = TestLib::generateKey(20);
+	const auto count = 100;
+
+	try {
+		store->reset(false);
+
+		for(auto i = 1; i <= count; i++)
+			controller->syncChange(static_cast<quint64>(i), SyncHelper::combine(key, static_cast<quint64>(i), TestLib::generateDataJson(20, QString::number(i))));
+		QTRY_COMPARE(doneSpy.size(), count);
+		QVERIFY(errorSpy.isEmpty());
+		for(auto i = 1; i <= count; i++)
+			QCOMPARE(doneSpy.takeFirst()[0].toULongLong(), static_cast<quint64>(i));
+
+		//only the last change must have survived
+		auto scope = store->startSync(key);
+		auto info = store->loadChangeInfo(scope);
+		QCOMPARE(std::get<0>(info), LocalStore::Exists);
+		QCOMPARE(std::get<1>(info), static_cast<quint64>(count));
+		QCOMPARE(store->readJson(key, std::get<2>(info)), TestLib::generateDataJson(20, QString::number(count)));
+		store->commitSync(scope);
+	} catch(QException &e) {
+		QFAIL(e.what());
+	}
+}
+
+void TestSyncController::testSyncThroughput_data()
+{
+	QTest::addColumn<bool>("staged");
+
+	QTest::newRow("engine-thread") << false;
+	QTest::newRow("sync-thread") << true;
+}
+
+void TestSyncController::testSyncThroughput()
+{
+	QFETCH(bool, staged);
+	const auto count = 50000;
+
+	QSignalSpy doneSpy(controller, &SyncController::syncDone);
+	QSignalSpy errorSpy(controller, &SyncController::controllerError);
+
+	try {
+		store->reset(false);
+
+		QList<QByteArray> messages;
+		messages.reserve(count);
+		for(auto i = 0; i < count; i++)
+			messages.append(SyncHelper::combine(TestLib::generateKey(i), 1ull, TestLib::generateDataJson(i)));
+
+		QElapsedTimer timer;
+		qint64 blocked = 0;
+		QBENCHMARK_ONCE {
+			timer.start();
+			if(staged) {
+				//the engine only queues the changes, the sync thread does the rest
+				for(auto i = 0; i < count; i++)
+					controller->syncChange(static_cast<quint64>(i), messages[i]);
+				blocked = timer.elapsed();
+				QTRY_COMPARE_WITH_TIMEOUT(doneSpy.size(), count, 600000);
+			} else {
+				//baseline: what the engine did before, extracting and storing every change on its own thread
+				for(const auto &message : qAsConst(messages)) {
+					bool deleted;
+					ObjectKey key;
+					quint64 version;
+					QJsonObject data;
+					std::tie(deleted, key, version, data) = SyncHelper::extract(message);
+					auto scope = store->startSync(key);
+					auto info = store->loadChangeInfo(scope);
+					store->storeChanged(scope, version, std::get<2>(info), data, false, std::get<0>(info));
+					store->commitSync(scope);
+				}
+				blocked = timer.elapsed();
+			}
+		}
+
+		auto elapsed = std::max<qint64>(timer.elapsed(), 1);
+		QVERIFY(errorSpy.isEmpty());
+		QCOMPARE(store->count(TestLib::TypeName), static_cast<quint64>(count));
+		qInfo() << (staged ? "sync thread:" : "engine thread:") << count << "changes applied in"
+				<< elapsed << "ms, the engine thread was busy for" << blocked << "ms -"
+				<< (static_cast<qint64>(count) * 1000) / elapsed << "changes/s";
+	} catch(QException &e) {
+		QFAIL(e.what());
+	}
+}
+
 QTEST_MAIN(TestSyncController)
 
 #include "tst_synccontroller.moc"
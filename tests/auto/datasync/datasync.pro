@@ -14,7 +14,8 @@ SUBDIRS += \
 	TestKeystorePlugins \
 	TestRemoteConnector \
 	TestMigrationHelper \
-	TestEventCursor
+	TestEventCursor \
+	TestConcurrentCache
 
 include_server_tests {
 	SUBDIRS += \
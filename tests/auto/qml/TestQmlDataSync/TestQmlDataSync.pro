@@ -4,7 +4,7 @@ CONFIG += qmltestcase
 CONFIG += console
 SOURCES += tst_qmldatasync.cpp
 
-QT += datasync
+QT += datasync qml
 
 importFiles.path = .
 DEPLOYMENT += importFiles
@@ -1,9 +1,26 @@
 #include <QtCore>
+#include <QtQml>
 #include <QtQuickTest/quicktest.h>
 #include <QtDataSync/setup.h>
 
 using namespace QtDataSync;
 
+class QmlTestObject : public QObject
+{
+	Q_OBJECT
+
+	Q_PROPERTY(QString key MEMBER key USER true)
+	Q_PROPERTY(QString value MEMBER value)
+
+public:
+	Q_INVOKABLE explicit QmlTestObject(QObject *parent = nullptr) :
+		QObject{parent}
+	{}
+
+	QString key;
+	QString value;
+};
+
 static QTemporaryDir tDir;
 
 static void initImportPath()
@@ -12,6 +29,9 @@ static void initImportPath()
 	QLoggingCategory::setFilterRules(QStringLiteral("qtdatasync.*.debug=true"));
 #endif
 
+	qRegisterMetaType<QmlTestObject*>();
+	qmlRegisterType<QmlTestObject>("de.skycoder42.QtDataSync.Test", 1, 0, "TestObject");
+
 	tDir.setAutoRemove(false);
 	qInfo() << "storage path:" << tDir.path();
 	Setup().setLocalDir(tDir.path())
@@ -26,3 +46,6 @@ static void initImportPath()
 Q_COREAPP_STARTUP_FUNCTION(initImportPath)
 
 QUICK_TEST_MAIN(qmldatasync)
+
+#include "tst_qmldatasync.moc"
+
@@ -1,5 +1,6 @@
 import QtQuick 2.5
 import de.skycoder42.QtDataSync 4.2
+import de.skycoder42.QtDataSync.Test 1.0
 import QtTest 1.1
 
 Item {
@@ -55,4 +56,61 @@ Item {
 		}
 	}
 
+	TestCase {
+		name: "DataStoreAsync"
+
+		DataStore {
+			id: asyncStore
+		}
+
+		TestObject {
+			id: testObject
+			key: "async"
+			value: "baum"
+		}
+
+		SignalSpy {
+			id: doneSpy
+			signalName: "done"
+			target: asyncResult
+		}
+
+		QtObject {
+			id: asyncResult
+			property var value: null
+			signal done()
+		}
+
+		function test_async() {
+			doneSpy.clear();
+			asyncStore.saveAsync("QmlTestObject*", testObject, function() {
+				asyncResult.done();
+			}, function(error) {
+				fail(error);
+			});
+			doneSpy.wait();
+
+			doneSpy.clear();
+			asyncStore.loadAsync("QmlTestObject*", "async", function(data) {
+				asyncResult.value = data;
+				asyncResult.done();
+			}, function(error) {
+				fail(error);
+			});
+			doneSpy.wait();
+			verify(asyncResult.value);
+			compare(asyncResult.value.key, "async");
+			compare(asyncResult.value.value, "baum");
+
+			doneSpy.clear();
+			asyncStore.removeAsync("QmlTestObject*", "async", function(removed) {
+				asyncResult.value = removed;
+				asyncResult.done();
+			});
+			doneSpy.wait();
+			compare(asyncResult.value, true);
+			verify(!asyncStore.contains("QmlTestObject*", "async"));
+		}
+	}
+
 }
@@ -221,6 +221,8 @@ void Client::binaryMessageReceived(const QByteArray &message)
 				onSync(Message::deserializeMessage<SyncMessage>(stream));
 			else if(Message::isType<ChangeMessage>(name))
 				onChange(Message::deserializeMessage<ChangeMessage>(stream));
+			else if(Message::isType<ChangeBatchMessage>(name))
+				onChangeBatch(Message::deserializeMessage<ChangeBatchMessage>(stream));
 			else if(Message::isType<DeviceChangeMessage>(name))
 				onDeviceChange(Message::deserializeMessage<DeviceChangeMessage>(stream));
 			else if(Message::isType<ChangedAckMessage>(name))
@@ -490,6 +492,17 @@ void Client::onChange(const ChangeMessage &message)
 		sendError(ErrorMessage::QuotaHitError);
 }
 
+void Client::onChangeBatch(const ChangeBatchMessage &message)
+{
+	checkIdle(message);
+
+	//all or nothing - a single change over the quota rejects the whole batch
+	if(_database->addChanges(_deviceId, message.changes))
+		sendMessage(ChangeBatchAckMessage{message});
+	else
+		sendError(ErrorMessage::QuotaHitError);
+}
+
 void Client::onDeviceChange(const DeviceChangeMessage &message)
 {
 	checkIdle(message);
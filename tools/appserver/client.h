@@ -26,6 +26,7 @@
 #include "accessmessage_p.h"
 #include "syncmessage_p.h"
 #include "changemessage_p.h"
+#include "changebatchmessage_p.h"
 #include "changedmessage_p.h"
 #include "devicesmessage_p.h"
 #include "removemessage_p.h"
@@ -131,6 +132,7 @@ private:
 	void onAccess(const QtDataSync::AccessMessage &message, QDataStream &stream);
 	void onSync(const QtDataSync::SyncMessage &message);
 	void onChange(const QtDataSync::ChangeMessage &message);
+	void onChangeBatch(const QtDataSync::ChangeBatchMessage &message);
 	void onDeviceChange(const QtDataSync::DeviceChangeMessage &message);
 	void onChangedAck(const QtDataSync::ChangedAckMessage &message);
 	void onListDevices(const QtDataSync::ListDevicesMessage &message);
@@ -310,53 +310,60 @@ void DatabaseController::removeDevice(QUuid deviceId, QUuid deleteId)
 }
 
 bool DatabaseController::addChange(QUuid deviceId, const QByteArray &dataId, const quint32 keyIndex, const QByteArray &salt, const QByteArray &data)
+{
+	return addChanges(deviceId, {make_tuple(dataId, keyIndex, salt, data)});
+}
+
+bool DatabaseController::addChanges(QUuid deviceId, const QList<std::tuple<QByteArray, quint32, QByteArray, QByteArray>> &changes)
 {
 	auto db = _threadStore.localData().database();
 	if(!db.transaction())
 		throw DatabaseException(db);
 
 	try {
-		// delete the entry, in case it already exists. Will do nothing if nothing exists
+		// prepare once, and only rebind the values for every change of the batch
 		Query deleteOldQuery(db);
 		deleteOldQuery.prepare(QStringLiteral("DELETE FROM datachanges WHERE deviceid = ? AND dataid = ?"));
-		deleteOldQuery.addBindValue(deviceId);
-		deleteOldQuery.addBindValue(dataId);
-		deleteOldQuery.exec();
-
-		// add the data change
 		Query addChangeQuery(db);
 		addChangeQuery.prepare(QStringLiteral("INSERT INTO datachanges (deviceid, dataid, keyid, salt, data) "
 											  "VALUES(?, ?, ?, ?, ?)"));
-		addChangeQuery.addBindValue(deviceId);
-		addChangeQuery.addBindValue(dataId);
-		addChangeQuery.addBindValue(keyIndex);
-		addChangeQuery.addBindValue(salt);
-		addChangeQuery.addBindValue(data);
-		addChangeQuery.exec();
-		auto nId = addChangeQuery.lastInsertId();
-		if(!nId.isValid()){
-			db.rollback();
-			throw DatabaseException(QSqlError(QString(), QStringLiteral("Unable to get id of last inserted data change")));
-		}
-
-		// update device changes
 		Query updateDevicesQuery(db);
 		updateDevicesQuery.prepare(QStringLiteral("INSERT INTO devicechanges(dataid, deviceid) "
 												  "SELECT ? AS dataid, devices.id AS deviceid FROM devices "
 												  "INNER JOIN users ON devices.userid = users.id "
 												  "WHERE devices.id != ? "
 												  "AND devices.userid = deviceUserId(?)"));
-		updateDevicesQuery.addBindValue(nId);
-		updateDevicesQuery.addBindValue(deviceId);
-		updateDevicesQuery.addBindValue(deviceId);
-		updateDevicesQuery.exec();
-		auto affected = updateDevicesQuery.numRowsAffected();
+		Query removeChangeQuery(db);
+		removeChangeQuery.prepare(QStringLiteral("DELETE FROM datachanges WHERE id = ?"));
+
+		for(const auto &change : changes) {
+			// delete the entry, in case it already exists. Will do nothing if nothing exists
+			deleteOldQuery.bindValue(0, deviceId);
+			deleteOldQuery.bindValue(1, get<0>(change));
+			deleteOldQuery.exec();
+
+			// add the data change
+			addChangeQuery.bindValue(0, deviceId);
+			addChangeQuery.bindValue(1, get<0>(change));
+			addChangeQuery.bindValue(2, get<1>(change));
+			addChangeQuery.bindValue(3, get<2>(change));
+			addChangeQuery.bindValue(4, get<3>(change));
+			addChangeQuery.exec();
+			auto nId = addChangeQuery.lastInsertId();
+			if(!nId.isValid())
+				throw DatabaseException(QSqlError(QString(), QStringLiteral("Unable to get id of last inserted data change")));
 
-		if(affected == 0) { //no devices to be notified -> remove the data again
-			Query removeChangeQuery(db);
-			removeChangeQuery.prepare(QStringLiteral("DELETE FROM datachanges WHERE id = ?"));
-			removeChangeQuery.addBindValue(nId);
-			removeChangeQuery.exec();
+			// update device changes
+			updateDevicesQuery.bindValue(0, nId);
+			updateDevicesQuery.bindValue(1, deviceId);
+			updateDevicesQuery.bindValue(2, deviceId);
+			updateDevicesQuery.exec();
+			auto affected = updateDevicesQuery.numRowsAffected();
+
+			if(affected == 0) { //no devices to be notified -> remove the data again
+				removeChangeQuery.bindValue(0, nId);
+				removeChangeQuery.exec();
+			}
 		}
 
 		if(!db.commit())
@@ -76,6 +76,8 @@ public:
 				   const quint32 keyIndex,
 				   const QByteArray &salt,
 				   const QByteArray &data);
+	bool addChanges(QUuid deviceId,
+					const QList<std::tuple<QByteArray, quint32, QByteArray, QByteArray>> &changes); // (dataid, keyindex, salt, data), all in one transaction
 	bool addDeviceChange(QUuid deviceId,
 						 QUuid targetId,
 						 const QByteArray &dataId,